@@ -32,6 +32,7 @@
 #include <czmq.h>
 #include <errno.h>
 #include <limits.h>
+#include <regex.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/stat.h>
@@ -41,6 +42,7 @@
 #include "config.h"
 #include "events.h"
 #include "storage.h"
+#include "util.h"
 
 
 struct config *
@@ -54,21 +56,45 @@ config_create(void)
     /* sensor default config */
     config->sensor.verbose = 0;
     config->sensor.perf_sampling_interval_ms = 1000;
+    config->sensor.aligned_ticks = false;
+    config->sensor.overload_queue_depth = 0;
+    config->sensor.overload_read_latency_ms = 0;
+    config->sensor.overload_max_factor = 8;
+    config->sensor.adaptive_threshold = 0;
+    config->sensor.adaptive_max_stride = 8;
     config->sensor.cgroup_discovery_interval_ms = 5000;
     snprintf(config->sensor.cgroup_basepath, PATH_MAX, "%s", "/sys/fs/cgroup");
+    config->sensor.cgroup_depth = 0;
+    config->sensor.cgroup_pattern[0] = '\0';
+    config->sensor.cgroup_include = zlistx_new();
+    zlistx_set_duplicator(config->sensor.cgroup_include, (zlistx_duplicator_fn *) strdup);
+    zlistx_set_destructor(config->sensor.cgroup_include, (zlistx_destructor_fn *) zstr_free);
+    config->sensor.cgroup_exclude = zlistx_new();
+    zlistx_set_duplicator(config->sensor.cgroup_exclude, (zlistx_duplicator_fn *) strdup);
+    zlistx_set_destructor(config->sensor.cgroup_exclude, (zlistx_destructor_fn *) zstr_free);
+    snprintf(config->sensor.host_root, PATH_MAX, "%s", "/");
+    config->sensor.min_lifetime_cycles = 0;
+    config->sensor.min_lifetime_ms = 0;
+    config->sensor.cgroup_grace_period_ms = 0;
+    config->sensor.perf_setup_workers = 4;
+    config->sensor.trace_output[0] = '\0';
+    config->sensor.self_monitoring = false;
+    config->sensor.control_endpoint[0] = '\0';
     gethostname(config->sensor.name, HOST_NAME_MAX);
 
     /* storage default config */
     config->storage.type = STORAGE_UNKNOWN;
     memset(&config->storage, 0, sizeof(struct config_storage));
+    config->storage.fanout.outputs = zlistx_new();
+    zlistx_set_destructor(config->storage.fanout.outputs, (zlistx_destructor_fn *) ptrfree);
 
     /* events default config */
     config->events.system = zhashx_new();
-    zhashx_set_duplicator(config->events.system, (zhashx_duplicator_fn *) events_group_dup);
+    zhashx_set_duplicator(config->events.system, (zhashx_duplicator_fn *) events_group_ref);
     zhashx_set_destructor(config->events.system, (zhashx_destructor_fn *) events_group_destroy);
 
     config->events.containers = zhashx_new();
-    zhashx_set_duplicator(config->events.containers, (zhashx_duplicator_fn *) events_group_dup);
+    zhashx_set_duplicator(config->events.containers, (zhashx_duplicator_fn *) events_group_ref);
     zhashx_set_destructor(config->events.containers, (zhashx_destructor_fn *) events_group_destroy);
 
     return config;
@@ -100,13 +126,45 @@ check_cgroup_basepath(const char *cgroup_basepath)
     return -1;
 }
 
+static int
+check_cgroup_pattern(const char *cgroup_pattern)
+{
+    regex_t re;
+    int errcode = 0;
+    char errbuf[256] = {};
+
+    errcode = regcomp(&re, cgroup_pattern, REG_EXTENDED | REG_NOSUB);
+    if (errcode) {
+        regerror(errcode, &re, errbuf, sizeof(errbuf));
+        zsys_error("config: Invalid cgroup pattern '%s': %s", cgroup_pattern, errbuf);
+        return -1;
+    }
+
+    regfree(&re);
+    return 0;
+}
+
+static int
+check_cgroup_patterns(zlistx_t *cgroup_patterns)
+{
+    const char *cgroup_pattern = NULL;
+
+    for (cgroup_pattern = (const char *) zlistx_first(cgroup_patterns); cgroup_pattern; cgroup_pattern = (const char *) zlistx_next(cgroup_patterns)) {
+        if (check_cgroup_pattern(cgroup_pattern)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 static int
 is_events_group_empty(zhashx_t *events_groups)
 {
     struct events_group *events_group = NULL;
 
     for (events_group = (struct events_group *) zhashx_first(events_groups); events_group; events_group = (struct events_group *) zhashx_next(events_groups)) {
-        if (zlistx_size(events_group->events) == 0) {
+        if (events_group->num_events == 0) {
             zsys_error("config: Events group '%s' is empty", events_group->name);
             return -1;
         }
@@ -115,6 +173,64 @@ is_events_group_empty(zhashx_t *events_groups)
     return 0;
 }
 
+static int
+validate_storage(const struct config_storage *storage)
+{
+    const struct config_storage *output = NULL;
+
+    if (storage->type == STORAGE_CSV && !strlen(storage->csv.outdir)) {
+	    zsys_error("config: CSV storage module requires the 'outdir' parameter to be set");
+	    return -1;
+    }
+
+    if (storage->type == STORAGE_CSV && storage->csv.compress && !storage->csv.rotate_size && !storage->csv.rotate_interval_s) {
+	    zsys_error("config: CSV storage module compression requires the 'rotate-size' or 'rotate-interval' parameter to be set");
+	    return -1;
+    }
+
+    if (storage->type == STORAGE_COLUMNAR && !strlen(storage->columnar.outdir)) {
+	    zsys_error("config: Columnar storage module requires the 'outdir' parameter to be set");
+	    return -1;
+    }
+
+    if (storage->type == STORAGE_TIMESERIES && !strlen(storage->timeseries.outdir)) {
+	    zsys_error("config: Timeseries storage module requires the 'outdir' parameter to be set");
+	    return -1;
+    }
+
+    if (storage->type == STORAGE_PROMETHEUS && !strlen(storage->prometheus.port)) {
+	    zsys_error("config: Prometheus storage module requires the 'port' parameter to be set");
+	    return -1;
+    }
+
+    if (storage->type == STORAGE_SOCKET && (!strlen(storage->socket.hostname) || !strlen(storage->socket.port))) {
+	    zsys_error("config: Socket storage module requires the 'host' and 'port' parameters to be set");
+	    return -1;
+    }
+
+#ifdef HAVE_MONGODB
+    if (storage->type == STORAGE_MONGODB && (!strlen(storage->mongodb.uri) || !strlen(storage->mongodb.database) || !strlen(storage->mongodb.collection))) {
+	    zsys_error("config: MongoDB storage module requires the 'uri', 'database' and 'collection' parameters to be set");
+	    return -1;
+    }
+#endif
+
+    if (storage->type == STORAGE_FANOUT && zlistx_size(storage->fanout.outputs) == 0) {
+	    zsys_error("config: Fanout storage module requires at least one output (only available from a configuration file)");
+	    return -1;
+    }
+
+    if (storage->type == STORAGE_FANOUT) {
+        for (output = (const struct config_storage *) zlistx_first(storage->fanout.outputs); output; output = (const struct config_storage *) zlistx_next(storage->fanout.outputs)) {
+            if (validate_storage(output)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
 int
 config_validate(struct config *config)
 {
@@ -136,16 +252,40 @@ config_validate(struct config *config)
         return -1;
     }
 
+    if (strlen(sensor->cgroup_pattern) && check_cgroup_pattern(sensor->cgroup_pattern)) {
+        return -1;
+    }
+
+    if (check_cgroup_patterns(sensor->cgroup_include) || check_cgroup_patterns(sensor->cgroup_exclude)) {
+        return -1;
+    }
+
     if (sensor->perf_sampling_interval_ms == 0) {
         zsys_error("config: Perf sampling interval must be greater than 0");
         return -1;
     }
 
+    if (sensor->overload_max_factor == 0) {
+        zsys_error("config: Overload maximum factor must be greater than 0");
+        return -1;
+    }
+
+    if (sensor->adaptive_max_stride == 0) {
+        zsys_error("config: Adaptive sampling maximum stride must be greater than 0");
+        return -1;
+    }
+
     if (sensor->cgroup_discovery_interval_ms == 0) {
         zsys_error("config: Cgroup discovery interval must be greater than 0");
         return -1;
     }
 
+    /* the control socket is not authenticated, it must only be reachable through the permissions of its file */
+    if (strlen(sensor->control_endpoint) && strncmp(sensor->control_endpoint, "ipc://", strlen("ipc://"))) {
+        zsys_error("config: Control endpoint must use the ipc:// transport");
+        return -1;
+    }
+
     if (zhashx_size(events->system) == 0 && zhashx_size(events->containers) == 0) {
 	    zsys_error("config: You must provide event(s) to monitor");
 	    return -1;
@@ -155,24 +295,62 @@ config_validate(struct config *config)
         return -1;
     }
 
-    if (storage->type == STORAGE_CSV && !strlen(storage->csv.outdir)) {
-	    zsys_error("config: CSV storage module requires the 'outdir' parameter to be set");
-	    return -1;
+    if (validate_storage(storage)) {
+        return -1;
     }
 
-    if (storage->type == STORAGE_SOCKET && (!strlen(storage->socket.hostname) || !strlen(storage->socket.port))) {
-	    zsys_error("config: Socket storage module requires the 'host' and 'port' parameters to be set");
-	    return -1;
-    }
+    return 0;
+}
+
+bool
+config_storage_equal(const struct config_storage *storage, const struct config_storage *other)
+{
+    const struct config_storage *output = NULL;
+    const struct config_storage *other_output = NULL;
+
+    if (storage->type != other->type)
+        return false;
+
+    switch (storage->type)
+    {
+        case STORAGE_CSV:
+        return !strcmp(storage->csv.outdir, other->csv.outdir) && storage->csv.rotate_size == other->csv.rotate_size &&
+               storage->csv.rotate_interval_s == other->csv.rotate_interval_s && storage->csv.compress == other->csv.compress;
+
+        case STORAGE_SOCKET:
+        return !strcmp(storage->socket.hostname, other->socket.hostname) && !strcmp(storage->socket.port, other->socket.port);
+
+        case STORAGE_COLUMNAR:
+        return !strcmp(storage->columnar.outdir, other->columnar.outdir) && storage->columnar.row_group_size == other->columnar.row_group_size;
+
+        case STORAGE_TIMESERIES:
+        return !strcmp(storage->timeseries.outdir, other->timeseries.outdir) && storage->timeseries.block_size == other->timeseries.block_size;
+
+        case STORAGE_PROMETHEUS:
+        return !strcmp(storage->prometheus.address, other->prometheus.address) && !strcmp(storage->prometheus.port, other->prometheus.port) &&
+               storage->prometheus.per_cpu == other->prometheus.per_cpu;
 
 #ifdef HAVE_MONGODB
-    if (storage->type == STORAGE_MONGODB && (!strlen(storage->mongodb.uri) || !strlen(storage->mongodb.database) || !strlen(storage->mongodb.collection))) {
-	    zsys_error("config: MongoDB storage module requires the 'uri', 'database' and 'collection' parameters to be set");
-	    return -1;
-    }
+        case STORAGE_MONGODB:
+        return !strcmp(storage->mongodb.uri, other->mongodb.uri) && !strcmp(storage->mongodb.database, other->mongodb.database) &&
+               !strcmp(storage->mongodb.collection, other->mongodb.collection);
 #endif
 
-    return 0;
+        case STORAGE_FANOUT:
+        if (storage->fanout.queue_size != other->fanout.queue_size || zlistx_size(storage->fanout.outputs) != zlistx_size(other->fanout.outputs))
+            return false;
+
+        for (output = (const struct config_storage *) zlistx_first(storage->fanout.outputs), other_output = (const struct config_storage *) zlistx_first(other->fanout.outputs);
+             output && other_output;
+             output = (const struct config_storage *) zlistx_next(storage->fanout.outputs), other_output = (const struct config_storage *) zlistx_next(other->fanout.outputs)) {
+            if (!config_storage_equal(output, other_output))
+                return false;
+        }
+        return true;
+
+        default:
+        return true;
+    }
 }
 
 void
@@ -183,6 +361,9 @@ config_destroy(struct config *config)
 
     zhashx_destroy(&config->events.containers);
     zhashx_destroy(&config->events.system);
+    zlistx_destroy(&config->storage.fanout.outputs);
+    zlistx_destroy(&config->sensor.cgroup_include);
+    zlistx_destroy(&config->sensor.cgroup_exclude);
 
     free(config);
 }
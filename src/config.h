@@ -46,8 +46,26 @@ struct config_sensor
 {
     unsigned int verbose;
     unsigned int perf_sampling_interval_ms;
+    bool aligned_ticks; /* sample at the multiples of the interval on the wall clock */
+    unsigned int overload_queue_depth; /* pending reports above which the sensor is overloaded, 0 to ignore */
+    unsigned int overload_read_latency_ms; /* events read latency above which the sensor is overloaded, 0 to ignore */
+    unsigned int overload_max_factor; /* maximum multiple of the sampling intervals applied while overloaded */
+    unsigned int adaptive_threshold; /* group leader events per sampling interval under which a cgroup is idle, 0 to disable */
+    unsigned int adaptive_max_stride; /* maximum multiple of the sampling interval used for an idle cgroup */
     unsigned int cgroup_discovery_interval_ms;
     char cgroup_basepath[PATH_MAX];
+    unsigned int cgroup_depth; /* 0 to monitor the leaf cgroups */
+    char cgroup_pattern[PATH_MAX]; /* empty to disable */
+    zlistx_t *cgroup_include; /* char *pattern */
+    zlistx_t *cgroup_exclude; /* char *pattern */
+    char host_root[PATH_MAX]; /* prefix of the container runtimes state directories */
+    unsigned int min_lifetime_cycles; /* discovery cycles a cgroup must survive before being monitored, 0 to disable */
+    unsigned int min_lifetime_ms; /* time a cgroup must survive before being monitored, 0 to disable */
+    unsigned int cgroup_grace_period_ms; /* time the perf events of a departed cgroup are kept open, 0 to disable */
+    unsigned int perf_setup_workers; /* threads opening the perf events concurrently, 0 or 1 to open them sequentially */
+    char trace_output[PATH_MAX]; /* file capturing the raw samples read, empty to disable */
+    bool self_monitoring; /* report the overhead of the sensor as the hwpc-sensor target */
+    char control_endpoint[PATH_MAX]; /* ipc endpoint of the runtime control socket, empty to disable */
     char name[HOST_NAME_MAX];
 };
 
@@ -57,9 +75,19 @@ struct config_sensor
 struct config_storage
 {
     enum storage_type type;
+
+    /* only used by the fanout storage module */
+    struct {
+        zlistx_t *outputs; /* struct config_storage *output */
+        unsigned int queue_size; /* 0 for the default size */
+    } fanout;
+
     union {
         struct {
             char outdir[PATH_MAX];
+            uint64_t rotate_size; /* in bytes, 0 to disable */
+            unsigned int rotate_interval_s; /* 0 to disable */
+            bool compress;
         } csv;
 
         struct {
@@ -67,6 +95,22 @@ struct config_storage
             char port[NI_MAXSERV];
         } socket;
 
+        struct {
+            char outdir[PATH_MAX];
+            unsigned int row_group_size; /* 0 for the default size */
+        } columnar;
+
+        struct {
+            char outdir[PATH_MAX];
+            unsigned int block_size; /* 0 for the default size */
+        } timeseries;
+
+        struct {
+            char address[HOST_NAME_MAX]; /* empty for the loopback address */
+            char port[NI_MAXSERV];
+            bool per_cpu; /* aggregate the counters per cpu instead of per socket */
+        } prometheus;
+
         #ifdef HAVE_MONGODB
         struct {
             char uri[PATH_MAX];
@@ -106,6 +150,11 @@ struct config *config_create(void);
  */
 int config_validate(struct config *config);
 
+/*
+ * config_storage_equal returns true when both storage configs have the same type and parameters.
+ */
+bool config_storage_equal(const struct config_storage *storage, const struct config_storage *other);
+
 /*
  * config_destroy free the allocated memory for the storage of the global config.
  */
@@ -42,6 +42,26 @@
 
 enum {
     OPT_CGROUP_DISCOVERY_INTERVAL = 256,
+    OPT_CGROUP_DEPTH,
+    OPT_CGROUP_PATTERN,
+    OPT_HOST_ROOT,
+    OPT_CGROUP_INCLUDE,
+    OPT_CGROUP_EXCLUDE,
+    OPT_MIN_LIFETIME_CYCLES,
+    OPT_MIN_LIFETIME,
+    OPT_PERF_SETUP_WORKERS,
+    OPT_CGROUP_GRACE_PERIOD,
+    OPT_ADAPTIVE_THRESHOLD,
+    OPT_ADAPTIVE_MAX_STRIDE,
+    OPT_GROUP_INTERVAL,
+    OPT_ALIGNED_TICKS,
+    OPT_OVERLOAD_QUEUE_DEPTH,
+    OPT_OVERLOAD_READ_LATENCY,
+    OPT_OVERLOAD_MAX_FACTOR,
+    OPT_TRACE_OUTPUT,
+    OPT_SELF_MONITORING,
+    OPT_CONTROL_ENDPOINT,
+    OPT_GROUP_MODE,
 };
 
 const char short_opts[] = "x:vf:p:n:s:c:e:or:U:D:C:P:";
@@ -49,6 +69,26 @@ static struct option long_opts[] = {
     {"config-file", required_argument, 0, 'x'},
     {"perf-sampling-interval", required_argument, 0, 'f'},
     {"cgroup-discovery-interval", required_argument, 0, OPT_CGROUP_DISCOVERY_INTERVAL},
+    {"cgroup-depth", required_argument, 0, OPT_CGROUP_DEPTH},
+    {"cgroup-pattern", required_argument, 0, OPT_CGROUP_PATTERN},
+    {"host-root", required_argument, 0, OPT_HOST_ROOT},
+    {"cgroup-include", required_argument, 0, OPT_CGROUP_INCLUDE},
+    {"cgroup-exclude", required_argument, 0, OPT_CGROUP_EXCLUDE},
+    {"min-lifetime-cycles", required_argument, 0, OPT_MIN_LIFETIME_CYCLES},
+    {"min-lifetime", required_argument, 0, OPT_MIN_LIFETIME},
+    {"perf-setup-workers", required_argument, 0, OPT_PERF_SETUP_WORKERS},
+    {"cgroup-grace-period", required_argument, 0, OPT_CGROUP_GRACE_PERIOD},
+    {"adaptive-threshold", required_argument, 0, OPT_ADAPTIVE_THRESHOLD},
+    {"adaptive-max-stride", required_argument, 0, OPT_ADAPTIVE_MAX_STRIDE},
+    {"group-interval", required_argument, 0, OPT_GROUP_INTERVAL},
+    {"group-mode", required_argument, 0, OPT_GROUP_MODE},
+    {"aligned-ticks", no_argument, 0, OPT_ALIGNED_TICKS},
+    {"overload-queue-depth", required_argument, 0, OPT_OVERLOAD_QUEUE_DEPTH},
+    {"overload-read-latency", required_argument, 0, OPT_OVERLOAD_READ_LATENCY},
+    {"overload-max-factor", required_argument, 0, OPT_OVERLOAD_MAX_FACTOR},
+    {"trace-output", required_argument, 0, OPT_TRACE_OUTPUT},
+    {"self-monitoring", no_argument, 0, OPT_SELF_MONITORING},
+    {"control-endpoint", required_argument, 0, OPT_CONTROL_ENDPOINT},
     {NULL, 0, NULL, 0}
 };
 
@@ -88,6 +128,190 @@ setup_cgroup_basepath(struct config *config, const char *cgroup_basepath)
     return 0;
 }
 
+static int
+setup_cgroup_depth(struct config *config, const char *value_str)
+{
+    unsigned int cgroup_depth;
+
+    if (str_to_uint(value_str, &cgroup_depth)) {
+        zsys_error("config: cli: Cgroup depth value is invalid");
+        return -1;
+    }
+
+    config->sensor.cgroup_depth = cgroup_depth;
+    return 0;
+}
+
+static int
+setup_min_lifetime_cycles(struct config *config, const char *value_str)
+{
+    unsigned int min_lifetime_cycles;
+
+    if (str_to_uint(value_str, &min_lifetime_cycles)) {
+        zsys_error("config: cli: Minimum lifetime cycles value is invalid");
+        return -1;
+    }
+
+    config->sensor.min_lifetime_cycles = min_lifetime_cycles;
+    return 0;
+}
+
+static int
+setup_min_lifetime(struct config *config, const char *value_str)
+{
+    unsigned int min_lifetime_ms;
+
+    if (str_to_uint(value_str, &min_lifetime_ms)) {
+        zsys_error("config: cli: Minimum lifetime value is invalid");
+        return -1;
+    }
+
+    config->sensor.min_lifetime_ms = min_lifetime_ms;
+    return 0;
+}
+
+static int
+setup_perf_setup_workers(struct config *config, const char *value_str)
+{
+    unsigned int perf_setup_workers;
+
+    if (str_to_uint(value_str, &perf_setup_workers)) {
+        zsys_error("config: cli: Perf setup workers value is invalid");
+        return -1;
+    }
+
+    config->sensor.perf_setup_workers = perf_setup_workers;
+    return 0;
+}
+
+static int
+setup_cgroup_grace_period(struct config *config, const char *value_str)
+{
+    unsigned int cgroup_grace_period_ms;
+
+    if (str_to_uint(value_str, &cgroup_grace_period_ms)) {
+        zsys_error("config: cli: Cgroup grace period value is invalid");
+        return -1;
+    }
+
+    config->sensor.cgroup_grace_period_ms = cgroup_grace_period_ms;
+    return 0;
+}
+
+static int
+setup_adaptive_threshold(struct config *config, const char *value_str)
+{
+    unsigned int adaptive_threshold;
+
+    if (str_to_uint(value_str, &adaptive_threshold)) {
+        zsys_error("config: cli: Adaptive sampling threshold value is invalid");
+        return -1;
+    }
+
+    config->sensor.adaptive_threshold = adaptive_threshold;
+    return 0;
+}
+
+static int
+setup_adaptive_max_stride(struct config *config, const char *value_str)
+{
+    unsigned int adaptive_max_stride;
+
+    if (str_to_uint(value_str, &adaptive_max_stride)) {
+        zsys_error("config: cli: Adaptive sampling maximum stride value is invalid");
+        return -1;
+    }
+
+    config->sensor.adaptive_max_stride = adaptive_max_stride;
+    return 0;
+}
+
+static int
+setup_overload_queue_depth(struct config *config, const char *value_str)
+{
+    unsigned int overload_queue_depth;
+
+    if (str_to_uint(value_str, &overload_queue_depth)) {
+        zsys_error("config: cli: Overload queue depth value is invalid");
+        return -1;
+    }
+
+    config->sensor.overload_queue_depth = overload_queue_depth;
+    return 0;
+}
+
+static int
+setup_overload_read_latency(struct config *config, const char *value_str)
+{
+    unsigned int overload_read_latency_ms;
+
+    if (str_to_uint(value_str, &overload_read_latency_ms)) {
+        zsys_error("config: cli: Overload read latency value is invalid");
+        return -1;
+    }
+
+    config->sensor.overload_read_latency_ms = overload_read_latency_ms;
+    return 0;
+}
+
+static int
+setup_overload_max_factor(struct config *config, const char *value_str)
+{
+    unsigned int overload_max_factor;
+
+    if (str_to_uint(value_str, &overload_max_factor)) {
+        zsys_error("config: cli: Overload maximum factor value is invalid");
+        return -1;
+    }
+
+    config->sensor.overload_max_factor = overload_max_factor;
+    return 0;
+}
+
+static int
+setup_cgroup_pattern(struct config *config, const char *cgroup_pattern)
+{
+    if (snprintf(config->sensor.cgroup_pattern, PATH_MAX, "%s", cgroup_pattern) >= PATH_MAX) {
+        zsys_error("config: cli: Cgroup pattern is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_host_root(struct config *config, const char *host_root)
+{
+    if (snprintf(config->sensor.host_root, PATH_MAX, "%s", host_root) >= PATH_MAX) {
+        zsys_error("config: cli: Host root path is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_control_endpoint(struct config *config, const char *control_endpoint)
+{
+    if (snprintf(config->sensor.control_endpoint, PATH_MAX, "%s", control_endpoint) >= PATH_MAX) {
+        zsys_error("config: cli: Control endpoint is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_trace_output(struct config *config, const char *trace_output)
+{
+    if (snprintf(config->sensor.trace_output, PATH_MAX, "%s", trace_output) >= PATH_MAX) {
+        zsys_error("config: cli: Trace output path is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
 static int
 setup_sensor_name(struct config *config, const char *sensor_name)
 {
@@ -139,7 +363,7 @@ setup_global_events_group(struct config *config, const char *group_name)
     }
 
     zhashx_insert(config->events.system, group_name, events_group);
-    events_group_destroy(&events_group); /* The events group are duplicated on insert */
+    events_group_destroy(&events_group); /* The events group are referenced on insert */
     return 0;
 }
 
@@ -155,7 +379,7 @@ setup_cgroups_events_group(struct config *config, const char *group_name)
     }
 
     zhashx_insert(config->events.containers, group_name, events_group);
-    events_group_destroy(&events_group); /* The events group are duplicated on insert */
+    events_group_destroy(&events_group); /* The events group are referenced on insert */
     return 0;
 }
 
@@ -171,6 +395,41 @@ setup_cgroups_events_group_type(struct events_group *events_group, enum events_g
     return 0;
 }
 
+static int
+setup_events_group_mode(struct events_group *events_group, const char *mode)
+{
+    if (!events_group) {
+        zsys_error("config: cli: No events group defined before setting monitoring mode");
+        return -1;
+    }
+
+    if (events_group_set_monitoring_type(events_group, mode)) {
+        zsys_error("config: cli: Invalid monitoring mode '%s' for events group '%s'", mode, events_group->name);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_events_group_interval(struct events_group *events_group, const char *value_str)
+{
+    unsigned int interval_ms;
+
+    if (!events_group) {
+        zsys_error("config: cli: No events group defined before setting sampling interval");
+        return -1;
+    }
+
+    if (str_to_uint(value_str, &interval_ms) || interval_ms == 0) {
+        zsys_error("config: cli: Sampling interval of events group '%s' is invalid", events_group->name);
+        return -1;
+    }
+
+    events_group->interval_ms = interval_ms;
+    return 0;
+}
+
 static int
 append_event_to_events_group(struct events_group *events_group, const char *event_name)
 {
@@ -246,6 +505,70 @@ setup_storage_socket_parameters(struct config *config, int opt, const char *valu
     return 0;
 }
 
+static int
+setup_storage_columnar_parameters(struct config *config, int opt, const char *value)
+{
+    switch (opt)
+    {
+        case 'U': /* Output directory path */
+        if (snprintf(config->storage.columnar.outdir, PATH_MAX, "%s", value) >= PATH_MAX) {
+            zsys_error("config: cli: Columnar output directory path is too long");
+            return -1;
+        }
+        break;
+
+        default:
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_storage_timeseries_parameters(struct config *config, int opt, const char *value)
+{
+    switch (opt)
+    {
+        case 'U': /* Output directory path */
+        if (snprintf(config->storage.timeseries.outdir, PATH_MAX, "%s", value) >= PATH_MAX) {
+            zsys_error("config: cli: Timeseries output directory path is too long");
+            return -1;
+        }
+        break;
+
+        default:
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_storage_prometheus_parameters(struct config *config, int opt, const char *value)
+{
+    switch (opt)
+    {
+        case 'U': /* Listen IP/hostname */
+        if (snprintf(config->storage.prometheus.address, HOST_NAME_MAX, "%s", value) >= HOST_NAME_MAX) {
+            zsys_error("config: cli: Prometheus listen address is too long");
+            return -1;
+        }
+        break;
+
+        case 'P': /* Listen port number */
+        if (snprintf(config->storage.prometheus.port, NI_MAXSERV, "%s", value) >= NI_MAXSERV) {
+            zsys_error("config: cli: Prometheus listen port is too long");
+            return -1;
+        }
+        break;
+
+        default:
+        return -1;
+    }
+
+    return 0;
+}
+
 #ifdef HAVE_MONGODB
 static int
 setup_storage_mongodb_parameters(struct config *config, int opt, const char *value)
@@ -295,6 +618,15 @@ setup_storage_parameters(struct config *config, int opt, const char *value)
         case STORAGE_SOCKET:
         return setup_storage_socket_parameters(config, opt, value);
 
+        case STORAGE_COLUMNAR:
+        return setup_storage_columnar_parameters(config, opt, value);
+
+        case STORAGE_TIMESERIES:
+        return setup_storage_timeseries_parameters(config, opt, value);
+
+        case STORAGE_PROMETHEUS:
+        return setup_storage_prometheus_parameters(config, opt, value);
+
 #ifdef HAVE_MONGODB
         case STORAGE_MONGODB:
         return setup_storage_mongodb_parameters(config, opt, value);
@@ -313,6 +645,7 @@ config_setup_from_cli(int argc, char **argv, struct config *config)
     struct events_group *current_events_group = NULL;
 
     opterr = 0; /* Disable getopt error messages  */
+    optind = 0; /* Restart the scanning of the arguments when the configuration is reloaded */
 
     while ((opt = getopt_long(argc, argv, short_opts, long_opts, &option_index)) != -1) {
         switch (opt)
@@ -333,6 +666,106 @@ config_setup_from_cli(int argc, char **argv, struct config *config)
             }
             break;
 
+            case OPT_CGROUP_DEPTH:
+            if (setup_cgroup_depth(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_CGROUP_PATTERN:
+            if (setup_cgroup_pattern(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_CGROUP_INCLUDE:
+            zlistx_add_end(config->sensor.cgroup_include, optarg);
+            break;
+
+            case OPT_CGROUP_EXCLUDE:
+            zlistx_add_end(config->sensor.cgroup_exclude, optarg);
+            break;
+
+            case OPT_MIN_LIFETIME_CYCLES:
+            if (setup_min_lifetime_cycles(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_MIN_LIFETIME:
+            if (setup_min_lifetime(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_PERF_SETUP_WORKERS:
+            if (setup_perf_setup_workers(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_CGROUP_GRACE_PERIOD:
+            if (setup_cgroup_grace_period(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_ADAPTIVE_THRESHOLD:
+            if (setup_adaptive_threshold(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_ADAPTIVE_MAX_STRIDE:
+            if (setup_adaptive_max_stride(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_ALIGNED_TICKS:
+            config->sensor.aligned_ticks = true;
+            break;
+
+            case OPT_OVERLOAD_QUEUE_DEPTH:
+            if (setup_overload_queue_depth(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_OVERLOAD_READ_LATENCY:
+            if (setup_overload_read_latency(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_OVERLOAD_MAX_FACTOR:
+            if (setup_overload_max_factor(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_TRACE_OUTPUT:
+            if (setup_trace_output(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_SELF_MONITORING:
+            config->sensor.self_monitoring = true;
+            break;
+
+            case OPT_CONTROL_ENDPOINT:
+            if (setup_control_endpoint(config, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_HOST_ROOT:
+            if (setup_host_root(config, optarg)) {
+                return -1;
+            }
+            break;
+
             case 'n':
             if (setup_sensor_name(config, optarg)) {
                 return -1;
@@ -371,6 +804,18 @@ config_setup_from_cli(int argc, char **argv, struct config *config)
             }
             break;
 
+            case OPT_GROUP_MODE:
+            if (setup_events_group_mode(current_events_group, optarg)) {
+                return -1;
+            }
+            break;
+
+            case OPT_GROUP_INTERVAL:
+            if (setup_events_group_interval(current_events_group, optarg)) {
+                return -1;
+            }
+            break;
+
             case 'e':
             if (append_event_to_events_group(current_events_group, optarg)) {
                 return -1;
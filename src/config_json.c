@@ -87,6 +87,250 @@ setup_sensor_name(struct config *config, json_object *sensor_name_obj)
     return 0;
 }
 
+static int
+setup_min_lifetime_cycles(struct config *config, json_object *min_lifetime_cycles_obj)
+{
+    int min_lifetime_cycles = -1;
+
+    errno = 0;
+    min_lifetime_cycles = json_object_get_int(min_lifetime_cycles_obj);
+    if (errno != 0 || min_lifetime_cycles < 0) {
+        zsys_error("config: json: Minimum lifetime cycles value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.min_lifetime_cycles = (unsigned int) min_lifetime_cycles;
+    return 0;
+}
+
+static int
+setup_min_lifetime(struct config *config, json_object *min_lifetime_obj)
+{
+    int min_lifetime_ms = -1;
+
+    errno = 0;
+    min_lifetime_ms = json_object_get_int(min_lifetime_obj);
+    if (errno != 0 || min_lifetime_ms < 0) {
+        zsys_error("config: json: Minimum lifetime value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.min_lifetime_ms = (unsigned int) min_lifetime_ms;
+    return 0;
+}
+
+static int
+setup_perf_setup_workers(struct config *config, json_object *perf_setup_workers_obj)
+{
+    int perf_setup_workers = -1;
+
+    errno = 0;
+    perf_setup_workers = json_object_get_int(perf_setup_workers_obj);
+    if (errno != 0 || perf_setup_workers < 0) {
+        zsys_error("config: json: Perf setup workers value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.perf_setup_workers = (unsigned int) perf_setup_workers;
+    return 0;
+}
+
+static int
+setup_cgroup_grace_period(struct config *config, json_object *cgroup_grace_period_obj)
+{
+    int cgroup_grace_period_ms = -1;
+
+    errno = 0;
+    cgroup_grace_period_ms = json_object_get_int(cgroup_grace_period_obj);
+    if (errno != 0 || cgroup_grace_period_ms < 0) {
+        zsys_error("config: json: Cgroup grace period value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.cgroup_grace_period_ms = (unsigned int) cgroup_grace_period_ms;
+    return 0;
+}
+
+static int
+setup_adaptive_threshold(struct config *config, json_object *adaptive_threshold_obj)
+{
+    int adaptive_threshold = -1;
+
+    errno = 0;
+    adaptive_threshold = json_object_get_int(adaptive_threshold_obj);
+    if (errno != 0 || adaptive_threshold < 0) {
+        zsys_error("config: json: Adaptive sampling threshold value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.adaptive_threshold = (unsigned int) adaptive_threshold;
+    return 0;
+}
+
+static int
+setup_adaptive_max_stride(struct config *config, json_object *adaptive_max_stride_obj)
+{
+    int adaptive_max_stride = -1;
+
+    errno = 0;
+    adaptive_max_stride = json_object_get_int(adaptive_max_stride_obj);
+    if (errno != 0 || adaptive_max_stride <= 0) {
+        zsys_error("config: json: Adaptive sampling maximum stride value is invalid (strictly positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.adaptive_max_stride = (unsigned int) adaptive_max_stride;
+    return 0;
+}
+
+static int
+setup_overload_queue_depth(struct config *config, json_object *overload_queue_depth_obj)
+{
+    int overload_queue_depth = -1;
+
+    errno = 0;
+    overload_queue_depth = json_object_get_int(overload_queue_depth_obj);
+    if (errno != 0 || overload_queue_depth < 0) {
+        zsys_error("config: json: Overload queue depth value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.overload_queue_depth = (unsigned int) overload_queue_depth;
+    return 0;
+}
+
+static int
+setup_overload_read_latency(struct config *config, json_object *overload_read_latency_obj)
+{
+    int overload_read_latency_ms = -1;
+
+    errno = 0;
+    overload_read_latency_ms = json_object_get_int(overload_read_latency_obj);
+    if (errno != 0 || overload_read_latency_ms < 0) {
+        zsys_error("config: json: Overload read latency value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.overload_read_latency_ms = (unsigned int) overload_read_latency_ms;
+    return 0;
+}
+
+static int
+setup_overload_max_factor(struct config *config, json_object *overload_max_factor_obj)
+{
+    int overload_max_factor = -1;
+
+    errno = 0;
+    overload_max_factor = json_object_get_int(overload_max_factor_obj);
+    if (errno != 0 || overload_max_factor < 0) {
+        zsys_error("config: json: Overload maximum factor value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.overload_max_factor = (unsigned int) overload_max_factor;
+    return 0;
+}
+
+static int
+setup_cgroup_depth(struct config *config, json_object *cgroup_depth_obj)
+{
+    int cgroup_depth = -1;
+
+    errno = 0;
+    cgroup_depth = json_object_get_int(cgroup_depth_obj);
+    if (errno != 0 || cgroup_depth < 0) {
+        zsys_error("config: json: Cgroup depth value is invalid (positive integer expected)");
+        return -1;
+    }
+
+    config->sensor.cgroup_depth = (unsigned int) cgroup_depth;
+    return 0;
+}
+
+static int
+setup_cgroup_pattern(struct config *config, json_object *cgroup_pattern_obj)
+{
+    const char *cgroup_pattern = NULL;
+
+    cgroup_pattern = json_object_get_string(cgroup_pattern_obj);
+    if (snprintf(config->sensor.cgroup_pattern, PATH_MAX, "%s", cgroup_pattern) >= PATH_MAX) {
+        zsys_error("config: json: Cgroup pattern is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_cgroup_filter(zlistx_t *cgroup_patterns, json_object *cgroup_patterns_obj)
+{
+    const char *cgroup_pattern = NULL;
+
+    /* a single pattern can be given as a string */
+    if (json_object_is_type(cgroup_patterns_obj, json_type_string)) {
+        zlistx_add_end(cgroup_patterns, (void *) json_object_get_string(cgroup_patterns_obj));
+        return 0;
+    }
+
+    if (!json_object_is_type(cgroup_patterns_obj, json_type_array)) {
+        zsys_error("config: json: Invalid cgroup filter type (string or array of strings expected)");
+        return -1;
+    }
+
+    for (size_t i = 0; i < json_object_array_length(cgroup_patterns_obj); i++) {
+        cgroup_pattern = json_object_get_string(json_object_array_get_idx(cgroup_patterns_obj, i));
+        if (!cgroup_pattern || !strlen(cgroup_pattern)) {
+            zsys_error("config: json: Empty cgroup filter pattern");
+            return -1;
+        }
+        zlistx_add_end(cgroup_patterns, (void *) cgroup_pattern);
+    }
+
+    return 0;
+}
+
+static int
+setup_host_root(struct config *config, json_object *host_root_obj)
+{
+    const char *host_root = NULL;
+
+    host_root = json_object_get_string(host_root_obj);
+    if (snprintf(config->sensor.host_root, PATH_MAX, "%s", host_root) >= PATH_MAX) {
+        zsys_error("config: json: Host root path is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_control_endpoint(struct config *config, json_object *control_endpoint_obj)
+{
+    const char *control_endpoint = NULL;
+
+    control_endpoint = json_object_get_string(control_endpoint_obj);
+    if (snprintf(config->sensor.control_endpoint, PATH_MAX, "%s", control_endpoint) >= PATH_MAX) {
+        zsys_error("config: json: Control endpoint is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_trace_output(struct config *config, json_object *trace_output_obj)
+{
+    const char *trace_output = NULL;
+
+    trace_output = json_object_get_string(trace_output_obj);
+    if (snprintf(config->sensor.trace_output, PATH_MAX, "%s", trace_output) >= PATH_MAX) {
+        zsys_error("config: json: Trace output path is too long");
+        return -1;
+    }
+
+    return 0;
+}
+
 static int
 setup_perf_sampling_interval(struct config *config, json_object *frequency_obj)
 {
@@ -120,13 +364,13 @@ setup_cgroup_discovery_interval(struct config *config, json_object *frequency_ob
 }
 
 static int
-setup_storage_type(struct config *config, json_object *storage)
+setup_storage_type(struct config_storage *storage, json_object *storage_obj)
 {
     json_object *storage_type_obj = NULL;
     const char *storage_module_name = NULL;
     enum storage_type type;
 
-    if (!json_object_object_get_ex(storage, "type", &storage_type_obj)) {
+    if (!json_object_object_get_ex(storage_obj, "type", &storage_type_obj)) {
         zsys_error("config: json: The storage module 'type' field is required");
         return -1;
     }
@@ -138,12 +382,12 @@ setup_storage_type(struct config *config, json_object *storage)
         return -1;
     }
 
-    config->storage.type = type;
+    storage->type = type;
     return 0;
 }
 
 static int
-setup_storage_null_parameters(struct config *config __attribute__((unused)), json_object *storage_obj)
+setup_storage_null_parameters(struct config_storage *storage __attribute__((unused)), json_object *storage_obj)
 {
     json_object_object_foreach(storage_obj, key, value) {
         (void) value;
@@ -161,9 +405,32 @@ setup_storage_null_parameters(struct config *config __attribute__((unused)), jso
 }
 
 static int
-setup_storage_csv_parameters(struct config *config, json_object *storage_obj)
+setup_storage_csv_compression(struct config_storage *storage, json_object *compression_obj)
+{
+    const char *compression = NULL;
+
+    compression = json_object_get_string(compression_obj);
+    if (!strcasecmp(compression, "none")) {
+        storage->csv.compress = false;
+        return 0;
+    }
+#ifdef HAVE_ZLIB
+    if (!strcasecmp(compression, "gzip")) {
+        storage->csv.compress = true;
+        return 0;
+    }
+#endif
+
+    zsys_error("config: json: CSV compression '%s' is invalid or disabled at compile time", compression);
+    return -1;
+}
+
+static int
+setup_storage_csv_parameters(struct config_storage *storage, json_object *storage_obj)
 {
     const char *output_dir = NULL;
+    int64_t rotate_size = -1;
+    int rotate_interval = -1;
 
     json_object_object_foreach(storage_obj, key, value) {
         if (!strcasecmp(key, "type")) {
@@ -171,11 +438,34 @@ setup_storage_csv_parameters(struct config *config, json_object *storage_obj)
         }
         if (!strcasecmp(key, "directory") || !strcasecmp(key, "outdir")) {
             output_dir = json_object_get_string(value);
-            if (snprintf(config->storage.csv.outdir, PATH_MAX, "%s", output_dir) >= PATH_MAX) {
+            if (snprintf(storage->csv.outdir, PATH_MAX, "%s", output_dir) >= PATH_MAX) {
                 zsys_error("config: json: CSV output directory path is too long");
                 return -1;
             }
         }
+        else if (!strcasecmp(key, "rotate-size")) {
+            errno = 0;
+            rotate_size = json_object_get_int64(value);
+            if (errno != 0 || rotate_size < 0) {
+                zsys_error("config: json: CSV rotate size value is invalid (positive integer expected)");
+                return -1;
+            }
+            storage->csv.rotate_size = (uint64_t) rotate_size;
+        }
+        else if (!strcasecmp(key, "rotate-interval")) {
+            errno = 0;
+            rotate_interval = json_object_get_int(value);
+            if (errno != 0 || rotate_interval < 0) {
+                zsys_error("config: json: CSV rotate interval value is invalid (positive integer expected)");
+                return -1;
+            }
+            storage->csv.rotate_interval_s = (unsigned int) rotate_interval;
+        }
+        else if (!strcasecmp(key, "compression")) {
+            if (setup_storage_csv_compression(storage, value)) {
+                return -1;
+            }
+        }
         else {
             zsys_error("config: json: Invalid parameter '%s' for CSV storage module", key);
             return -1;
@@ -186,7 +476,7 @@ setup_storage_csv_parameters(struct config *config, json_object *storage_obj)
 }
 
 static int
-setup_storage_socket_parameters(struct config *config, json_object *storage_obj)
+setup_storage_socket_parameters(struct config_storage *storage, json_object *storage_obj)
 {
     const char *host = NULL;
     const char *port = NULL;
@@ -197,14 +487,14 @@ setup_storage_socket_parameters(struct config *config, json_object *storage_obj)
         }
         else if (!strcasecmp(key, "uri") || !strcasecmp(key, "host")) {
             host = json_object_get_string(value);
-            if (snprintf(config->storage.socket.hostname, HOST_NAME_MAX, "%s", host) >= HOST_NAME_MAX) {
+            if (snprintf(storage->socket.hostname, HOST_NAME_MAX, "%s", host) >= HOST_NAME_MAX) {
                 zsys_error("config: json: Socket output host is too long");
                 return -1;
             }
         }
         else if (!strcasecmp(key, "port")) {
             port = json_object_get_string(value);
-            if (snprintf(config->storage.socket.port, NI_MAXSERV, "%s", port) >= NI_MAXSERV) {
+            if (snprintf(storage->socket.port, NI_MAXSERV, "%s", port) >= NI_MAXSERV) {
                 zsys_error("config: json: Socket output port is too long");
                 return -1;
             }
@@ -218,9 +508,136 @@ setup_storage_socket_parameters(struct config *config, json_object *storage_obj)
     return 0;
 }
 
+static int
+setup_storage_columnar_parameters(struct config_storage *storage, json_object *storage_obj)
+{
+    const char *output_dir = NULL;
+    int row_group_size = -1;
+
+    json_object_object_foreach(storage_obj, key, value) {
+        if (!strcasecmp(key, "type")) {
+            continue; /* This field have already been processed */
+        }
+        else if (!strcasecmp(key, "directory") || !strcasecmp(key, "outdir")) {
+            output_dir = json_object_get_string(value);
+            if (snprintf(storage->columnar.outdir, PATH_MAX, "%s", output_dir) >= PATH_MAX) {
+                zsys_error("config: json: Columnar output directory path is too long");
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "row-group-size")) {
+            errno = 0;
+            row_group_size = json_object_get_int(value);
+            if (errno != 0 || row_group_size <= 0) {
+                zsys_error("config: json: Columnar row group size value is invalid (positive integer expected)");
+                return -1;
+            }
+            storage->columnar.row_group_size = (unsigned int) row_group_size;
+        }
+        else {
+            zsys_error("config: json: Invalid parameter '%s' for Columnar storage module", key);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+setup_storage_timeseries_parameters(struct config_storage *storage, json_object *storage_obj)
+{
+    const char *output_dir = NULL;
+    int block_size = -1;
+
+    json_object_object_foreach(storage_obj, key, value) {
+        if (!strcasecmp(key, "type")) {
+            continue; /* This field have already been processed */
+        }
+        else if (!strcasecmp(key, "directory") || !strcasecmp(key, "outdir")) {
+            output_dir = json_object_get_string(value);
+            if (snprintf(storage->timeseries.outdir, PATH_MAX, "%s", output_dir) >= PATH_MAX) {
+                zsys_error("config: json: Timeseries output directory path is too long");
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "block-size")) {
+            errno = 0;
+            block_size = json_object_get_int(value);
+            if (errno != 0 || block_size <= 0) {
+                zsys_error("config: json: Timeseries block size value is invalid (positive integer expected)");
+                return -1;
+            }
+            storage->timeseries.block_size = (unsigned int) block_size;
+        }
+        else {
+            zsys_error("config: json: Invalid parameter '%s' for Timeseries storage module", key);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+setup_storage_prometheus_aggregation(struct config_storage *storage, json_object *aggregation_obj)
+{
+    const char *aggregation = NULL;
+
+    aggregation = json_object_get_string(aggregation_obj);
+    if (!strcasecmp(aggregation, "socket")) {
+        storage->prometheus.per_cpu = false;
+        return 0;
+    }
+    if (!strcasecmp(aggregation, "cpu")) {
+        storage->prometheus.per_cpu = true;
+        return 0;
+    }
+
+    zsys_error("config: json: Prometheus aggregation '%s' is invalid (expected 'socket' or 'cpu')", aggregation);
+    return -1;
+}
+
+static int
+setup_storage_prometheus_parameters(struct config_storage *storage, json_object *storage_obj)
+{
+    const char *address = NULL;
+    const char *port = NULL;
+
+    json_object_object_foreach(storage_obj, key, value) {
+        if (!strcasecmp(key, "type")) {
+            continue; /* This field have already been processed */
+        }
+        else if (!strcasecmp(key, "address") || !strcasecmp(key, "host")) {
+            address = json_object_get_string(value);
+            if (snprintf(storage->prometheus.address, HOST_NAME_MAX, "%s", address) >= HOST_NAME_MAX) {
+                zsys_error("config: json: Prometheus listen address is too long");
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "port")) {
+            port = json_object_get_string(value);
+            if (snprintf(storage->prometheus.port, NI_MAXSERV, "%s", port) >= NI_MAXSERV) {
+                zsys_error("config: json: Prometheus listen port is too long");
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "aggregation")) {
+            if (setup_storage_prometheus_aggregation(storage, value)) {
+                return -1;
+            }
+        }
+        else {
+            zsys_error("config: json: Invalid parameter '%s' for Prometheus storage module", key);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 #ifdef HAVE_MONGODB
 static int
-setup_storage_mongodb_parameters(struct config *config, json_object *storage_obj)
+setup_storage_mongodb_parameters(struct config_storage *storage, json_object *storage_obj)
 {
     const char *uri = NULL;
     const char *database = NULL;
@@ -232,21 +649,21 @@ setup_storage_mongodb_parameters(struct config *config, json_object *storage_obj
         }
         else if (!strcasecmp(key, "uri")) {
             uri = json_object_get_string(value);
-            if (snprintf(config->storage.mongodb.uri, PATH_MAX, "%s", uri) >= PATH_MAX) {
+            if (snprintf(storage->mongodb.uri, PATH_MAX, "%s", uri) >= PATH_MAX) {
                 zsys_error("config: json: MongoDB URI is too long");
                 return -1;
             }
         }
         else if (!strcasecmp(key, "database")) {
             database = json_object_get_string(value);
-            if (snprintf(config->storage.mongodb.database, NAME_MAX, "%s", database) >= NAME_MAX) {
+            if (snprintf(storage->mongodb.database, NAME_MAX, "%s", database) >= NAME_MAX) {
                 zsys_error("config: json: MongoDB database name is too long");
                 return -1;
             }
         }
         else if (!strcasecmp(key, "collection")) {
             collection = json_object_get_string(value);
-            if (snprintf(config->storage.mongodb.collection, NAME_MAX, "%s", collection) >= NAME_MAX) {
+            if (snprintf(storage->mongodb.collection, NAME_MAX, "%s", collection) >= NAME_MAX) {
                 zsys_error("config: json: MongoDB collection name is too long");
                 return -1;
             }
@@ -261,31 +678,131 @@ setup_storage_mongodb_parameters(struct config *config, json_object *storage_obj
 }
 #endif
 
+static int handle_storage_parameters(struct config_storage *storage, json_object *storage_obj);
+
+static bool
+is_fanout_storage_object(json_object *storage_obj)
+{
+    json_object *storage_type_obj = NULL;
+
+    if (json_object_is_type(storage_obj, json_type_array)) {
+        return true;
+    }
+
+    if (json_object_object_get_ex(storage_obj, "type", &storage_type_obj)) {
+        return storage_module_get_type(json_object_get_string(storage_type_obj)) == STORAGE_FANOUT;
+    }
+
+    return false;
+}
+
 static int
-handle_storage_parameters(struct config *config, json_object *storage_obj)
+setup_storage_fanout_outputs(struct config_storage *storage, json_object *outputs_obj)
 {
+    json_object *output_obj = NULL;
+    struct config_storage *output = NULL;
+
+    if (!json_object_is_type(outputs_obj, json_type_array)) {
+        zsys_error("config: json: Invalid 'outputs' field type for Fanout storage module");
+        return -1;
+    }
+
+    for (size_t i = 0; i < json_object_array_length(outputs_obj); i++) {
+        output_obj = json_object_array_get_idx(outputs_obj, i);
+        if (is_fanout_storage_object(output_obj)) {
+            zsys_error("config: json: Fanout storage module cannot be nested");
+            return -1;
+        }
+
+        output = (struct config_storage *) calloc(1, sizeof(struct config_storage));
+        if (!output) {
+            return -1;
+        }
+        zlistx_add_end(storage->fanout.outputs, output);
+
+        if (handle_storage_parameters(output, output_obj)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+setup_storage_fanout_parameters(struct config_storage *storage, json_object *storage_obj)
+{
+    int queue_size = -1;
+
+    json_object_object_foreach(storage_obj, key, value) {
+        if (!strcasecmp(key, "type")) {
+            continue; /* This field have already been processed */
+        }
+        else if (!strcasecmp(key, "outputs")) {
+            if (setup_storage_fanout_outputs(storage, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "queue-size")) {
+            errno = 0;
+            queue_size = json_object_get_int(value);
+            if (errno != 0 || queue_size <= 0) {
+                zsys_error("config: json: Fanout queue size value is invalid (positive integer expected)");
+                return -1;
+            }
+            storage->fanout.queue_size = (unsigned int) queue_size;
+        }
+        else {
+            zsys_error("config: json: Invalid parameter '%s' for Fanout storage module", key);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+handle_storage_parameters(struct config_storage *storage, json_object *storage_obj)
+{
+    /* An array of storage modules is a shorthand for the fanout storage module */
+    if (json_object_is_type(storage_obj, json_type_array)) {
+        storage->type = STORAGE_FANOUT;
+        return setup_storage_fanout_outputs(storage, storage_obj);
+    }
+
     /*
      * Each storage module is configured with its own set of fields.
      * It is therefore required to know the storage type before processing any field.
      */
-    if (setup_storage_type(config, storage_obj)) {
+    if (setup_storage_type(storage, storage_obj)) {
         return -1;
     }
 
-    switch (config->storage.type)
+    switch (storage->type)
     {
         case STORAGE_NULL:
-        return setup_storage_null_parameters(config, storage_obj);
+        return setup_storage_null_parameters(storage, storage_obj);
 
         case STORAGE_CSV:
-        return setup_storage_csv_parameters(config, storage_obj);
+        return setup_storage_csv_parameters(storage, storage_obj);
 
         case STORAGE_SOCKET:
-        return setup_storage_socket_parameters(config, storage_obj);
+        return setup_storage_socket_parameters(storage, storage_obj);
+
+        case STORAGE_COLUMNAR:
+        return setup_storage_columnar_parameters(storage, storage_obj);
+
+        case STORAGE_TIMESERIES:
+        return setup_storage_timeseries_parameters(storage, storage_obj);
+
+        case STORAGE_FANOUT:
+        return setup_storage_fanout_parameters(storage, storage_obj);
+
+        case STORAGE_PROMETHEUS:
+        return setup_storage_prometheus_parameters(storage, storage_obj);
 
 #ifdef HAVE_MONGODB
         case STORAGE_MONGODB:
-        return setup_storage_mongodb_parameters(config, storage_obj);
+        return setup_storage_mongodb_parameters(storage, storage_obj);
 #endif
 
         default:
@@ -320,12 +837,7 @@ setup_perf_events_group_mode(struct events_group *events_group, json_object *mod
     const char *mode = NULL;
 
     mode = json_object_get_string(mode_obj);
-    if (!strcasecmp(mode, "MONITOR_ONE_CPU_PER_SOCKET") || !strcasecmp(mode, "ONE_CPU_PER_SOCKET")) {
-        events_group->type = MONITOR_ONE_CPU_PER_SOCKET;
-        return 0;
-    }
-    if (!strcasecmp(mode, "MONITOR_ALL_CPU_PER_SOCKET") || !strcasecmp(mode, "ALL_CPU_PER_SOCKET")) {
-        events_group->type = MONITOR_ALL_CPU_PER_SOCKET;
+    if (!events_group_set_monitoring_type(events_group, mode)) {
         return 0;
     }
 
@@ -333,6 +845,22 @@ setup_perf_events_group_mode(struct events_group *events_group, json_object *mod
     return -1;
 }
 
+static int
+setup_perf_events_group_interval(struct events_group *events_group, json_object *interval_obj)
+{
+    int interval_ms = -1;
+
+    errno = 0;
+    interval_ms = json_object_get_int(interval_obj);
+    if (errno != 0 || interval_ms <= 0) {
+        zsys_error("config: json: Sampling interval of events group '%s' is invalid (strictly positive integer expected)", events_group->name);
+        return -1;
+    }
+
+    events_group->interval_ms = (unsigned int) interval_ms;
+    return 0;
+}
+
 static int
 handle_perf_events_group_parameters(const char *events_group_name, json_object *events_group_obj, zhashx_t *events_groups)
 {
@@ -356,6 +884,11 @@ handle_perf_events_group_parameters(const char *events_group_name, json_object *
                 goto cleanup;
             }
         }
+        else if (!strcasecmp(key, "interval") || !strcasecmp(key, "sampling-interval")) {
+            if (setup_perf_events_group_interval(events_group, value)) {
+                goto cleanup;
+            }
+        }
         else {
             zsys_error("config: json: Invalid parameter '%s' for '%s' events group", key, events_group);
             goto cleanup;
@@ -366,7 +899,7 @@ handle_perf_events_group_parameters(const char *events_group_name, json_object *
     zhashx_insert(events_groups, events_group_name, events_group);
 
 cleanup:
-    events_group_destroy(&events_group); /* The events group are duplicated on insert */
+    events_group_destroy(&events_group); /* The events group are referenced on insert */
     return ret;
 }
 
@@ -401,18 +934,104 @@ process_json_fields(struct config *config, json_object *root)
                 return -1;
             }
         }
+        else if (!strcasecmp(key, "cgroup-depth")) {
+            if (setup_cgroup_depth(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "cgroup-pattern")) {
+            if (setup_cgroup_pattern(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "cgroup-include")) {
+            if (setup_cgroup_filter(config->sensor.cgroup_include, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "cgroup-exclude")) {
+            if (setup_cgroup_filter(config->sensor.cgroup_exclude, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "min-lifetime-cycles")) {
+            if (setup_min_lifetime_cycles(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "min-lifetime")) {
+            if (setup_min_lifetime(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "host-root")) {
+            if (setup_host_root(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "self-monitoring")) {
+            config->sensor.self_monitoring = json_object_get_boolean(value);
+        }
+        else if (!strcasecmp(key, "control-endpoint")) {
+            if (setup_control_endpoint(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "trace-output")) {
+            if (setup_trace_output(config, value)) {
+                return -1;
+            }
+        }
         else if (!strcasecmp(key, "frequency") || !strcasecmp(key, "perf-sampling-interval")) {
             if (setup_perf_sampling_interval(config, value)) {
                 return -1;
             }
         }
+        else if (!strcasecmp(key, "perf-setup-workers")) {
+            if (setup_perf_setup_workers(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "cgroup-grace-period")) {
+            if (setup_cgroup_grace_period(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "adaptive-threshold")) {
+            if (setup_adaptive_threshold(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "adaptive-max-stride")) {
+            if (setup_adaptive_max_stride(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "aligned-ticks")) {
+            config->sensor.aligned_ticks = json_object_get_boolean(value);
+        }
+        else if (!strcasecmp(key, "overload-queue-depth")) {
+            if (setup_overload_queue_depth(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "overload-read-latency")) {
+            if (setup_overload_read_latency(config, value)) {
+                return -1;
+            }
+        }
+        else if (!strcasecmp(key, "overload-max-factor")) {
+            if (setup_overload_max_factor(config, value)) {
+                return -1;
+            }
+        }
         else if (!strcasecmp(key, "cgroup-discovery-interval")) {
             if (setup_cgroup_discovery_interval(config, value)) {
                 return -1;
             }
         }
         else if (!strcasecmp(key, "output") || !strcasecmp(key, "storage")) {
-            if (handle_storage_parameters(config, value)) {
+            if (handle_storage_parameters(&config->storage, value)) {
                 return -1;
             }
         }
@@ -31,11 +31,18 @@
 
 #include <czmq.h>
 #include <perfmon/pfmlib_perf_event.h>
+#include <pthread.h>
 #include <stdlib.h>
 
 #include "events.h"
 #include "util.h"
 
+/*
+ * event_encodings caches the attributes of the events, their encoding is only resolved once per process.
+ */
+static zhashx_t *event_encodings = NULL; /* char *event_name -> struct perf_event_attr *attr */
+static pthread_mutex_t event_encodings_lock = PTHREAD_MUTEX_INITIALIZER;
+
 
 static int
 setup_msr_perf_event_attr_type(struct perf_event_attr *attr)
@@ -117,13 +124,59 @@ setup_perf_event_attr(const char *event_name, struct perf_event_attr *attr)
     return 0;
 }
 
+static int
+lookup_perf_event_attr(const char *event_name, struct perf_event_attr *attr)
+{
+    struct perf_event_attr *cached_attr = NULL;
+    int ret = -1;
+
+    pthread_mutex_lock(&event_encodings_lock);
+
+    if (!event_encodings) {
+        event_encodings = zhashx_new();
+        if (!event_encodings)
+            goto out;
+        zhashx_set_destructor(event_encodings, (zhashx_destructor_fn *) ptrfree);
+    }
+
+    cached_attr = (struct perf_event_attr *) zhashx_lookup(event_encodings, event_name);
+    if (cached_attr) {
+        *attr = *cached_attr;
+        ret = 0;
+        goto out;
+    }
+
+    if (setup_perf_event_attr(event_name, attr))
+        goto out;
+
+    /* an event that cannot be cached is resolved again when needed */
+    cached_attr = (struct perf_event_attr *) malloc(sizeof(struct perf_event_attr));
+    if (cached_attr) {
+        *cached_attr = *attr;
+        zhashx_insert(event_encodings, event_name, cached_attr);
+    }
+    ret = 0;
+
+out:
+    pthread_mutex_unlock(&event_encodings_lock);
+    return ret;
+}
+
+void
+event_encodings_clear(void)
+{
+    pthread_mutex_lock(&event_encodings_lock);
+    zhashx_destroy(&event_encodings);
+    pthread_mutex_unlock(&event_encodings_lock);
+}
+
 struct event_config *
 event_config_create(const char *event_name)
 {
     struct perf_event_attr attr = {};
     struct event_config *config = NULL;
 
-    if (!setup_perf_event_attr(event_name, &attr)) {
+    if (!lookup_perf_event_attr(event_name, &attr)) {
         config = (struct event_config *) malloc(sizeof(struct event_config));
         if (config) {
             snprintf(config->name, NAME_MAX, "%s", event_name);
@@ -167,10 +220,10 @@ events_group_create(const char *name)
     if (group) {
         snprintf(group->name, NAME_MAX, "%s", name);
         group->type = MONITOR_ALL_CPU_PER_SOCKET; /* by default, monitor all cpu of the available socket(s) */
-
-        group->events = zlistx_new();
-        zlistx_set_duplicator(group->events, (zlistx_duplicator_fn *) event_config_dup);
-        zlistx_set_destructor(group->events, (zlistx_destructor_fn *) event_config_destroy);
+        group->interval_ms = 0;
+        group->refcount = 1;
+        group->num_events = 0;
+        group->events = NULL;
     }
 
     return group;
@@ -186,13 +239,48 @@ events_group_dup(struct events_group *group)
         if (copy) {
             snprintf(copy->name, NAME_MAX, "%s", group->name);
             copy->type = group->type;
-            copy->events = zlistx_dup(group->events);
+            copy->interval_ms = group->interval_ms;
+            copy->refcount = 1;
+            copy->num_events = 0;
+            copy->events = NULL;
+            if (group->num_events) {
+                copy->events = (struct event_config *) malloc(group->num_events * sizeof(struct event_config));
+                if (!copy->events) {
+                    free(copy);
+                    return NULL;
+                }
+                memcpy(copy->events, group->events, group->num_events * sizeof(struct event_config));
+                copy->num_events = group->num_events;
+            }
         }
     }
 
     return copy;
 }
 
+struct events_group *
+events_group_ref(struct events_group *group)
+{
+    if (group)
+        __atomic_add_fetch(&group->refcount, 1, __ATOMIC_RELAXED);
+
+    return group;
+}
+
+int
+events_group_add_event(struct events_group *group, const struct event_config *event)
+{
+    struct event_config *events = NULL;
+
+    events = (struct event_config *) realloc(group->events, (group->num_events + 1) * sizeof(struct event_config));
+    if (!events)
+        return -1;
+
+    events[group->num_events++] = *event;
+    group->events = events;
+    return 0;
+}
+
 int
 events_group_append_event(struct events_group *group, const char *event_name)
 {
@@ -202,21 +290,67 @@ events_group_append_event(struct events_group *group, const char *event_name)
     if (group) {
         event = event_config_create(event_name);
         if (event) {
-            zlistx_add_end(group->events, event);
+            ret = events_group_add_event(group, event);
             free(event);
-            ret = 0;
         }
     }
 
     return ret;
 }
 
+int
+events_group_set_monitoring_type(struct events_group *group, const char *type_name)
+{
+    static const char *monitoring_types_name[] = {
+        [MONITOR_ALL_CPU_PER_SOCKET] = "ALL_CPU_PER_SOCKET",
+        [MONITOR_ONE_CPU_PER_SOCKET] = "ONE_CPU_PER_SOCKET",
+        [MONITOR_ONE_CPU_PER_DIE] = "ONE_CPU_PER_DIE",
+        [MONITOR_ONE_CPU_PER_L3] = "ONE_CPU_PER_L3",
+        [MONITOR_ONE_CPU_PER_NUMA_NODE] = "ONE_CPU_PER_NUMA_NODE",
+    };
+    size_t type_i;
+
+    if (!strncasecmp(type_name, "MONITOR_", 8))
+        type_name += 8;
+
+    for (type_i = 0; type_i < sizeof(monitoring_types_name) / sizeof(monitoring_types_name[0]); type_i++) {
+        if (!strcasecmp(type_name, monitoring_types_name[type_i])) {
+            group->type = (enum events_group_monitoring_type) type_i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+bool
+events_group_has_same_events(struct events_group *group, struct events_group *other)
+{
+    size_t event_i;
+
+    if (group->type != other->type || group->num_events != other->num_events)
+        return false;
+
+    for (event_i = 0; event_i < group->num_events; event_i++) {
+        if (strcmp(group->events[event_i].name, other->events[event_i].name) || memcmp(&group->events[event_i].attr, &other->events[event_i].attr, sizeof(struct perf_event_attr)))
+            return false;
+    }
+
+    return true;
+}
+
 void
 events_group_destroy(struct events_group **group)
 {
-    if (*group) {
-        zlistx_destroy(&(*group)->events);
+    if (!*group)
+        return;
+
+    /* the group is shared by the configs of the sensor and of the perf actors */
+    if (__atomic_sub_fetch(&(*group)->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        free((*group)->events);
         free(*group);
     }
+
+    *group = NULL;
 }
 
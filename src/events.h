@@ -42,7 +42,10 @@
 enum events_group_monitoring_type
 {
     MONITOR_ALL_CPU_PER_SOCKET,
-    MONITOR_ONE_CPU_PER_SOCKET
+    MONITOR_ONE_CPU_PER_SOCKET,
+    MONITOR_ONE_CPU_PER_DIE,
+    MONITOR_ONE_CPU_PER_L3,
+    MONITOR_ONE_CPU_PER_NUMA_NODE
 };
 
 /*
@@ -56,12 +59,16 @@ struct event_config
 
 /*
  * events_group is the events group container.
+ * A group is shared by reference between the configs of the sensor and of the perf actors, it must not be changed once shared.
  */
 struct events_group
 {
     char name[NAME_MAX];
     enum events_group_monitoring_type type;
-    zlistx_t *events; /* struct event_config *event */
+    unsigned int interval_ms; /* sampling interval of the group, 0 to use the sensor sampling interval */
+    unsigned int refcount;
+    size_t num_events;
+    struct event_config *events; /* iterated by index, the list of events has no cursor shared by the readers */
 };
 
 /*
@@ -69,6 +76,11 @@ struct events_group
  */
 struct event_config *event_config_create(const char *event_name);
 
+/*
+ * event_encodings_clear free the cached encoding of the events created so far.
+ */
+void event_encodings_clear(void);
+
 /*
  * event_config_dup duplicate the given event config container.
  */
@@ -89,13 +101,33 @@ struct events_group *events_group_create(const char *name);
  */
 struct events_group *events_group_dup(struct events_group *group);
 
+/*
+ * events_group_ref returns the given events group after taking a reference on it, it is released by events_group_destroy.
+ */
+struct events_group *events_group_ref(struct events_group *group);
+
+/*
+ * events_group_add_event store a copy of the given event config into the events group container.
+ */
+int events_group_add_event(struct events_group *group, const struct event_config *event);
+
 /*
  * events_group_append_event get the event attributes from its name (if available) and store it into the events group container.
  */
 int events_group_append_event(struct events_group *group, const char *event_name);
 
 /*
- * events_group_destroy free the allocated resources of the events group container.
+ * events_group_set_monitoring_type set the monitoring type of the events group from its name, with or without the "MONITOR_" prefix.
+ */
+int events_group_set_monitoring_type(struct events_group *group, const char *type_name);
+
+/*
+ * events_group_has_same_events returns true when both events groups have the same monitoring type and events, in the same order.
+ */
+bool events_group_has_same_events(struct events_group *group, struct events_group *other);
+
+/*
+ * events_group_destroy release a reference on the events group container and free its resources when it was the last one.
  */
 void events_group_destroy(struct events_group **group);
 
@@ -29,6 +29,8 @@
  *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <regex.h>
@@ -48,45 +50,11 @@
 #define CPU_ID_REGEX "^cpu([0-9]+)$"
 #define CPU_ID_REGEX_EXPECTED_MATCHES 2
 
+/*
+ * CPU_CACHE_INDEX_MAX is the maximum number of caches described for a CPU.
+ */
+#define CPU_CACHE_INDEX_MAX 16
 
-static struct hwinfo_pkg *
-hwinfo_pkg_create(void)
-{
-    struct hwinfo_pkg *pkg = (struct hwinfo_pkg *) malloc(sizeof(struct hwinfo_pkg));
-
-    if (!pkg)
-        return NULL;
-
-    pkg->cpus_id = zlistx_new();
-    zlistx_set_duplicator(pkg->cpus_id, (zlistx_duplicator_fn *) strdup);
-    zlistx_set_destructor(pkg->cpus_id, (zlistx_destructor_fn *) ptrfree);
-
-    return pkg;
-}
-
-static struct hwinfo_pkg *
-hwinfo_pkg_dup(struct hwinfo_pkg *pkg)
-{
-    struct hwinfo_pkg *pkgcpy = (struct hwinfo_pkg *) malloc(sizeof(struct hwinfo_pkg));
-
-    if (!pkgcpy)
-        return NULL;
-
-    pkgcpy->cpus_id = zlistx_dup(pkg->cpus_id);
-
-    return pkgcpy;
-}
-
-static void
-hwinfo_pkg_destroy(struct hwinfo_pkg **pkg_ptr)
-{
-    if (!*pkg_ptr)
-        return;
-
-    zlistx_destroy(&(*pkg_ptr)->cpus_id);
-    free(*pkg_ptr);
-    *pkg_ptr = NULL;
-}
 
 static int
 get_cpu_online_status(const char *cpu_dir)
@@ -114,42 +82,250 @@ get_cpu_online_status(const char *cpu_dir)
     return status;
 }
 
-static char *
-get_package_id(const char *cpu_dir)
+static int
+parse_id(const char *str, int *id)
+{
+    char *endp = NULL;
+    long value;
+
+    errno = 0;
+    value = strtol(str, &endp, 10);
+    if (*str == '\0' || (*endp != '\0' && *endp != '\n') || errno)
+        return -1;
+
+    if (value < 0 || value > INT_MAX)
+        return -1;
+
+    *id = (int) value;
+    return 0;
+}
+
+static int
+read_id_file(const char *path, int *id)
 {
+    int ret = -1;
     FILE *f = NULL;
-    char path[PATH_MAX] = {};
     char buffer[24]; /* log10(ULLONG_MAX) */
-    char *id = NULL;
 
-    snprintf(path, PATH_MAX, "%s/%s/topology/physical_package_id", SYSFS_CPU_PATH, cpu_dir);
+    f = fopen(path, "r");
+    if (f) {
+        if (fgets(buffer, sizeof(buffer), f)) {
+            ret = parse_id(buffer, id);
+        }
+        fclose(f);
+    }
+
+    return ret;
+}
+
+static int
+get_topology_id(const char *cpu_dir, const char *name, int *id)
+{
+    char path[PATH_MAX] = {};
+
+    snprintf(path, PATH_MAX, "%s/%s/topology/%s", SYSFS_CPU_PATH, cpu_dir, name);
+    return read_id_file(path, id);
+}
+
+static int
+get_first_shared_cpu(const char *path, int *id)
+{
+    int ret = -1;
+    FILE *f = NULL;
+    char buffer[24];
+    char *endp = NULL;
+    long value;
 
     f = fopen(path, "r");
     if (f) {
+        /* the list starts with the lowest cpu id, as in "0-3,8-11" */
         if (fgets(buffer, sizeof(buffer), f)) {
-            id = strndup(buffer, strlen(buffer) - 1);
+            errno = 0;
+            value = strtol(buffer, &endp, 10);
+            if (endp != buffer && !errno && value >= 0 && value <= INT_MAX) {
+                *id = (int) value;
+                ret = 0;
+            }
         }
         fclose(f);
     }
 
-    return id;
+    return ret;
 }
 
-static char *
-parse_cpu_id_from_name(const char *str)
+static int
+get_l3_cache_id(const char *cpu_dir, int *id)
 {
+    char path[PATH_MAX] = {};
+    int cache_i;
+    int level;
+
+    for (cache_i = 0; cache_i < CPU_CACHE_INDEX_MAX; cache_i++) {
+        snprintf(path, PATH_MAX, "%s/%s/cache/index%d/level", SYSFS_CPU_PATH, cpu_dir, cache_i);
+        if (read_id_file(path, &level))
+            return -1;
+
+        if (level != 3)
+            continue;
+
+        /* the id of the cache is not exposed by older kernels, the cache is then identified by its first cpu */
+        snprintf(path, PATH_MAX, "%s/%s/cache/index%d/id", SYSFS_CPU_PATH, cpu_dir, cache_i);
+        if (!read_id_file(path, id))
+            return 0;
+
+        snprintf(path, PATH_MAX, "%s/%s/cache/index%d/shared_cpu_list", SYSFS_CPU_PATH, cpu_dir, cache_i);
+        return get_first_shared_cpu(path, id);
+    }
+
+    return -1;
+}
+
+static int
+get_numa_node_id(const char *cpu_dir, int *id)
+{
+    int ret = -1;
+    char path[PATH_MAX] = {};
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+
+    /* the cpu directory links to the directory of its NUMA node */
+    snprintf(path, PATH_MAX, "%s/%s", SYSFS_CPU_PATH, cpu_dir);
+    dir = opendir(path);
+    if (!dir)
+        return -1;
+
+    for (entry = readdir(dir); entry; entry = readdir(dir)) {
+        if (!strncmp(entry->d_name, "node", 4) && !parse_id(entry->d_name + 4, id)) {
+            ret = 0;
+            break;
+        }
+    }
+
+    closedir(dir);
+    return ret;
+}
+
+static int
+parse_cpu_id_from_name(const char *str, int *cpu_id)
+{
+    int ret = -1;
     regex_t re = {};
     regmatch_t matches[CPU_ID_REGEX_EXPECTED_MATCHES];
-    char *id = NULL;
 
     if (!regcomp(&re, CPU_ID_REGEX, REG_EXTENDED)) {
         if (!regexec(&re, str, CPU_ID_REGEX_EXPECTED_MATCHES, matches, 0)) {
-            id = strndup(str + matches[1].rm_so, matches[1].rm_eo - matches[1].rm_so);
+            ret = parse_id(str + matches[1].rm_so, cpu_id);
         }
         regfree(&re);
     }
 
-    return id;
+    return ret;
+}
+
+static struct hwinfo_cpu *
+store_cpu(struct hwinfo *hwinfo, int pkg_id, int cpu_id)
+{
+    struct hwinfo_pkg *pkgs = NULL;
+    struct hwinfo_cpu *cpus = NULL;
+    struct hwinfo_pkg *pkg = NULL;
+    size_t pkg_i;
+    size_t cpu_i;
+
+    if (pkg_id < 0 || cpu_id < 0)
+        return NULL;
+
+    for (pkg_i = 0; pkg_i < hwinfo->num_pkgs && hwinfo->pkgs[pkg_i].id < pkg_id; pkg_i++);
+
+    /* get cpu pkg or create it if never encountered */
+    if (pkg_i == hwinfo->num_pkgs || hwinfo->pkgs[pkg_i].id != pkg_id) {
+        pkgs = (struct hwinfo_pkg *) realloc(hwinfo->pkgs, (hwinfo->num_pkgs + 1) * sizeof(struct hwinfo_pkg));
+        if (!pkgs)
+            return NULL;
+
+        hwinfo->pkgs = pkgs;
+        memmove(&pkgs[pkg_i + 1], &pkgs[pkg_i], (hwinfo->num_pkgs - pkg_i) * sizeof(struct hwinfo_pkg));
+        pkgs[pkg_i].id = pkg_id;
+        snprintf(pkgs[pkg_i].id_str, HWINFO_ID_MAX, "%d", pkg_id);
+        pkgs[pkg_i].first_cpu = (pkg_i < hwinfo->num_pkgs) ? pkgs[pkg_i + 1].first_cpu : hwinfo->num_cpus;
+        pkgs[pkg_i].num_cpus = 0;
+        hwinfo->num_pkgs++;
+    }
+
+    pkg = &hwinfo->pkgs[pkg_i];
+    for (cpu_i = pkg->first_cpu; cpu_i < pkg->first_cpu + pkg->num_cpus && hwinfo->cpus[cpu_i].id < cpu_id; cpu_i++);
+
+    if (cpu_i < pkg->first_cpu + pkg->num_cpus && hwinfo->cpus[cpu_i].id == cpu_id)
+        return &hwinfo->cpus[cpu_i];
+
+    cpus = (struct hwinfo_cpu *) realloc(hwinfo->cpus, (hwinfo->num_cpus + 1) * sizeof(struct hwinfo_cpu));
+    if (!cpus)
+        return NULL;
+
+    /* the cpus of a package are contiguous, the following packages are shifted by the insertion */
+    hwinfo->cpus = cpus;
+    memmove(&cpus[cpu_i + 1], &cpus[cpu_i], (hwinfo->num_cpus - cpu_i) * sizeof(struct hwinfo_cpu));
+    cpus[cpu_i].id = cpu_id;
+    cpus[cpu_i].core_id = cpu_id;
+    cpus[cpu_i].die_id = -1;
+    cpus[cpu_i].l3_id = -1;
+    cpus[cpu_i].node_id = -1;
+    snprintf(cpus[cpu_i].id_str, HWINFO_ID_MAX, "%d", cpu_id);
+    hwinfo->num_cpus++;
+    pkg->num_cpus++;
+    for (pkg_i++; pkg_i < hwinfo->num_pkgs; pkg_i++) {
+        hwinfo->pkgs[pkg_i].first_cpu++;
+    }
+
+    return &cpus[cpu_i];
+}
+
+int
+hwinfo_add_cpu(struct hwinfo *hwinfo, int pkg_id, int cpu_id)
+{
+    return store_cpu(hwinfo, pkg_id, cpu_id) ? 0 : -1;
+}
+
+bool
+hwinfo_has_cpu(const struct hwinfo *hwinfo, int pkg_id, int cpu_id)
+{
+    const struct hwinfo_pkg *pkg = NULL;
+    size_t cpu_i;
+
+    for (pkg = hwinfo->pkgs; pkg < hwinfo->pkgs + hwinfo->num_pkgs; pkg++) {
+        if (pkg->id != pkg_id)
+            continue;
+
+        for (cpu_i = pkg->first_cpu; cpu_i < pkg->first_cpu + pkg->num_cpus; cpu_i++) {
+            if (hwinfo->cpus[cpu_i].id == cpu_id)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+hwinfo_equal(const struct hwinfo *hwinfo, const struct hwinfo *other)
+{
+    size_t pkg_i;
+    size_t cpu_i;
+
+    if (hwinfo->num_pkgs != other->num_pkgs || hwinfo->num_cpus != other->num_cpus)
+        return false;
+
+    for (pkg_i = 0; pkg_i < hwinfo->num_pkgs; pkg_i++) {
+        if (hwinfo->pkgs[pkg_i].id != other->pkgs[pkg_i].id || hwinfo->pkgs[pkg_i].num_cpus != other->pkgs[pkg_i].num_cpus)
+            return false;
+    }
+
+    for (cpu_i = 0; cpu_i < hwinfo->num_cpus; cpu_i++) {
+        if (hwinfo->cpus[cpu_i].id != other->cpus[cpu_i].id || hwinfo->cpus[cpu_i].core_id != other->cpus[cpu_i].core_id ||
+            hwinfo->cpus[cpu_i].die_id != other->cpus[cpu_i].die_id || hwinfo->cpus[cpu_i].l3_id != other->cpus[cpu_i].l3_id ||
+            hwinfo->cpus[cpu_i].node_id != other->cpus[cpu_i].node_id)
+            return false;
+    }
+
+    return true;
 }
 
 static int
@@ -159,9 +335,9 @@ do_packages_detection(struct hwinfo *hwinfo)
     DIR *dir = NULL;
     struct dirent *entry = NULL;
     int cpu_online;
-    char *cpu_id = NULL;
-    char *pkg_id = NULL;
-    struct hwinfo_pkg *pkg = NULL;
+    int cpu_id;
+    int pkg_id;
+    struct hwinfo_cpu *cpu = NULL;
 
     dir = opendir(SYSFS_CPU_PATH);
     if (!dir) {
@@ -174,50 +350,41 @@ do_packages_detection(struct hwinfo *hwinfo)
 	if ((entry->d_type & DT_LNK) && (entry->d_name[0] != '.')) {
 	    cpu_online = get_cpu_online_status(entry->d_name);
 	    if (!cpu_online) {
-		zsys_info("hwinfo: %s is offline and will be ignored", entry->d_name);
+		zsys_debug("hwinfo: %s is offline and will be ignored", entry->d_name);
 		continue;
 	    }
 
-            cpu_id = parse_cpu_id_from_name(entry->d_name);
-            if (!cpu_id) {
+            if (parse_cpu_id_from_name(entry->d_name, &cpu_id)) {
                 zsys_error("hwinfo: failed to parse cpu id for %s", entry->d_name);
                 goto cleanup;
             }
 
-            pkg_id = get_package_id(entry->d_name);
-            if (!pkg_id) {
+            if (get_topology_id(entry->d_name, "physical_package_id", &pkg_id)) {
                 zsys_error("hwinfo: failed to parse package id for %s", entry->d_name);
                 goto cleanup;
             }
 
-            /* get cpu pkg or create it if never encountered */
-            pkg = (struct hwinfo_pkg *) zhashx_lookup(hwinfo->pkgs, pkg_id);
-            if (!pkg) {
-                pkg = hwinfo_pkg_create();
-                if (!pkg) {
-                    zsys_error("hwinfo: failed to allocate package info struct");
-                    goto cleanup;
-                }
-
-                zhashx_insert(hwinfo->pkgs, pkg_id, pkg);
-                hwinfo_pkg_destroy(&pkg);
-                pkg = (struct hwinfo_pkg *) zhashx_lookup(hwinfo->pkgs, pkg_id); /* get the copy the pkg done by zhashx_insert */
+            cpu = store_cpu(hwinfo, pkg_id, cpu_id);
+            if (!cpu) {
+                zsys_error("hwinfo: failed to allocate package info struct");
+                goto cleanup;
             }
 
-            zlistx_add_end(pkg->cpus_id, cpu_id);
-
-            free(cpu_id);
-            cpu_id = NULL;
-            free(pkg_id);
-            pkg_id = NULL;
+            /* the topology domains not exposed by the kernel or the architecture are left unknown */
+            if (get_topology_id(entry->d_name, "core_id", &cpu->core_id))
+                cpu->core_id = cpu_id;
+            if (get_topology_id(entry->d_name, "die_id", &cpu->die_id))
+                cpu->die_id = -1;
+            if (get_l3_cache_id(entry->d_name, &cpu->l3_id))
+                cpu->l3_id = -1;
+            if (get_numa_node_id(entry->d_name, &cpu->node_id))
+                cpu->node_id = -1;
         }
     }
 
     ret = 0;
 
 cleanup:
-    free(cpu_id);
-    free(pkg_id);
     closedir(dir);
     return ret;
 }
@@ -240,24 +407,22 @@ hwinfo_create(void)
     if (!hw)
         return NULL;
 
-    hw->pkgs = zhashx_new();
-    zhashx_set_duplicator(hw->pkgs, (zhashx_duplicator_fn *) hwinfo_pkg_dup);
-    zhashx_set_destructor(hw->pkgs, (zlistx_destructor_fn *) hwinfo_pkg_destroy);
+    hw->refcount = 1;
+    hw->num_pkgs = 0;
+    hw->pkgs = NULL;
+    hw->num_cpus = 0;
+    hw->cpus = NULL;
 
     return hw;
 }
 
 struct hwinfo *
-hwinfo_dup(struct hwinfo *hwinfo)
+hwinfo_ref(struct hwinfo *hwinfo)
 {
-    struct hwinfo *hwinfocpy = (struct hwinfo *) malloc(sizeof(struct hwinfo));
+    if (hwinfo)
+        __atomic_add_fetch(&hwinfo->refcount, 1, __ATOMIC_RELAXED);
 
-    if (!hwinfocpy)
-        return NULL;
-
-    hwinfocpy->pkgs = zhashx_dup(hwinfo->pkgs);
-
-    return hwinfocpy;
+    return hwinfo;
 }
 
 void
@@ -266,7 +431,11 @@ hwinfo_destroy(struct hwinfo *hwinfo)
     if (!hwinfo)
         return;
 
-    zhashx_destroy(&hwinfo->pkgs);
-    free(hwinfo);
+    /* the topology is shared by the sensor and the perf actors */
+    if (__atomic_sub_fetch(&hwinfo->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(hwinfo->pkgs);
+        free(hwinfo->cpus);
+        free(hwinfo);
+    }
 }
 
@@ -32,24 +32,53 @@
 #ifndef HWINFO_H
 #define HWINFO_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <czmq.h>
 
 
+/*
+ * HWINFO_ID_MAX is the size of the buffer storing the string representation of a cpu or package id.
+ */
+#define HWINFO_ID_MAX 12
+
+/*
+ * hwinfo_cpu stores information about a logical cpu.
+ * The ids of the topology domains of the cpu are -1 when unknown, the domain then spans the whole package.
+ */
+struct hwinfo_cpu
+{
+    int id;
+    int core_id; /* shared by the thread siblings of the cpu */
+    int die_id;
+    int l3_id; /* id of the L3 cache shared by the cpu */
+    int node_id; /* NUMA node of the cpu */
+    char id_str[HWINFO_ID_MAX];
+};
+
 /*
  * hwinfo_pkg stores information about the package.
  */
 struct hwinfo_pkg
 {
-    zlistx_t *cpus_id; /* char *cpu_id */
+    int id;
+    char id_str[HWINFO_ID_MAX];
+    size_t first_cpu; /* index of the first cpu of the package in the cpus array */
+    size_t num_cpus;
 };
 
 /*
  * hwinfo stores information about the machine hardware.
+ * The topology is shared by reference between the perf actors and must not be modified once shared.
+ * A change of the topology is handled by detecting a new hwinfo and replacing the shared one.
  */
 struct hwinfo
 {
-    zhashx_t *pkgs; /* char *pkg_id -> struct hwinfo_pkg *pkg */
+    unsigned int refcount;
+    size_t num_pkgs;
+    struct hwinfo_pkg *pkgs; /* sorted by package id */
+    size_t num_cpus;
+    struct hwinfo_cpu *cpus; /* grouped by package, sorted by cpu id */
 };
 
 /*
@@ -63,14 +92,29 @@ struct hwinfo *hwinfo_create(void);
 int hwinfo_detect(struct hwinfo *hwinfo);
 
 /*
-* hwinfo_dup duplicate the hwinfo struct and its members.
+ * hwinfo_add_cpu store the given cpu into its package, the package is created if never encountered.
+ * The cpu is its own core and its other topology domains are unknown.
+ */
+int hwinfo_add_cpu(struct hwinfo *hwinfo, int pkg_id, int cpu_id);
+
+/*
+ * hwinfo_has_cpu returns true if the given cpu of the given package is part of the topology.
+ */
+bool hwinfo_has_cpu(const struct hwinfo *hwinfo, int pkg_id, int cpu_id);
+
+/*
+ * hwinfo_equal returns true if the two topologies have the same packages and cpus.
  */
-struct hwinfo *hwinfo_dup(struct hwinfo *hwinfo);
+bool hwinfo_equal(const struct hwinfo *hwinfo, const struct hwinfo *other);
 
 /*
- * hwinfo_destroy free the allocated memory to store the machine topology.
+ * hwinfo_ref take a new reference on the given hwinfo.
+ */
+struct hwinfo *hwinfo_ref(struct hwinfo *hwinfo);
+
+/*
+ * hwinfo_destroy release a reference and free the allocated memory when the last one is released.
  */
 void hwinfo_destroy(struct hwinfo *hwinfo);
 
 #endif /* HWINFO_H */
-
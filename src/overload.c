@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "overload.h"
+
+struct overload_monitor *
+overload_monitor_create(size_t queue_threshold, uint64_t read_latency_threshold_ms, unsigned int max_factor)
+{
+    struct overload_monitor *monitor = (struct overload_monitor *) malloc(sizeof(struct overload_monitor));
+
+    if (!monitor)
+        return NULL;
+
+    monitor->queue_threshold = queue_threshold;
+    monitor->read_latency_threshold_ms = read_latency_threshold_ms;
+    monitor->max_factor = (max_factor) ? max_factor : 1;
+    monitor->pending_payloads = 0;
+    monitor->max_read_latency_ms = 0;
+    monitor->factor = 1;
+
+    return monitor;
+}
+
+void
+overload_monitor_destroy(struct overload_monitor **monitor_ptr)
+{
+    if (!*monitor_ptr)
+        return;
+
+    free(*monitor_ptr);
+    *monitor_ptr = NULL;
+}
+
+void
+overload_monitor_payload_queued(struct overload_monitor *monitor)
+{
+    if (!monitor)
+        return;
+
+    __atomic_add_fetch(&monitor->pending_payloads, 1, __ATOMIC_RELAXED);
+}
+
+void
+overload_monitor_payload_stored(struct overload_monitor *monitor)
+{
+    if (!monitor)
+        return;
+
+    __atomic_sub_fetch(&monitor->pending_payloads, 1, __ATOMIC_RELAXED);
+}
+
+void
+overload_monitor_report_read_latency(struct overload_monitor *monitor, uint64_t read_latency_ms)
+{
+    uint64_t current;
+
+    if (!monitor)
+        return;
+
+    current = __atomic_load_n(&monitor->max_read_latency_ms, __ATOMIC_RELAXED);
+    while (read_latency_ms > current) {
+        if (__atomic_compare_exchange_n(&monitor->max_read_latency_ms, &current, read_latency_ms, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            break;
+    }
+}
+
+static bool
+is_above(uint64_t value, uint64_t threshold)
+{
+    return threshold && value > threshold;
+}
+
+static bool
+is_below_half(uint64_t value, uint64_t threshold)
+{
+    return !threshold || value < threshold / 2;
+}
+
+unsigned int
+overload_monitor_evaluate(struct overload_monitor *monitor, bool missed_ticks)
+{
+    size_t pending_payloads;
+    uint64_t max_read_latency_ms;
+    unsigned int factor;
+
+    if (!monitor)
+        return 1;
+
+    pending_payloads = __atomic_load_n(&monitor->pending_payloads, __ATOMIC_RELAXED);
+    max_read_latency_ms = __atomic_exchange_n(&monitor->max_read_latency_ms, 0, __ATOMIC_RELAXED);
+    factor = monitor->factor;
+
+    /* widen the intervals while overloaded, and narrow them back with some hysteresis once the load dropped */
+    if (missed_ticks || is_above(pending_payloads, monitor->queue_threshold) || is_above(max_read_latency_ms, monitor->read_latency_threshold_ms)) {
+        factor = (factor * 2 < monitor->max_factor) ? factor * 2 : monitor->max_factor;
+    }
+    else if (is_below_half(pending_payloads, monitor->queue_threshold) && is_below_half(max_read_latency_ms, monitor->read_latency_threshold_ms)) {
+        factor = (factor > 1) ? factor / 2 : 1;
+    }
+
+    if (factor != monitor->factor) {
+        zsys_warning("overload: sampling intervals multiplied by %u (pending payloads=%zu, read latency=%" PRIu64 " ms)", factor, pending_payloads, max_read_latency_ms);
+        __atomic_store_n(&monitor->factor, factor, __ATOMIC_RELAXED);
+    }
+
+    return factor;
+}
+
+unsigned int
+overload_monitor_get_factor(struct overload_monitor *monitor)
+{
+    if (!monitor)
+        return 1;
+
+    return __atomic_load_n(&monitor->factor, __ATOMIC_RELAXED);
+}
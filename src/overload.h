@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OVERLOAD_H
+#define OVERLOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * overload_monitor stores the load indicators of the sensor and the resulting sampling interval multiplier.
+ * The indicators are updated concurrently by the perf and reporting actors, and evaluated by the ticker at each tick.
+ */
+struct overload_monitor
+{
+    size_t queue_threshold; /* pending payloads above which the sensor is overloaded, 0 to ignore */
+    uint64_t read_latency_threshold_ms; /* read latency above which the sensor is overloaded, 0 to ignore */
+    unsigned int max_factor;
+    size_t pending_payloads; /* atomic, payloads sent to the reporting actor and not yet stored */
+    uint64_t max_read_latency_ms; /* atomic, highest read latency since the last evaluation */
+    unsigned int factor; /* atomic, multiplier applied to the sampling intervals */
+};
+
+/*
+ * overload_monitor_create allocate the resources of an overload monitor using the given thresholds.
+ */
+struct overload_monitor *overload_monitor_create(size_t queue_threshold, uint64_t read_latency_threshold_ms, unsigned int max_factor);
+
+/*
+ * overload_monitor_destroy free the allocated resources of the overload monitor.
+ */
+void overload_monitor_destroy(struct overload_monitor **monitor_ptr);
+
+/*
+ * overload_monitor_payload_queued account a payload sent to the reporting actor.
+ */
+void overload_monitor_payload_queued(struct overload_monitor *monitor);
+
+/*
+ * overload_monitor_payload_stored account a payload processed by the reporting actor.
+ */
+void overload_monitor_payload_stored(struct overload_monitor *monitor);
+
+/*
+ * overload_monitor_report_read_latency account the time spent by an actor to read its events.
+ */
+void overload_monitor_report_read_latency(struct overload_monitor *monitor, uint64_t read_latency_ms);
+
+/*
+ * overload_monitor_evaluate update and returns the sampling interval multiplier from the load indicators.
+ */
+unsigned int overload_monitor_evaluate(struct overload_monitor *monitor, bool missed_ticks);
+
+/*
+ * overload_monitor_get_factor returns the current sampling interval multiplier, 1 when the monitor is NULL.
+ */
+unsigned int overload_monitor_get_factor(struct overload_monitor *monitor);
+
+#endif /* OVERLOAD_H */
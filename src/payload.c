@@ -50,6 +50,23 @@ payload_cpu_data_create(void)
     return data;
 }
 
+struct payload_cpu_data *
+payload_cpu_data_dup(struct payload_cpu_data *data)
+{
+    struct payload_cpu_data *copy = (struct payload_cpu_data *) malloc(sizeof(struct payload_cpu_data));
+
+    if (!copy)
+        return NULL;
+
+    copy->events = zhashx_dup(data->events);
+    if (!copy->events) {
+        free(copy);
+        return NULL;
+    }
+
+    return copy;
+}
+
 void
 payload_cpu_data_destroy(struct payload_cpu_data **data_ptr)
 {
@@ -75,6 +92,28 @@ payload_pkg_data_create(void)
     return data;
 }
 
+struct payload_pkg_data *
+payload_pkg_data_dup(struct payload_pkg_data *data)
+{
+    struct payload_pkg_data *copy = payload_pkg_data_create();
+    struct payload_cpu_data *cpu_data = NULL;
+    struct payload_cpu_data *cpu_data_copy = NULL;
+
+    if (!copy)
+        return NULL;
+
+    for (cpu_data = (struct payload_cpu_data *) zhashx_first(data->cpus); cpu_data; cpu_data = (struct payload_cpu_data *) zhashx_next(data->cpus)) {
+        cpu_data_copy = payload_cpu_data_dup(cpu_data);
+        if (!cpu_data_copy) {
+            payload_pkg_data_destroy(&copy);
+            return NULL;
+        }
+        zhashx_insert(copy->cpus, zhashx_cursor(data->cpus), cpu_data_copy);
+    }
+
+    return copy;
+}
+
 void
 payload_pkg_data_destroy(struct payload_pkg_data **data_ptr)
 {
@@ -100,6 +139,28 @@ payload_group_data_create(void)
     return data;
 }
 
+struct payload_group_data *
+payload_group_data_dup(struct payload_group_data *data)
+{
+    struct payload_group_data *copy = payload_group_data_create();
+    struct payload_pkg_data *pkg_data = NULL;
+    struct payload_pkg_data *pkg_data_copy = NULL;
+
+    if (!copy)
+        return NULL;
+
+    for (pkg_data = (struct payload_pkg_data *) zhashx_first(data->pkgs); pkg_data; pkg_data = (struct payload_pkg_data *) zhashx_next(data->pkgs)) {
+        pkg_data_copy = payload_pkg_data_dup(pkg_data);
+        if (!pkg_data_copy) {
+            payload_group_data_destroy(&copy);
+            return NULL;
+        }
+        zhashx_insert(copy->pkgs, zhashx_cursor(data->pkgs), pkg_data_copy);
+    }
+
+    return copy;
+}
+
 void
 payload_group_data_destroy(struct payload_group_data **data_ptr)
 {
@@ -120,9 +181,73 @@ payload_create(uint64_t timestamp, const char *target_name)
         return NULL;
 
     payload->timestamp = timestamp;
+    payload->read_timestamp = timestamp;
     payload->target_name = strdup(target_name);
+    payload->target_namespace = NULL;
+    payload->target_pod = NULL;
+    payload->target_container = NULL;
+    payload->interval_ms = 0;
+    payload->interval_start_timestamp = 0;
+    payload->overload_factor = 1;
+    payload->partial = false;
+    payload->setup_latency_ms = 0;
     payload->groups = zhashx_new();
     zhashx_set_destructor(payload->groups, (zhashx_destructor_fn *) payload_group_data_destroy);
+    payload->refcount = 1;
+
+    return payload;
+}
+
+int
+payload_set_target_metadata(struct payload *payload, const char *namespace_name, const char *pod_name, const char *container_name)
+{
+    if ((namespace_name && !(payload->target_namespace = strdup(namespace_name))) ||
+        (pod_name && !(payload->target_pod = strdup(pod_name))) ||
+        (container_name && !(payload->target_container = strdup(container_name))))
+        return -1;
+
+    return 0;
+}
+
+struct payload *
+payload_dup(struct payload *payload)
+{
+    struct payload *copy = payload_create(payload->timestamp, payload->target_name);
+    struct payload_group_data *group_data = NULL;
+    struct payload_group_data *group_data_copy = NULL;
+
+    if (!copy)
+        return NULL;
+
+    if (payload_set_target_metadata(copy, payload->target_namespace, payload->target_pod, payload->target_container)) {
+        payload_destroy(copy);
+        return NULL;
+    }
+
+    copy->read_timestamp = payload->read_timestamp;
+    copy->interval_ms = payload->interval_ms;
+    copy->interval_start_timestamp = payload->interval_start_timestamp;
+    copy->overload_factor = payload->overload_factor;
+    copy->partial = payload->partial;
+    copy->setup_latency_ms = payload->setup_latency_ms;
+
+    for (group_data = (struct payload_group_data *) zhashx_first(payload->groups); group_data; group_data = (struct payload_group_data *) zhashx_next(payload->groups)) {
+        group_data_copy = payload_group_data_dup(group_data);
+        if (!group_data_copy) {
+            payload_destroy(copy);
+            return NULL;
+        }
+        zhashx_insert(copy->groups, zhashx_cursor(payload->groups), group_data_copy);
+    }
+
+    return copy;
+}
+
+struct payload *
+payload_ref(struct payload *payload)
+{
+    if (payload)
+        __atomic_add_fetch(&payload->refcount, 1, __ATOMIC_RELAXED);
 
     return payload;
 }
@@ -133,7 +258,14 @@ payload_destroy(struct payload *payload)
     if (!payload)
         return;
 
+    /* the payload is shared with the storage modules storing it concurrently */
+    if (__atomic_sub_fetch(&payload->refcount, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+
     free(payload->target_name);
+    free(payload->target_namespace);
+    free(payload->target_pod);
+    free(payload->target_container);
     zhashx_destroy(&payload->groups);
     free(payload);
 }
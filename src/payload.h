@@ -60,12 +60,23 @@ struct payload_group_data
 
 /*
  * payload stores the data collected by the monitoring module for the reporting module.
+ * A payload can be shared by reference with a storage module, it must not be changed once stored.
  */
 struct payload
 {
-    uint64_t timestamp;
+    uint64_t timestamp; /* nominal time of the tick */
+    uint64_t read_timestamp; /* time at which the events were read */
     char *target_name;
+    char *target_namespace; /* metadata of a container target, NULL if unknown */
+    char *target_pod;
+    char *target_container;
+    uint64_t interval_ms; /* time elapsed since the previous payload of the target */
+    uint64_t interval_start_timestamp; /* time at which the events were previously read, or (re)enabled */
+    unsigned int overload_factor; /* multiple of the sampling interval applied because the sensor was overloaded */
+    bool partial; /* values do not cover a whole sampling interval */
+    uint64_t setup_latency_ms; /* time spent opening the perf events, only set for the first payload of a target */
     zhashx_t *groups; /* char *group_name -> struct payload_group_data *group_data */
+    unsigned int refcount;
 };
 
 /*
@@ -74,7 +85,22 @@ struct payload
 struct payload *payload_create(uint64_t timestamp, const char *target_name);
 
 /*
- * payload_destroy free the allocated resources of the monitoring payload.
+ * payload_set_target_metadata store a copy of the given container metadata of the target, NULL if unknown.
+ */
+int payload_set_target_metadata(struct payload *payload, const char *namespace_name, const char *pod_name, const char *container_name);
+
+/*
+ * payload_dup returns a deep copy of the given monitoring payload.
+ */
+struct payload *payload_dup(struct payload *payload);
+
+/*
+ * payload_ref returns the given monitoring payload after taking a reference on it, it is released by payload_destroy.
+ */
+struct payload *payload_ref(struct payload *payload);
+
+/*
+ * payload_destroy release a reference on the monitoring payload and free its resources when it was the last one.
  */
 void payload_destroy(struct payload *payload);
 
@@ -83,6 +109,11 @@ void payload_destroy(struct payload *payload);
  */
 struct payload_group_data *payload_group_data_create(void);
 
+/*
+ * payload_group_data_dup returns a deep copy of the given events group data container.
+ */
+struct payload_group_data *payload_group_data_dup(struct payload_group_data *data);
+
 /*
  * payload_group_data_destroy free the allocated resources of the events group data container.
  */
@@ -93,6 +124,11 @@ void payload_group_data_destroy(struct payload_group_data **data_ptr);
  */
 struct payload_pkg_data *payload_pkg_data_create(void);
 
+/*
+ * payload_pkg_data_dup returns a deep copy of the given package data container.
+ */
+struct payload_pkg_data *payload_pkg_data_dup(struct payload_pkg_data *data);
+
 /*
  * payload_pkg_data_destroy free the allocated resources of the package data container.
  */
@@ -103,6 +139,11 @@ void payload_pkg_data_destroy(struct payload_pkg_data **data_ptr);
  */
 struct payload_cpu_data *payload_cpu_data_create(void);
 
+/*
+ * payload_cpu_data_dup returns a deep copy of the given cpu data container.
+ */
+struct payload_cpu_data *payload_cpu_data_dup(struct payload_cpu_data *data);
+
 /*
  * payload_cpu_data_destroy free the allocated resources of the cpu data container.
  */
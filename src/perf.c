@@ -31,10 +31,10 @@
 
 #include <czmq.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <linux/perf_event.h>
 #include <linux/hw_breakpoint.h>
 #include <sys/syscall.h>
-#include <sys/ioctl.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include <string.h>
@@ -48,16 +48,19 @@
 #include "report.h"
 
 struct perf_config *
-perf_config_create(struct hwinfo *hwinfo, zhashx_t *events_groups, struct target *target)
+perf_config_create(struct hwinfo *hwinfo, zhashx_t *events_groups, struct target *target, struct perf_backend *backend, struct work_pool *setup_pool, const struct perf_sampling_config *sampling)
 {
     struct perf_config *config = (struct perf_config *) malloc(sizeof(struct perf_config));
     
     if (!config)
         return NULL;
 
-    config->hwinfo = hwinfo_dup(hwinfo);
+    config->hwinfo = hwinfo_ref(hwinfo);
     config->events_groups = zhashx_dup(events_groups);
     config->target = target;
+    config->backend = backend;
+    config->setup_pool = setup_pool;
+    config->sampling = *sampling;
 
     return config;
 }
@@ -74,28 +77,18 @@ perf_config_destroy(struct perf_config *config)
     free(config);
 }
 
-static void
-perf_event_fd_destroy(int **fd_ptr)
-{
-    if (!*fd_ptr)
-        return;
-
-    close(**fd_ptr);
-    free(*fd_ptr);
-    *fd_ptr = NULL;
-}
-
 static struct perf_group_cpu_context *
-perf_group_cpu_context_create(size_t event_count)
+perf_group_cpu_context_create(struct perf_backend *backend, size_t event_count)
 {
     struct perf_group_cpu_context *ctx = (struct perf_group_cpu_context *) malloc(sizeof(struct perf_group_cpu_context));
 
     if (!ctx)
         return NULL;
 
+    ctx->backend = backend;
     ctx->perf_fds = zlistx_new();
     zlistx_set_duplicator(ctx->perf_fds, (zlistx_duplicator_fn *) intptrdup);
-    zlistx_set_destructor(ctx->perf_fds, (zlistx_destructor_fn *) perf_event_fd_destroy);
+    zlistx_set_destructor(ctx->perf_fds, (zlistx_destructor_fn *) ptrfree);
 
     ctx->sample_size = offsetof(struct perf_read_format, values) + sizeof(struct perf_counter_value) * event_count;
     ctx->baseline_sample = (struct perf_read_format *) malloc(ctx->sample_size);
@@ -106,6 +99,7 @@ perf_group_cpu_context_create(size_t event_count)
 
     memset(ctx->baseline_sample, 0, ctx->sample_size);
     memset(ctx->scratch_sample, 0, ctx->sample_size);
+    ctx->stale = false;
 
     return ctx;
 
@@ -120,9 +114,15 @@ error:
 static void
 perf_group_cpu_context_destroy(struct perf_group_cpu_context **ctx)
 {
+    const int *perf_fd = NULL;
+
     if (!*ctx)
         return;
 
+    for (perf_fd = (const int *) zlistx_first((*ctx)->perf_fds); perf_fd; perf_fd = (const int *) zlistx_next((*ctx)->perf_fds)) {
+        (*(*ctx)->backend->close)((*ctx)->backend, *perf_fd);
+    }
+
     zlistx_destroy(&(*ctx)->perf_fds);
     free((*ctx)->baseline_sample);
     free((*ctx)->scratch_sample);
@@ -164,6 +164,11 @@ perf_group_context_create(struct events_group *group)
         return NULL;
 
     ctx->config = group;
+    ctx->interval_ms = group->interval_ms;
+    ctx->rebase = false;
+    ctx->trace_group_id = 0;
+    ctx->num_events = group->num_events;
+    ctx->events = group->events;
     ctx->pkgs_ctx = zhashx_new();
     zhashx_set_destructor(ctx->pkgs_ctx, (zhashx_destructor_fn *) perf_group_pkg_context_destroy);
 
@@ -199,11 +204,19 @@ perf_context_create(struct perf_config *config, zsock_t *pipe, const char *targe
     ctx->cgroup_fd = -1; /* by default, system wide monitoring */
     ctx->groups_ctx = zhashx_new();
     zhashx_set_destructor(ctx->groups_ctx, (zhashx_destructor_fn *) perf_group_context_destroy);
+    ctx->setup_latency_ms = 0;
+    ctx->disabled = false;
+    ctx->enabled_timestamp = 0;
+    ctx->overload_factor = 1;
+    ctx->num_rates = 0;
+    ctx->rates = NULL;
+    ctx->stride = 1;
+    ctx->activity = 0;
 
     return ctx;
 }
 
-static void
+void
 perf_context_destroy(struct perf_context *ctx)
 {
     if (!ctx)
@@ -212,36 +225,32 @@ perf_context_destroy(struct perf_context *ctx)
     zpoller_destroy(&ctx->poller);
     zsock_destroy(&ctx->ticker);
     zsock_destroy(&ctx->reporting);
-    close(ctx->cgroup_fd);
     zhashx_destroy(&ctx->groups_ctx);
+    if (ctx->cgroup_fd >= 0)
+        (*ctx->config->backend->close)(ctx->config->backend, ctx->cgroup_fd);
+    free(ctx->rates);
     free(ctx);
 }
 
 static int
-perf_events_group_setup_cpu(struct perf_context *ctx, struct perf_group_cpu_context *cpu_ctx, struct events_group *group, unsigned long perf_flags, const char *cpu_id)
+perf_events_group_setup_cpu(struct perf_context *ctx, struct perf_group_cpu_context *cpu_ctx, struct perf_group_context *group_ctx, unsigned long perf_flags, int cpu)
 {
     int group_fd = -1;
     int perf_fd;
-    char *cpu_id_endp = NULL;
-    long cpu;
-    struct event_config *event = NULL;
-
-    errno = 0;
-    cpu = strtol(cpu_id, &cpu_id_endp, 0);
-    if (*cpu_id == '\0' || *cpu_id_endp != '\0' || errno) {
-        zsys_error("perf<%s>: failed convert cpu id for group=%s cpu=%s", ctx->target_name, group->name, cpu_id);
-        return -1;
-    }
-    if (cpu > INT_MAX || cpu < INT_MIN) {
-        zsys_error("perf<%s>: cpu id is out of range for group=%s cpu=%s", ctx->target_name, group->name, cpu_id);
-        return -1;
-    }
-
-    for (event = (struct event_config *) zlistx_first(group->events); event; event = (struct event_config *) zlistx_next(group->events)) {
+    int open_errno;
+    size_t event_i;
+    const struct event_config *event = NULL;
+    struct perf_event_attr attr;
+
+    for (event_i = 0; event_i < group_ctx->num_events; event_i++) {
+        event = &group_ctx->events[event_i];
+        attr = event->attr; /* the group config is shared and read-only */
         errno = 0;
-        perf_fd = perf_event_open(&event->attr, ctx->cgroup_fd, (int) cpu, group_fd, perf_flags);
+        perf_fd = (*ctx->config->backend->open_event)(ctx->config->backend, &attr, ctx->cgroup_fd, cpu, group_fd, perf_flags);
         if (perf_fd < 1) {
-            zsys_error("perf<%s>: failed opening perf event for group=%s cpu=%d event=%s errno=%d", ctx->target_name, group->name, (int) cpu, event->name, errno);
+            open_errno = errno;
+            zsys_error("perf<%s>: failed opening perf event for group=%s cpu=%d event=%s errno=%d", ctx->target_name, group_ctx->config->name, cpu, event->name, open_errno);
+            errno = open_errno;
             return -1;
         }
 
@@ -255,31 +264,92 @@ perf_events_group_setup_cpu(struct perf_context *ctx, struct perf_group_cpu_cont
     return 0;
 }
 
+static void
+perf_setup_job_run(struct perf_setup_job *job)
+{
+    job->ret = perf_events_group_setup_cpu(job->ctx, job->cpu_ctx, job->group_ctx, job->perf_flags, job->cpu);
+    job->error = (job->ret) ? errno : 0;
+}
+
+static size_t
+count_setup_jobs_max(struct perf_context *ctx, zhashx_t *events_groups)
+{
+    return zhashx_size(events_groups) * ctx->config->hwinfo->num_cpus;
+}
+
 static int
-perf_events_groups_initialize(struct perf_context *ctx)
+get_cpu_domain(const struct hwinfo_cpu *cpu, enum events_group_monitoring_type type)
 {
-    unsigned long perf_flags = 0;
+    switch (type)
+    {
+        case MONITOR_ONE_CPU_PER_SOCKET:
+        return 0;
+
+        case MONITOR_ONE_CPU_PER_DIE:
+        return cpu->die_id;
+
+        case MONITOR_ONE_CPU_PER_L3:
+        return cpu->l3_id;
+
+        case MONITOR_ONE_CPU_PER_NUMA_NODE:
+        return cpu->node_id;
+
+        default:
+        return cpu->id;
+    }
+}
+
+static bool
+is_cpu_domain_monitored(const struct hwinfo *hwinfo, const struct hwinfo_pkg *pkg, struct perf_group_pkg_context *pkg_ctx, const struct hwinfo_cpu *cpu, enum events_group_monitoring_type type)
+{
+    const struct hwinfo_cpu *other = NULL;
+    int domain = get_cpu_domain(cpu, type);
+
+    if (type == MONITOR_ALL_CPU_PER_SOCKET)
+        return zhashx_lookup(pkg_ctx->cpus_ctx, cpu->id_str) != NULL;
+
+    /* the events of the group are opened on a single cpu of each domain of the package */
+    for (other = hwinfo->cpus + pkg->first_cpu; other < hwinfo->cpus + pkg->first_cpu + pkg->num_cpus; other++) {
+        if (get_cpu_domain(other, type) == domain && zhashx_lookup(pkg_ctx->cpus_ctx, other->id_str))
+            return true;
+    }
+
+    return false;
+}
+
+static int
+perf_events_groups_open(struct perf_context *ctx, zhashx_t *events_groups, size_t *num_opened)
+{
+    unsigned long perf_flags = (ctx->cgroup_fd >= 0) ? PERF_FLAG_PID_CGROUP : 0;
+    zhashx_t *opened_groups_ctx = NULL; /* char *group_name -> struct perf_group_context *group_ctx */
     struct events_group *events_group = NULL;
     const char *events_group_name = NULL;
     struct perf_group_context *group_ctx = NULL;
-    struct hwinfo_pkg *pkg = NULL;
-    const char *pkg_id = NULL;
+    const struct hwinfo *hwinfo = ctx->config->hwinfo;
+    const struct hwinfo_pkg *pkg = NULL;
     struct perf_group_pkg_context *pkg_ctx = NULL;
-    const char *cpu_id = NULL;
+    const struct hwinfo_cpu *cpu = NULL;
     struct perf_group_cpu_context *cpu_ctx = NULL;
+    struct perf_setup_job *jobs = NULL;
+    size_t num_jobs = 0;
+    size_t job_i;
+
+    /* the groups are only stored into the perf context once all their events are opened */
+    opened_groups_ctx = zhashx_new();
+    if (!opened_groups_ctx) {
+        zsys_error("perf<%s>: failed to allocate the opened groups", ctx->target_name);
+        goto error;
+    }
 
-    if (ctx->config->target->cgroup_path) {
-        perf_flags |= PERF_FLAG_PID_CGROUP;
-        errno = 0;
-        ctx->cgroup_fd = open(ctx->config->target->cgroup_path, O_RDONLY); 
-        if (ctx->cgroup_fd < 1) {
-            zsys_error("perf<%s>: cannot open cgroup dir path=%s errno=%d", ctx->target_name, ctx->config->target->cgroup_path, errno);
-            goto error;
-        }
+    jobs = (struct perf_setup_job *) calloc(count_setup_jobs_max(ctx, events_groups), sizeof(struct perf_setup_job));
+    if (!jobs) {
+        zsys_error("perf<%s>: failed to allocate the setup jobs", ctx->target_name);
+        goto error;
     }
 
-    for (events_group = (struct events_group *) zhashx_first(ctx->config->events_groups); events_group; events_group = (struct events_group *) zhashx_next(ctx->config->events_groups)) {
-        events_group_name = (const char *) zhashx_cursor(ctx->config->events_groups);
+    /* create the contexts and gather the events groups to open on each cpu */
+    for (events_group = (struct events_group *) zhashx_first(events_groups); events_group; events_group = (struct events_group *) zhashx_next(events_groups)) {
+        events_group_name = (const char *) zhashx_cursor(events_groups);
 
         /* create group context */
         group_ctx = perf_group_context_create(events_group);
@@ -288,57 +358,288 @@ perf_events_groups_initialize(struct perf_context *ctx)
             goto error;
         }
 
-        for (pkg = (struct hwinfo_pkg *) zhashx_first(ctx->config->hwinfo->pkgs); pkg; pkg = (struct hwinfo_pkg *) zhashx_next(ctx->config->hwinfo->pkgs)) {
-            pkg_id = (const char *) zhashx_cursor(ctx->config->hwinfo->pkgs);
+        if (ctx->config->sampling.trace && trace_writer_define_group(ctx->config->sampling.trace, events_group, &group_ctx->trace_group_id)) {
+            zsys_error("perf<%s>: failed to define the traced group=%s", ctx->target_name, events_group_name);
+            goto error;
+        }
 
+        for (pkg = hwinfo->pkgs; pkg < hwinfo->pkgs + hwinfo->num_pkgs; pkg++) {
             /* create package context */
             pkg_ctx = perf_group_pkg_context_create();
             if (!pkg_ctx) {
-                zsys_error("perf<%s>: failed to create pkg context for group=%s pkg=%s", ctx->target_name, events_group_name, pkg_id);
+                zsys_error("perf<%s>: failed to create pkg context for group=%s pkg=%s", ctx->target_name, events_group_name, pkg->id_str);
                 goto error;
             }
 
-            for (cpu_id = (const char *) zlistx_first(pkg->cpus_id); cpu_id; cpu_id = (const char *) zlistx_next(pkg->cpus_id)) {
+            for (cpu = hwinfo->cpus + pkg->first_cpu; cpu < hwinfo->cpus + pkg->first_cpu + pkg->num_cpus; cpu++) {
+                if (is_cpu_domain_monitored(hwinfo, pkg, pkg_ctx, cpu, events_group->type))
+                    continue;
+
                 /* create cpu context */
-                cpu_ctx = perf_group_cpu_context_create(zlistx_size(events_group->events));
+                cpu_ctx = perf_group_cpu_context_create(ctx->config->backend, events_group->num_events);
                 if (!cpu_ctx) {
-                    zsys_error("perf<%s>: failed to create cpu context for group=%s pkg=%s cpu=%s", ctx->target_name, events_group_name, pkg_id, cpu_id);
+                    zsys_error("perf<%s>: failed to create cpu context for group=%s pkg=%s cpu=%s", ctx->target_name, events_group_name, pkg->id_str, cpu->id_str);
                     goto error;
                 }
 
-                /* open events of the group for the cpu */
-                if (perf_events_group_setup_cpu(ctx, cpu_ctx, events_group, perf_flags, cpu_id)) {
-                    zsys_error("perf<%s>: failed to setup perf for group=%s pkg=%s cpu=%s", ctx->target_name, events_group_name, pkg_id, cpu_id);
-                    goto error;
-                }
+                jobs[num_jobs++] = (struct perf_setup_job){
+                    .ctx = ctx,
+                    .group_ctx = group_ctx,
+                    .pkg_ctx = pkg_ctx,
+                    .cpu_ctx = cpu_ctx,
+                    .pkg_id = pkg->id_str,
+                    .cpu_id = cpu->id_str,
+                    .perf_flags = perf_flags,
+                    .cpu = cpu->id,
+                    .ret = -1,
+                    .error = 0
+                };
 
                 /* store cpu context */
-                zhashx_insert(pkg_ctx->cpus_ctx, cpu_id, cpu_ctx);
-
-                if (events_group->type == MONITOR_ONE_CPU_PER_SOCKET)
-                    break;
+                zhashx_insert(pkg_ctx->cpus_ctx, cpu->id_str, cpu_ctx);
+                cpu_ctx = NULL;
             }
 
             /* store pkg context */
-            zhashx_insert(group_ctx->pkgs_ctx, pkg_id, pkg_ctx);
+            zhashx_insert(group_ctx->pkgs_ctx, pkg->id_str, pkg_ctx);
+            pkg_ctx = NULL;
         }
 
         /* stores per-cpu events fd for group */
-        zhashx_insert(ctx->groups_ctx, events_group_name, group_ctx);
+        zhashx_insert(opened_groups_ctx, events_group_name, group_ctx);
+        group_ctx = NULL;
+    }
+
+    /* open the events of the groups for each cpu concurrently */
+    if (work_pool_run(ctx->config->setup_pool, (work_pool_fn *) perf_setup_job_run, jobs, sizeof(struct perf_setup_job), num_jobs)) {
+        zsys_error("perf<%s>: failed to run the setup jobs", ctx->target_name);
+        goto error;
+    }
+
+    for (job_i = 0; job_i < num_jobs; job_i++) {
+        if (!jobs[job_i].ret)
+            continue;
+
+        /* a cpu brought offline since the topology was detected is monitored again when it is brought back online */
+        if (jobs[job_i].error == ENODEV || jobs[job_i].error == ENXIO) {
+            zsys_warning("perf<%s>: cpu went offline, not monitoring group=%s on pkg=%s cpu=%s", ctx->target_name, jobs[job_i].group_ctx->config->name, jobs[job_i].pkg_id, jobs[job_i].cpu_id);
+            zhashx_delete(jobs[job_i].pkg_ctx->cpus_ctx, jobs[job_i].cpu_id);
+            jobs[job_i].cpu_ctx = NULL;
+            continue;
+        }
+
+        zsys_error("perf<%s>: failed to setup perf for group=%s cpu=%d", ctx->target_name, jobs[job_i].group_ctx->config->name, jobs[job_i].cpu);
+        goto error;
+    }
+
+    /* the replay must not compute the deltas of the reopened events from the samples of the previous ones */
+    for (job_i = 0; job_i < num_jobs; job_i++) {
+        if (!jobs[job_i].cpu_ctx)
+            continue;
+
+        trace_writer_write_reset(ctx->config->sampling.trace, ctx->target_name, jobs[job_i].group_ctx->trace_group_id, jobs[job_i].pkg_id, jobs[job_i].cpu_id);
+        (*num_opened)++;
     }
 
+    /* drop the package contexts left without any monitored cpu */
+    for (group_ctx = (struct perf_group_context *) zhashx_first(opened_groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(opened_groups_ctx)) {
+        for (pkg = hwinfo->pkgs; pkg < hwinfo->pkgs + hwinfo->num_pkgs; pkg++) {
+            pkg_ctx = (struct perf_group_pkg_context *) zhashx_lookup(group_ctx->pkgs_ctx, pkg->id_str);
+            if (pkg_ctx && zhashx_size(pkg_ctx->cpus_ctx) == 0)
+                zhashx_delete(group_ctx->pkgs_ctx, pkg->id_str);
+        }
+    }
+    pkg_ctx = NULL;
+
+    for (group_ctx = (struct perf_group_context *) zhashx_first(opened_groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(opened_groups_ctx)) {
+        zhashx_insert(ctx->groups_ctx, zhashx_cursor(opened_groups_ctx), group_ctx);
+    }
+
+    group_ctx = NULL;
+    zhashx_destroy(&opened_groups_ctx);
+    free(jobs);
     return 0;
 
 error:
-    close(ctx->cgroup_fd);
+    free(jobs);
     perf_group_context_destroy(&group_ctx);
     perf_group_pkg_context_destroy(&pkg_ctx);
     perf_group_cpu_context_destroy(&cpu_ctx);
+    if (opened_groups_ctx) {
+        for (group_ctx = (struct perf_group_context *) zhashx_first(opened_groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(opened_groups_ctx)) {
+            perf_group_context_destroy(&group_ctx);
+        }
+        zhashx_destroy(&opened_groups_ctx);
+    }
     return -1;
 }
 
+static int
+perf_events_groups_initialize(struct perf_context *ctx)
+{
+    size_t num_opened = 0;
+    int64_t setup_start_ms = zclock_mono();
+
+    if (ctx->config->target->cgroup_path) {
+        errno = 0;
+        ctx->cgroup_fd = (*ctx->config->backend->open_cgroup)(ctx->config->backend, ctx->config->target->cgroup_path);
+        if (ctx->cgroup_fd < 1) {
+            zsys_error("perf<%s>: cannot open cgroup dir path=%s errno=%d", ctx->target_name, ctx->config->target->cgroup_path, errno);
+            return -1;
+        }
+    }
+
+    if (perf_events_groups_open(ctx, ctx->config->events_groups, &num_opened))
+        return -1;
+
+    ctx->setup_latency_ms = zclock_mono() - setup_start_ms;
+    zsys_info("perf<%s>: opened %zu events groups in %" PRId64 " ms", ctx->target_name, num_opened, ctx->setup_latency_ms);
+
+    return 0;
+}
+
+static int
+perf_rates_initialize(struct perf_context *ctx)
+{
+    const struct perf_sampling_config *sampling = &ctx->config->sampling;
+    struct perf_group_context *group_ctx = NULL;
+    unsigned int interval_ms;
+    size_t rate_i;
+
+    /* every group of the target can be removed at runtime */
+    if (zhashx_size(ctx->groups_ctx) == 0)
+        return 0;
+
+    ctx->rates = (struct perf_rate_context *) calloc(zhashx_size(ctx->groups_ctx), sizeof(struct perf_rate_context));
+    if (!ctx->rates)
+        return -1;
+
+    for (group_ctx = (struct perf_group_context *) zhashx_first(ctx->groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        interval_ms = (group_ctx->interval_ms) ? group_ctx->interval_ms : sampling->interval_ms;
+        group_ctx->stride = (interval_ms / sampling->tick_ms) ? interval_ms / sampling->tick_ms : 1;
+
+        for (rate_i = 0; rate_i < ctx->num_rates; rate_i++) {
+            if (ctx->rates[rate_i].stride == group_ctx->stride)
+                break;
+        }
+
+        if (rate_i == ctx->num_rates) {
+            ctx->rates[ctx->num_rates++] = (struct perf_rate_context){ .stride = group_ctx->stride, .last_read_timestamp = 0, .last_actual_read_timestamp = 0 };
+        }
+    }
+
+    return 0;
+}
+
+static int
+perf_rates_update(struct perf_context *ctx, const struct perf_rate_context *fresh)
+{
+    struct perf_rate_context *previous_rates = ctx->rates;
+    size_t num_previous_rates = ctx->num_rates;
+    size_t rate_i;
+    size_t previous_rate_i;
+
+    ctx->rates = NULL;
+    ctx->num_rates = 0;
+    if (perf_rates_initialize(ctx)) {
+        free(ctx->rates);
+        ctx->rates = previous_rates;
+        ctx->num_rates = num_previous_rates;
+        return -1;
+    }
+
+    /* the unchanged sampling intervals keep their read timestamps, the new ones start from the given state */
+    for (rate_i = 0; rate_i < ctx->num_rates; rate_i++) {
+        for (previous_rate_i = 0; previous_rate_i < num_previous_rates; previous_rate_i++) {
+            if (previous_rates[previous_rate_i].stride == ctx->rates[rate_i].stride)
+                break;
+        }
+
+        if (previous_rate_i < num_previous_rates) {
+            ctx->rates[rate_i].last_read_timestamp = previous_rates[previous_rate_i].last_read_timestamp;
+            ctx->rates[rate_i].last_actual_read_timestamp = previous_rates[previous_rate_i].last_actual_read_timestamp;
+        }
+        else if (fresh) {
+            ctx->rates[rate_i].last_read_timestamp = fresh->last_read_timestamp;
+            ctx->rates[rate_i].last_actual_read_timestamp = fresh->last_actual_read_timestamp;
+        }
+    }
+
+    free(previous_rates);
+    return 0;
+}
+
+static const struct perf_rate_context *
+perf_rates_lookup(struct perf_context *ctx, unsigned int stride)
+{
+    size_t rate_i;
+
+    for (rate_i = 0; rate_i < ctx->num_rates; rate_i++) {
+        if (ctx->rates[rate_i].stride == stride)
+            return &ctx->rates[rate_i];
+    }
+
+    return NULL;
+}
+
+static void
+perf_rates_reset(struct perf_context *ctx)
+{
+    size_t rate_i;
+
+    for (rate_i = 0; rate_i < ctx->num_rates; rate_i++) {
+        ctx->rates[rate_i].last_read_timestamp = 0;
+    }
+}
+
+static void
+perf_events_group_enable_cpu(struct perf_context *ctx, const char *group_name, const char *pkg_id, const char *cpu_id, struct perf_group_cpu_context *cpu_ctx)
+{
+    const int *group_leader_fd = NULL;
+
+    group_leader_fd = (int *) zlistx_first(cpu_ctx->perf_fds);
+    if (!group_leader_fd) {
+        zsys_error("perf<%s>: no group leader fd for group=%s pkg=%s cpu=%s", ctx->target_name, group_name, pkg_id, cpu_id);
+        return;
+    }
+
+    errno = 0;
+    if ((*ctx->config->backend->control_group)(ctx->config->backend, *group_leader_fd, PERF_EVENT_IOC_RESET))
+        zsys_error("perf<%s>: cannot reset events for group=%s pkg=%s cpu=%s errno=%d", ctx->target_name, group_name, pkg_id, cpu_id, errno);
+
+    errno = 0;
+    if ((*ctx->config->backend->control_group)(ctx->config->backend, *group_leader_fd, PERF_EVENT_IOC_ENABLE))
+        zsys_error("perf<%s>: cannot enable events for group=%s pkg=%s cpu=%s errno=%d", ctx->target_name, group_name, pkg_id, cpu_id, errno);
+}
+
+static void
+perf_events_group_enable(struct perf_context *ctx, const char *group_name, struct perf_group_context *group_ctx)
+{
+    struct perf_group_pkg_context *pkg_ctx = NULL;
+    const char *pkg_id = NULL;
+    struct perf_group_cpu_context *cpu_ctx = NULL;
+
+    for (pkg_ctx = (struct perf_group_pkg_context *) zhashx_first(group_ctx->pkgs_ctx); pkg_ctx; pkg_ctx = (struct perf_group_pkg_context *) zhashx_next(group_ctx->pkgs_ctx)) {
+        pkg_id = (const char *) zhashx_cursor(group_ctx->pkgs_ctx);
+
+        for (cpu_ctx = (struct perf_group_cpu_context *) zhashx_first(pkg_ctx->cpus_ctx); cpu_ctx; cpu_ctx = (struct perf_group_cpu_context *) zhashx_next(pkg_ctx->cpus_ctx)) {
+            perf_events_group_enable_cpu(ctx, group_name, pkg_id, (const char *) zhashx_cursor(pkg_ctx->cpus_ctx), cpu_ctx);
+        }
+    }
+}
+
 static void
 perf_events_groups_enable(struct perf_context *ctx)
+{
+    struct perf_group_context *group_ctx = NULL;
+
+    for (group_ctx = (struct perf_group_context *) zhashx_first(ctx->groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        perf_events_group_enable(ctx, (const char *) zhashx_cursor(ctx->groups_ctx), group_ctx);
+    }
+}
+
+static void
+perf_events_groups_toggle(struct perf_context *ctx, bool enable)
 {
     struct perf_group_context *group_ctx = NULL;
     const char *group_name = NULL;
@@ -357,23 +658,28 @@ perf_events_groups_enable(struct perf_context *ctx)
             for (cpu_ctx = (struct perf_group_cpu_context *) zhashx_first(pkg_ctx->cpus_ctx); cpu_ctx; cpu_ctx = (struct perf_group_cpu_context *) zhashx_next(pkg_ctx->cpus_ctx)) {
                 cpu_id = (const char *) zhashx_cursor(pkg_ctx->cpus_ctx);
                 group_leader_fd = (int *) zlistx_first(cpu_ctx->perf_fds);
-                if (!group_leader_fd) {
-                    zsys_error("perf<%s>: no group leader fd for group=%s pkg=%s cpu=%s", ctx->target_name, group_name, pkg_id, cpu_id);
+                if (!group_leader_fd)
                     continue;
-                }
-
-                errno = 0;
-                if (ioctl(*group_leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP))
-                    zsys_error("perf<%s>: cannot reset events for group=%s pkg=%s cpu=%s errno=%d", ctx->target_name, group_name, pkg_id, cpu_id, errno);
 
+                /* the counters are not reset to keep the continuity with the baseline sample */
                 errno = 0;
-                if (ioctl(*group_leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP))
-                    zsys_error("perf<%s>: cannot enable events for group=%s pkg=%s cpu=%s errno=%d", ctx->target_name, group_name, pkg_id, cpu_id, errno);
+                if ((*ctx->config->backend->control_group)(ctx->config->backend, *group_leader_fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE))
+                    zsys_error("perf<%s>: cannot %s events for group=%s pkg=%s cpu=%s errno=%d", ctx->target_name, enable ? "enable" : "disable", group_name, pkg_id, cpu_id, errno);
             }
         }
     }
 }
 
+static bool
+is_same_cgroup(struct perf_context *ctx)
+{
+    /* system wide monitoring */
+    if (ctx->cgroup_fd < 0)
+        return true;
+
+    return (*ctx->config->backend->is_same_cgroup)(ctx->config->backend, ctx->cgroup_fd, ctx->config->target->cgroup_path);
+}
+
 static int
 perf_events_group_read_cpu(struct perf_group_cpu_context *cpu_ctx)
 {
@@ -383,7 +689,7 @@ perf_events_group_read_cpu(struct perf_group_cpu_context *cpu_ctx)
     if (!group_leader_fd)
         return -1;
 
-    if (read(*group_leader_fd, cpu_ctx->scratch_sample, cpu_ctx->sample_size) != (ssize_t) cpu_ctx->sample_size)
+    if ((*cpu_ctx->backend->read_group)(cpu_ctx->backend, *group_leader_fd, cpu_ctx->scratch_sample, cpu_ctx->sample_size) != (ssize_t) cpu_ctx->sample_size)
         return -1;
 
     return 0;
@@ -399,19 +705,401 @@ perf_group_cpu_context_advance_baseline(struct perf_group_cpu_context *cpu_ctx)
     cpu_ctx->scratch_sample = old_baseline;
 }
 
+static int
+perf_events_group_add(struct perf_context *ctx, struct events_group *events_group)
+{
+    zhashx_t *added_groups = NULL; /* char *group_name -> struct events_group *group */
+    struct events_group *stored_group = NULL;
+    struct perf_group_context *group_ctx = NULL;
+    struct perf_rate_context fresh_rate = {};
+    size_t num_opened = 0;
+
+    if (zhashx_lookup(ctx->config->events_groups, events_group->name)) {
+        zsys_error("perf<%s>: events group=%s is already monitored", ctx->target_name, events_group->name);
+        return -1;
+    }
+
+    /* the config of the actor stores its own copy of the group, referenced by the group context */
+    if (zhashx_insert(ctx->config->events_groups, events_group->name, events_group)) {
+        zsys_error("perf<%s>: failed to store the config of group=%s", ctx->target_name, events_group->name);
+        return -1;
+    }
+
+    stored_group = (struct events_group *) zhashx_lookup(ctx->config->events_groups, events_group->name);
+    added_groups = zhashx_new();
+    if (!added_groups || zhashx_insert(added_groups, stored_group->name, stored_group))
+        goto error;
+
+    /* only the events of the added group are opened, the other groups keep their baseline */
+    if (perf_events_groups_open(ctx, added_groups, &num_opened))
+        goto error;
+
+    group_ctx = (struct perf_group_context *) zhashx_lookup(ctx->groups_ctx, stored_group->name);
+    if (!ctx->disabled)
+        perf_events_group_enable(ctx, stored_group->name, group_ctx);
+
+    /* a new sampling interval covers the time elapsed since the group was enabled */
+    fresh_rate.last_read_timestamp = (uint64_t) zclock_time();
+    fresh_rate.last_actual_read_timestamp = fresh_rate.last_read_timestamp;
+    if (perf_rates_update(ctx, &fresh_rate)) {
+        zsys_error("perf<%s>: failed to update the sampling intervals for group=%s", ctx->target_name, stored_group->name);
+        goto error;
+    }
+
+    zsys_info("perf<%s>: added events group=%s on %zu cpus", ctx->target_name, stored_group->name, num_opened);
+    zhashx_destroy(&added_groups);
+    return 0;
+
+error:
+    zhashx_destroy(&added_groups);
+    zhashx_delete(ctx->groups_ctx, events_group->name);
+    zhashx_delete(ctx->config->events_groups, events_group->name);
+    return -1;
+}
+
+static int
+perf_events_group_remove(struct perf_context *ctx, const char *group_name)
+{
+    if (!zhashx_lookup(ctx->groups_ctx, group_name)) {
+        zsys_error("perf<%s>: events group=%s is not monitored", ctx->target_name, group_name);
+        return -1;
+    }
+
+    /* closing the events of the group does not affect the baseline of the other groups */
+    zhashx_delete(ctx->groups_ctx, group_name);
+    zhashx_delete(ctx->config->events_groups, group_name);
+
+    if (perf_rates_update(ctx, NULL)) {
+        zsys_error("perf<%s>: failed to update the sampling intervals after removing group=%s", ctx->target_name, group_name);
+        return -1;
+    }
+
+    zsys_info("perf<%s>: removed events group=%s", ctx->target_name, group_name);
+    return 0;
+}
+
+static int
+perf_events_group_set_interval(struct perf_context *ctx, const char *group_name, unsigned int interval_ms)
+{
+    struct perf_group_context *group_ctx = NULL;
+    const struct perf_group_context *other_group_ctx = NULL;
+    const struct perf_rate_context *rate = NULL;
+    struct perf_rate_context previous_rate = {};
+    unsigned int previous_interval_ms;
+    unsigned int previous_stride;
+
+    group_ctx = (struct perf_group_context *) zhashx_lookup(ctx->groups_ctx, group_name);
+    if (!group_ctx) {
+        zsys_error("perf<%s>: events group=%s is not monitored", ctx->target_name, group_name);
+        return -1;
+    }
+
+    /* the baseline of the group was taken at the last read of its previous sampling interval */
+    rate = perf_rates_lookup(ctx, group_ctx->stride);
+    if (rate)
+        previous_rate = *rate;
+
+    /* the config of the group is shared with the other actors, the interval is only changed in the group context */
+    previous_interval_ms = group_ctx->interval_ms;
+    previous_stride = group_ctx->stride;
+    group_ctx->interval_ms = interval_ms;
+    if (perf_rates_update(ctx, &previous_rate)) {
+        zsys_error("perf<%s>: failed to update the sampling intervals for group=%s", ctx->target_name, group_name);
+        group_ctx->interval_ms = previous_interval_ms;
+        return -1;
+    }
+
+    /* a group joining the rate of other groups inherits its last read timestamp, not the one of its baselines */
+    for (other_group_ctx = (const struct perf_group_context *) zhashx_first(ctx->groups_ctx); other_group_ctx && group_ctx->stride != previous_stride; other_group_ctx = (const struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        if (other_group_ctx != group_ctx && other_group_ctx->stride == group_ctx->stride)
+            group_ctx->rebase = true;
+    }
+
+    zsys_info("perf<%s>: events group=%s is now read every %u ticks", ctx->target_name, group_name, group_ctx->stride);
+    return 0;
+}
+
+static int
+perf_sampling_set_interval(struct perf_context *ctx, unsigned int interval_ms)
+{
+    struct perf_group_context *group_ctx = NULL;
+    const struct perf_rate_context *rate = NULL;
+    struct perf_rate_context previous_rate = {};
+    unsigned int previous_interval_ms = ctx->config->sampling.interval_ms;
+
+    /* the groups without their own sampling interval share the rate of the sampling interval of the sensor */
+    for (group_ctx = (struct perf_group_context *) zhashx_first(ctx->groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        if (group_ctx->interval_ms == 0) {
+            rate = perf_rates_lookup(ctx, group_ctx->stride);
+            break;
+        }
+    }
+
+    if (rate)
+        previous_rate = *rate;
+
+    ctx->config->sampling.interval_ms = interval_ms;
+    if (perf_rates_update(ctx, &previous_rate)) {
+        zsys_error("perf<%s>: failed to update the sampling intervals", ctx->target_name);
+        ctx->config->sampling.interval_ms = previous_interval_ms;
+        return -1;
+    }
+
+    zsys_info("perf<%s>: sampling interval set to %u ms", ctx->target_name, interval_ms);
+    return 0;
+}
+
+static size_t
+perf_topology_close_cpus(struct perf_context *ctx, const struct hwinfo *hwinfo)
+{
+    const struct hwinfo *previous = ctx->config->hwinfo;
+    struct perf_group_context *group_ctx = NULL;
+    const struct hwinfo_pkg *pkg = NULL;
+    struct perf_group_pkg_context *pkg_ctx = NULL;
+    const struct hwinfo_cpu *cpu = NULL;
+    size_t num_closed = 0;
+
+    for (group_ctx = (struct perf_group_context *) zhashx_first(ctx->groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        for (pkg = previous->pkgs; pkg < previous->pkgs + previous->num_pkgs; pkg++) {
+            pkg_ctx = (struct perf_group_pkg_context *) zhashx_lookup(group_ctx->pkgs_ctx, pkg->id_str);
+            if (!pkg_ctx)
+                continue;
+
+            for (cpu = previous->cpus + pkg->first_cpu; cpu < previous->cpus + pkg->first_cpu + pkg->num_cpus; cpu++) {
+                if (hwinfo_has_cpu(hwinfo, pkg->id, cpu->id) || !zhashx_lookup(pkg_ctx->cpus_ctx, cpu->id_str))
+                    continue;
+
+                zhashx_delete(pkg_ctx->cpus_ctx, cpu->id_str);
+                num_closed++;
+            }
+
+            /* the package context is recreated when one of its cpus is brought back online */
+            if (zhashx_size(pkg_ctx->cpus_ctx) == 0)
+                zhashx_delete(group_ctx->pkgs_ctx, pkg->id_str);
+        }
+    }
+
+    return num_closed;
+}
+
+static int
+perf_topology_open_cpus(struct perf_context *ctx, const struct hwinfo *hwinfo, size_t *num_opened)
+{
+    unsigned long perf_flags = (ctx->cgroup_fd >= 0) ? PERF_FLAG_PID_CGROUP : 0;
+    struct perf_group_context *group_ctx = NULL;
+    const struct hwinfo_pkg *pkg = NULL;
+    struct perf_group_pkg_context *pkg_ctx = NULL;
+    const struct hwinfo_cpu *cpu = NULL;
+    struct perf_group_cpu_context *cpu_ctx = NULL;
+    struct perf_setup_job *jobs = NULL;
+    struct perf_setup_job *job = NULL;
+    size_t num_jobs = 0;
+    size_t job_i;
+    int ret = -1;
+
+    jobs = (struct perf_setup_job *) calloc(zhashx_size(ctx->groups_ctx) * hwinfo->num_cpus, sizeof(struct perf_setup_job));
+    if (!jobs) {
+        zsys_error("perf<%s>: failed to allocate the setup jobs", ctx->target_name);
+        return -1;
+    }
+
+    /* gather the groups to open on the cpus that are not monitored yet */
+    for (group_ctx = (struct perf_group_context *) zhashx_first(ctx->groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        for (pkg = hwinfo->pkgs; pkg < hwinfo->pkgs + hwinfo->num_pkgs; pkg++) {
+            pkg_ctx = (struct perf_group_pkg_context *) zhashx_lookup(group_ctx->pkgs_ctx, pkg->id_str);
+            if (!pkg_ctx) {
+                pkg_ctx = perf_group_pkg_context_create();
+                if (!pkg_ctx) {
+                    zsys_error("perf<%s>: failed to create pkg context for group=%s pkg=%s", ctx->target_name, group_ctx->config->name, pkg->id_str);
+                    goto cleanup;
+                }
+                zhashx_insert(group_ctx->pkgs_ctx, pkg->id_str, pkg_ctx);
+            }
+
+            for (cpu = hwinfo->cpus + pkg->first_cpu; cpu < hwinfo->cpus + pkg->first_cpu + pkg->num_cpus; cpu++) {
+                /* the domain of a cpu brought offline is monitored by another of its cpus */
+                if (is_cpu_domain_monitored(hwinfo, pkg, pkg_ctx, cpu, group_ctx->config->type))
+                    continue;
+
+                cpu_ctx = perf_group_cpu_context_create(ctx->config->backend, group_ctx->num_events);
+                if (!cpu_ctx) {
+                    zsys_error("perf<%s>: failed to create cpu context for group=%s pkg=%s cpu=%s", ctx->target_name, group_ctx->config->name, pkg->id_str, cpu->id_str);
+                    goto cleanup;
+                }
+
+                jobs[num_jobs++] = (struct perf_setup_job){
+                    .ctx = ctx,
+                    .group_ctx = group_ctx,
+                    .pkg_ctx = pkg_ctx,
+                    .cpu_ctx = cpu_ctx,
+                    .pkg_id = pkg->id_str,
+                    .cpu_id = cpu->id_str,
+                    .perf_flags = perf_flags,
+                    .cpu = cpu->id,
+                    .ret = -1,
+                    .error = 0
+                };
+
+                /* the context is stored before its events are opened to monitor a single cpu per domain */
+                zhashx_insert(pkg_ctx->cpus_ctx, cpu->id_str, cpu_ctx);
+                cpu_ctx = NULL;
+            }
+        }
+    }
+
+    if (work_pool_run(ctx->config->setup_pool, (work_pool_fn *) perf_setup_job_run, jobs, sizeof(struct perf_setup_job), num_jobs)) {
+        zsys_error("perf<%s>: failed to run the setup jobs", ctx->target_name);
+        goto cleanup;
+    }
+
+    /* a cpu that cannot be monitored does not prevent the monitoring of the other ones */
+    for (job_i = 0; job_i < num_jobs; job_i++) {
+        job = &jobs[job_i];
+        if (job->ret) {
+            zsys_warning("perf<%s>: cannot monitor group=%s on pkg=%s cpu=%s", ctx->target_name, job->group_ctx->config->name, job->pkg_id, job->cpu_id);
+            continue;
+        }
+
+        trace_writer_write_reset(ctx->config->sampling.trace, ctx->target_name, job->group_ctx->trace_group_id, job->pkg_id, job->cpu_id);
+        if (!ctx->disabled)
+            perf_events_group_enable_cpu(ctx, job->group_ctx->config->name, job->pkg_id, job->cpu_id, job->cpu_ctx);
+
+        job->cpu_ctx = NULL;
+        (*num_opened)++;
+    }
+
+    ret = 0;
+
+cleanup:
+    /* close the events of the cpus that cannot be monitored */
+    for (job_i = 0; job_i < num_jobs; job_i++) {
+        if (jobs[job_i].cpu_ctx)
+            zhashx_delete(jobs[job_i].pkg_ctx->cpus_ctx, jobs[job_i].cpu_id);
+    }
+    perf_group_cpu_context_destroy(&cpu_ctx);
+    free(jobs);
+
+    /* drop the package contexts left without any monitored cpu */
+    for (group_ctx = (struct perf_group_context *) zhashx_first(ctx->groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        for (pkg = hwinfo->pkgs; pkg < hwinfo->pkgs + hwinfo->num_pkgs; pkg++) {
+            pkg_ctx = (struct perf_group_pkg_context *) zhashx_lookup(group_ctx->pkgs_ctx, pkg->id_str);
+            if (pkg_ctx && zhashx_size(pkg_ctx->cpus_ctx) == 0)
+                zhashx_delete(group_ctx->pkgs_ctx, pkg->id_str);
+        }
+    }
+
+    return ret;
+}
+
+static int
+perf_topology_update(struct perf_context *ctx, struct hwinfo *hwinfo)
+{
+    size_t num_closed;
+    size_t num_opened = 0;
+    int ret = 0;
+
+    /* only the events of the cpus brought online or offline are opened or closed, the other cpus keep their baseline */
+    num_closed = perf_topology_close_cpus(ctx, hwinfo);
+    if (perf_topology_open_cpus(ctx, hwinfo, &num_opened)) {
+        zsys_error("perf<%s>: failed to open the events groups on the new cpus", ctx->target_name);
+        ret = -1;
+    }
+
+    /* the events groups added later are opened on the cpus of the new topology */
+    hwinfo_destroy(ctx->config->hwinfo);
+    ctx->config->hwinfo = hwinfo_ref(hwinfo);
+
+    zsys_info("perf<%s>: topology updated, %zu events groups opened and %zu closed", ctx->target_name, num_opened, num_closed);
+    return ret;
+}
+
 static void
 handle_pipe(struct perf_context *ctx)
 {
-    char *command = zstr_recv(ctx->pipe);
-    
-    if (streq(command, "$TERM")) {
+    zmsg_t *msg = zmsg_recv(ctx->pipe);
+    char *command = NULL;
+    zframe_t *group_frame = NULL;
+    struct events_group *events_group = NULL;
+    zframe_t *topology_frame = NULL;
+    struct hwinfo *hwinfo = NULL;
+    char *group_name = NULL;
+    char *interval = NULL;
+    unsigned int interval_ms = 0;
+
+    if (!msg)
+        return;
+
+    command = zmsg_popstr(msg);
+    if (!command) {
+        zsys_error("perf<%s>: empty pipe command", ctx->target_name);
+    }
+    else if (streq(command, "$TERM")) {
         ctx->terminated = true;
         zsys_info("perf<%s>: shutting down actor", ctx->target_name);
     }
+    else if (streq(command, "DISABLE")) {
+        if (!ctx->disabled) {
+            perf_events_groups_toggle(ctx, false);
+            ctx->disabled = true;
+            zsys_info("perf<%s>: target departed, monitoring suspended", ctx->target_name);
+        }
+    }
+    else if (streq(command, "ENABLE")) {
+        /* a cgroup recreated with the same path cannot be monitored with the events opened for the previous one */
+        if (!is_same_cgroup(ctx)) {
+            zsys_info("perf<%s>: target was recreated, cannot resume monitoring", ctx->target_name);
+            zsock_signal(ctx->pipe, 1);
+        }
+        else {
+            if (ctx->disabled) {
+                perf_events_groups_toggle(ctx, true);
+                ctx->enabled_timestamp = (uint64_t) zclock_time();
+                ctx->disabled = false;
+                ctx->setup_latency_ms = 0;
+                perf_rates_reset(ctx);
+                zsys_info("perf<%s>: target reappeared, monitoring resumed", ctx->target_name);
+            }
+            zsock_signal(ctx->pipe, 0);
+        }
+    }
+    else if (streq(command, "ADD-GROUP")) {
+        /* the group is sent by pointer, the sender keeps its ownership until the reply */
+        group_frame = zmsg_pop(msg);
+        if (group_frame && zframe_size(group_frame) == sizeof(events_group))
+            memcpy(&events_group, zframe_data(group_frame), sizeof(events_group));
+
+        zsock_signal(ctx->pipe, (events_group && !perf_events_group_add(ctx, events_group)) ? 0 : 1);
+    }
+    else if (streq(command, "REMOVE-GROUP")) {
+        group_name = zmsg_popstr(msg);
+        zsock_signal(ctx->pipe, (group_name && !perf_events_group_remove(ctx, group_name)) ? 0 : 1);
+    }
+    else if (streq(command, "SET-INTERVAL")) {
+        group_name = zmsg_popstr(msg);
+        interval = zmsg_popstr(msg);
+        zsock_signal(ctx->pipe, (group_name && interval && !str_to_uint(interval, &interval_ms) && !perf_events_group_set_interval(ctx, group_name, interval_ms)) ? 0 : 1);
+    }
+    else if (streq(command, "SET-TOPOLOGY")) {
+        /* the topology is sent by pointer, the sender keeps its reference until the reply */
+        topology_frame = zmsg_pop(msg);
+        if (topology_frame && zframe_size(topology_frame) == sizeof(hwinfo))
+            memcpy(&hwinfo, zframe_data(topology_frame), sizeof(hwinfo));
+
+        zsock_signal(ctx->pipe, (hwinfo && !perf_topology_update(ctx, hwinfo)) ? 0 : 1);
+    }
+    else if (streq(command, "SET-SAMPLING-INTERVAL")) {
+        interval = zmsg_popstr(msg);
+        zsock_signal(ctx->pipe, (interval && !str_to_uint(interval, &interval_ms) && !perf_sampling_set_interval(ctx, interval_ms)) ? 0 : 1);
+    }
     else
         zsys_error("perf<%s>: invalid pipe command: %s", ctx->target_name, command);
 
+    zframe_destroy(&group_frame);
+    zframe_destroy(&topology_frame);
+    zstr_free(&group_name);
+    zstr_free(&interval);
     zstr_free(&command);
+    zmsg_destroy(&msg);
 }
 
 #if 0
@@ -422,12 +1110,9 @@ compute_perf_multiplexing_ratio(struct perf_read_format *report)
 }
 #endif
 
-static int
-payload_cpu_data_insert_delta(struct payload_cpu_data *cpu_data, struct events_group *group, struct perf_group_cpu_context *cpu_ctx)
+int
+payload_cpu_data_insert_delta(struct payload_cpu_data *cpu_data, struct events_group *group, const struct perf_read_format *current, const struct perf_read_format *previous)
 {
-    const struct perf_read_format *current = cpu_ctx->baseline_sample;
-    const struct perf_read_format *previous = cpu_ctx->scratch_sample;
-    struct event_config *event = NULL;
     uint64_t delta_time_enabled = 0;
     uint64_t delta_time_running = 0;
     uint64_t delta_event_value = 0;
@@ -441,17 +1126,17 @@ payload_cpu_data_insert_delta(struct payload_cpu_data *cpu_data, struct events_g
     if (zhashx_insert(cpu_data->events, "time_running", &delta_time_running))
         return -1;
 
-    for (event = (struct event_config *) zlistx_first(group->events), event_i = 0; event; event = (struct event_config *) zlistx_next(group->events), event_i++) {
+    for (event_i = 0; event_i < group->num_events; event_i++) {
         delta_event_value = current->values[event_i].value - previous->values[event_i].value;
-        if (zhashx_insert(cpu_data->events, event->name, &delta_event_value))
+        if (zhashx_insert(cpu_data->events, group->events[event_i].name, &delta_event_value))
             return -1;
     }
 
     return 0;
 }
 
-static int
-populate_payload(struct perf_context *ctx, struct payload *payload)
+int
+perf_populate_payload(struct perf_context *ctx, struct payload *payload, unsigned int stride, uint64_t *activity)
 {
     struct perf_group_context *group_ctx = NULL;
     const char *group_name = NULL;
@@ -462,9 +1147,16 @@ populate_payload(struct perf_context *ctx, struct payload *payload)
     struct perf_group_cpu_context *cpu_ctx = NULL;
     const char *cpu_id = NULL;
     struct payload_cpu_data *cpu_data = NULL;
+    uint64_t group_activity;
     // double perf_multiplexing_ratio;
 
+    *activity = 0;
+
     for (group_ctx = (struct perf_group_context *) zhashx_first(ctx->groups_ctx); group_ctx; group_ctx = (struct perf_group_context *) zhashx_next(ctx->groups_ctx)) {
+        /* only read the groups sharing the requested sampling interval */
+        if (group_ctx->stride != stride)
+            continue;
+
         group_name = (const char *) zhashx_cursor(ctx->groups_ctx);
         group_data = payload_group_data_create();
         if (!group_data) {
@@ -472,6 +1164,8 @@ populate_payload(struct perf_context *ctx, struct payload *payload)
             goto error;
         }
 
+        group_activity = 0;
+
         for (pkg_ctx = (struct perf_group_pkg_context *) zhashx_first(group_ctx->pkgs_ctx); pkg_ctx; pkg_ctx = (struct perf_group_pkg_context *) zhashx_next(group_ctx->pkgs_ctx)) {
             pkg_id = (const char *) zhashx_cursor(group_ctx->pkgs_ctx);
             pkg_data = payload_pkg_data_create();
@@ -488,13 +1182,31 @@ populate_payload(struct perf_context *ctx, struct payload *payload)
                     goto error;
                 }
 
+                /* the cpu is left out of the payload, only the first failure of a series is reported */
                 if (perf_events_group_read_cpu(cpu_ctx)) {
-                    zsys_error("perf<%s>: cannot read perf values for group=%s pkg=%s cpu=%s", ctx->target_name, group_name, pkg_id, cpu_id);
-                    goto error;
+                    if (!cpu_ctx->stale)
+                        zsys_warning("perf<%s>: cannot read perf values for group=%s pkg=%s cpu=%s", ctx->target_name, group_name, pkg_id, cpu_id);
+                    cpu_ctx->stale = true;
+                    payload->partial = true;
+                    payload_cpu_data_destroy(&cpu_data);
+                    continue;
                 }
 
                 perf_group_cpu_context_advance_baseline(cpu_ctx);
 
+                /* the delta since the baseline kept by a failed read (or of a group joining a rate) does not cover the interval, it only renews the baseline */
+                if (cpu_ctx->stale || group_ctx->rebase) {
+                    if (cpu_ctx->stale)
+                        zsys_info("perf<%s>: perf values can be read again for group=%s pkg=%s cpu=%s", ctx->target_name, group_name, pkg_id, cpu_id);
+                    trace_writer_write_baseline(ctx->config->sampling.trace, ctx->target_name, group_ctx->trace_group_id, pkg_id, cpu_id, cpu_ctx->baseline_sample);
+                    cpu_ctx->stale = false;
+                    payload->partial = true;
+                    payload_cpu_data_destroy(&cpu_data);
+                    continue;
+                }
+
+                group_activity += cpu_ctx->baseline_sample->values[0].value - cpu_ctx->scratch_sample->values[0].value;
+
 #if 0
                 /* warn if PMU multiplexing is happening */
                 perf_multiplexing_ratio = compute_perf_multiplexing_ratio(cpu_ctx->baseline_sample);
@@ -503,7 +1215,9 @@ populate_payload(struct perf_context *ctx, struct payload *payload)
                 }
 #endif
 
-                if (payload_cpu_data_insert_delta(cpu_data, group_ctx->config, cpu_ctx)) {
+                trace_writer_write_sample(ctx->config->sampling.trace, ctx->target_name, group_ctx->trace_group_id, pkg_id, cpu_id, cpu_ctx->baseline_sample);
+
+                if (payload_cpu_data_insert_delta(cpu_data, group_ctx->config, cpu_ctx->baseline_sample, cpu_ctx->scratch_sample)) {
                     zsys_error("perf<%s>: failed to store perf values for group=%s pkg=%s cpu=%s", ctx->target_name, group_name, pkg_id, cpu_id);
                     goto error;
                 }
@@ -530,6 +1244,10 @@ populate_payload(struct perf_context *ctx, struct payload *payload)
         }
 
         group_data = NULL;
+        group_ctx->rebase = false;
+
+        if (group_activity > *activity)
+            *activity = group_activity;
     }
 
     return 0;
@@ -542,30 +1260,140 @@ error:
 }
 
 static void
-handle_ticker(struct perf_context *ctx)
+update_sampling_stride(struct perf_context *ctx)
 {
-    uint64_t timestamp;
+    const struct perf_sampling_config *sampling = &ctx->config->sampling;
+    unsigned int stride = ctx->stride;
+
+    /* the system wide monitoring is always sampled at the configured intervals */
+    if (sampling->activity_threshold == 0 || ctx->config->target->type != TARGET_TYPE_CGROUP)
+        return;
+
+    /* slow down the sampling of an idle target, and go back to the configured intervals as soon as it is active */
+    if (ctx->activity < sampling->activity_threshold)
+        stride = (ctx->stride * 2 < sampling->max_stride) ? ctx->stride * 2 : sampling->max_stride;
+    else
+        stride = 1;
+
+    if (stride != ctx->stride) {
+        zsys_debug("perf<%s>: sampling intervals multiplied by %u (activity=%lu)", ctx->target_name, stride, ctx->activity);
+        ctx->stride = stride;
+    }
+}
+
+static void
+handle_rate_tick(struct perf_context *ctx, struct perf_rate_context *rate, uint64_t timestamp)
+{
+    const struct perf_sampling_config *sampling = &ctx->config->sampling;
     struct payload *payload = NULL;
-    
-    /* get tick timestamp */
-    zsock_recv(ctx->ticker, "s8", NULL, &timestamp);
+    uint64_t activity = 0;
+    int64_t read_start_ms;
 
     payload = payload_create(timestamp, ctx->target_name);
-    if (!payload) {
+    if (!payload || payload_set_target_metadata(payload, ctx->config->target->namespace_name, ctx->config->target->pod_name, ctx->config->target->container_name)) {
         zsys_error("perf<%s>: failed to allocate payload for timestamp=%lu", ctx->target_name, timestamp);
+        payload_destroy(payload);
         return;
     }
 
-    if (populate_payload(ctx, payload)) {
+    read_start_ms = zclock_mono();
+    payload->read_timestamp = (uint64_t) zclock_time();
+    if (perf_populate_payload(ctx, payload, rate->stride, &activity)) {
         zsys_error("perf<%s>: failed to populate payload for timestamp=%lu", ctx->target_name, timestamp);
+        trace_writer_write_discard(sampling->trace, ctx->target_name);
         payload_destroy(payload);
         return;
     }
 
+    overload_monitor_report_read_latency(sampling->overload, (uint64_t) (zclock_mono() - read_start_ms));
+
+    /* the events were (re)enabled since the previous read, it does not cover a whole sampling interval */
+    if (!rate->last_read_timestamp) {
+        payload->partial = true;
+        payload->setup_latency_ms = (uint64_t) ctx->setup_latency_ms;
+        payload->interval_ms = (uint64_t) rate->stride * ctx->stride * ctx->overload_factor * sampling->tick_ms;
+        payload->interval_start_timestamp = ctx->enabled_timestamp;
+    }
+    else {
+        payload->interval_ms = timestamp - rate->last_read_timestamp;
+        payload->interval_start_timestamp = rate->last_actual_read_timestamp;
+    }
+    payload->overload_factor = ctx->overload_factor;
+    rate->last_read_timestamp = timestamp;
+    rate->last_actual_read_timestamp = payload->read_timestamp;
+
+    /* normalize the activity to the sampling interval of the sensor */
+    activity = (payload->interval_ms) ? activity * sampling->interval_ms / payload->interval_ms : activity;
+    if (activity > ctx->activity)
+        ctx->activity = activity;
+
+    trace_writer_write_payload(sampling->trace, payload);
+
     /* send payload to reporting socket */
+    overload_monitor_payload_queued(sampling->overload);
     zsock_send(ctx->reporting, "p", payload);
 }
 
+static void
+handle_ticker(struct perf_context *ctx)
+{
+    uint64_t timestamp;
+    uint64_t tick;
+    size_t rate_i;
+    bool has_read = false;
+    
+    /* get tick timestamp, index and overload factor */
+    zsock_recv(ctx->ticker, "s884", NULL, &timestamp, &tick, &ctx->overload_factor);
+
+    if (ctx->disabled)
+        return;
+
+    ctx->activity = 0;
+
+    /* read the groups whose sampling interval is over, at a slower rate for an idle target or an overloaded sensor */
+    for (rate_i = 0; rate_i < ctx->num_rates; rate_i++) {
+        if (tick % ((uint64_t) ctx->rates[rate_i].stride * ctx->stride * ctx->overload_factor))
+            continue;
+
+        handle_rate_tick(ctx, &ctx->rates[rate_i], timestamp);
+        has_read = true;
+    }
+
+    if (has_read)
+        update_sampling_stride(ctx);
+}
+
+struct perf_context *
+perf_context_open(struct perf_config *config, zsock_t *pipe, const char *target_name)
+{
+    struct perf_context *ctx = NULL;
+
+    ctx = perf_context_create(config, pipe, target_name);
+    if (!ctx) {
+        zsys_error("perf<%s>: cannot create perf context", target_name);
+        return NULL;
+    }
+
+    if (perf_events_groups_initialize(ctx)) {
+        zsys_error("perf<%s>: cannot initialize perf monitoring", target_name);
+        goto error;
+    }
+
+    if (perf_rates_initialize(ctx)) {
+        zsys_error("perf<%s>: cannot initialize the sampling intervals", target_name);
+        goto error;
+    }
+
+    perf_events_groups_enable(ctx);
+    ctx->enabled_timestamp = (uint64_t) zclock_time();
+
+    return ctx;
+
+error:
+    perf_context_destroy(ctx);
+    return NULL;
+}
+
 void
 perf_monitoring_actor(zsock_t *pipe, void *args)
 {
@@ -582,18 +1410,9 @@ perf_monitoring_actor(zsock_t *pipe, void *args)
         goto cleanup;
     }
 
-    ctx = perf_context_create((struct perf_config *) args, pipe, target_name);
-    if (!ctx) {
-        zsys_error("perf<%s>: cannot create perf context", target_name);
-        goto cleanup;
-    }
-
-    if (perf_events_groups_initialize(ctx)) {
-        zsys_error("perf<%s>: cannot initialize perf monitoring", target_name);
+    ctx = perf_context_open(config, pipe, target_name);
+    if (!ctx)
         goto cleanup;
-    }
-
-    perf_events_groups_enable(ctx);
 
     zsys_info("perf<%s>: monitoring actor started", target_name);
 
@@ -611,8 +1430,8 @@ perf_monitoring_actor(zsock_t *pipe, void *args)
 
 cleanup:
     free(target_name);
-    perf_config_destroy(config);
     perf_context_destroy(ctx);
+    perf_config_destroy(config);
 }
 
 int
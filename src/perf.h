@@ -35,6 +35,24 @@
 #include <czmq.h>
 #include "hwinfo.h"
 #include "events.h"
+#include "work_pool.h"
+#include "overload.h"
+#include "perf_backend.h"
+#include "payload.h"
+#include "trace.h"
+
+/*
+ * perf_sampling_config stores the sampling rate configuration of a perf actor.
+ */
+struct perf_sampling_config
+{
+    unsigned int tick_ms; /* period of the ticker, divides every sampling interval */
+    unsigned int interval_ms; /* sampling interval of the groups not having their own */
+    unsigned int activity_threshold; /* group leader events per base interval under which a target is idle, 0 to disable */
+    unsigned int max_stride; /* maximum multiple of the base interval used to sample an idle target */
+    struct overload_monitor *overload; /* shared load indicators of the sensor, NULL to disable */
+    struct trace_writer *trace; /* capture of the raw samples read, NULL to disable */
+};
 
 /*
  * perf_config stores the configuration of a perf actor.
@@ -44,6 +62,9 @@ struct perf_config
     struct hwinfo *hwinfo;
     zhashx_t *events_groups; /* char *group_name -> struct events_group *group_config */
     struct target *target;
+    struct perf_backend *backend; /* provider of the events counters, shared by the perf actors */
+    struct work_pool *setup_pool; /* shared pool used to open the perf events, NULL to open them sequentially */
+    struct perf_sampling_config sampling;
 };
 
 /*
@@ -68,10 +89,12 @@ struct perf_read_format {
  */
 struct perf_group_cpu_context
 {
+    struct perf_backend *backend;
     zlistx_t *perf_fds; /* int *fd */
     size_t sample_size;
     struct perf_read_format *baseline_sample;
     struct perf_read_format *scratch_sample;
+    bool stale; /* the last read failed, the baseline does not date from the previous interval */
 };
 
 /*
@@ -88,9 +111,25 @@ struct perf_group_pkg_context
 struct perf_group_context
 {
     struct events_group *config;
+    size_t num_events;
+    const struct event_config *events; /* events of the shared group config, iterated concurrently by the setup workers */
+    unsigned int interval_ms; /* sampling interval of the group, 0 to use the sampling interval of the actor */
+    unsigned int stride; /* number of ticks between two reads of the group */
+    bool rebase; /* the baselines do not date from the last read of the rate, the next read only renews them */
+    uint64_t trace_group_id; /* identifier of the group in the captured trace */
     zhashx_t *pkgs_ctx; /* char *pkg_id -> struct perf_group_pkg_context *pkg_ctx */
 };
 
+/*
+ * perf_rate_context stores the state of the groups sharing a sampling interval.
+ */
+struct perf_rate_context
+{
+    unsigned int stride; /* number of ticks between two reads of the groups */
+    uint64_t last_read_timestamp; /* 0 if the groups were not read since the events were (re)enabled */
+    uint64_t last_actual_read_timestamp;
+};
+
 /*
  * perf_context stores the context of a perf actor.
  */
@@ -105,20 +144,73 @@ struct perf_context
     zsock_t *reporting;
     int cgroup_fd;
     zhashx_t *groups_ctx; /* char *group_name -> struct perf_group_context *group_ctx */
+    int64_t setup_latency_ms; /* time spent opening the perf events */
+    bool disabled; /* events are disabled while the target is departed */
+    uint64_t enabled_timestamp; /* time at which the events were (re)enabled */
+    unsigned int overload_factor; /* multiple of the sampling intervals applied while the sensor is overloaded */
+    size_t num_rates;
+    struct perf_rate_context *rates; /* distinct sampling intervals of the groups */
+    unsigned int stride; /* multiple of the groups sampling intervals applied to an idle target */
+    uint64_t activity; /* maximum over the groups read during the last tick of the group leader events per sampling interval */
+};
+
+/*
+ * perf_setup_job stores the parameters and result of the opening of an events group on a cpu.
+ */
+struct perf_setup_job
+{
+    struct perf_context *ctx;
+    struct perf_group_context *group_ctx;
+    struct perf_group_pkg_context *pkg_ctx; /* package context storing the cpu context */
+    struct perf_group_cpu_context *cpu_ctx;
+    const char *pkg_id;
+    const char *cpu_id;
+    unsigned long perf_flags;
+    int cpu;
+    int ret;
+    int error; /* errno of the failed setup */
 };
 
 /*
  * perf_config_create allocate and configure a perf configuration structure.
  */
-struct perf_config *perf_config_create(struct hwinfo *hwinfo, zhashx_t *events_groups, struct target *target);
+struct perf_config *perf_config_create(struct hwinfo *hwinfo, zhashx_t *events_groups, struct target *target, struct perf_backend *backend, struct work_pool *setup_pool, const struct perf_sampling_config *sampling);
 
 /*
  * perf_config_destroy free the resources allocated for the perf configuration structure.
  */
 void perf_config_destroy(struct perf_config *config);
 
+/*
+ * perf_context_open creates a perf context, opens the events of its groups on every cpu and enables them.
+ * The pipe is NULL when the context is not owned by a perf actor, the config must outlive the context.
+ */
+struct perf_context *perf_context_open(struct perf_config *config, zsock_t *pipe, const char *target_name);
+
+/*
+ * payload_cpu_data_insert_delta stores the difference between the current and previous samples of the group into the cpu data.
+ */
+int payload_cpu_data_insert_delta(struct payload_cpu_data *cpu_data, struct events_group *group, const struct perf_read_format *current, const struct perf_read_format *previous);
+
+/*
+ * perf_populate_payload reads the events of the groups having the given stride and stores their delta into the payload.
+ * The activity is set to the maximum over the groups of the group leader events delta.
+ */
+int perf_populate_payload(struct perf_context *ctx, struct payload *payload, unsigned int stride, uint64_t *activity);
+
+/*
+ * perf_context_destroy closes the events of the perf context and free its allocated resources.
+ */
+void perf_context_destroy(struct perf_context *ctx);
+
 /*
  * perf_monitoring_actor handle the monitoring of a cgroup using perf_event. 
+ * The actor accepts the DISABLE and ENABLE pipe commands to suspend the monitoring of a departed target while keeping its
+ * perf events open. ENABLE replies with a signal whose status is 0 when the target is the same cgroup than the monitored one.
+ * The events groups are changed at runtime with the ADD-GROUP (group pointer), REMOVE-GROUP (group name) and SET-INTERVAL
+ * (group name, interval in ms) pipe commands, only touching the events of the given group. The SET-SAMPLING-INTERVAL
+ * (interval in ms) pipe command changes the interval of the groups not having their own. They reply with a signal whose
+ * status is 0 on success.
  */
 void perf_monitoring_actor(zsock_t *pipe, void *args);
 
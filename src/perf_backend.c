@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <perfmon/pfmlib_perf_event.h>
+
+#include "perf_backend.h"
+
+static int
+kernel_open_cgroup(struct perf_backend *backend __attribute__ ((unused)), const char *cgroup_path)
+{
+    return open(cgroup_path, O_RDONLY);
+}
+
+static bool
+kernel_is_same_cgroup(struct perf_backend *backend __attribute__ ((unused)), int cgroup_fd, const char *cgroup_path)
+{
+    struct stat monitored_stat;
+    struct stat current_stat;
+
+    if (fstat(cgroup_fd, &monitored_stat) || stat(cgroup_path, &current_stat))
+        return false;
+
+    return monitored_stat.st_dev == current_stat.st_dev && monitored_stat.st_ino == current_stat.st_ino;
+}
+
+static int
+kernel_open_event(struct perf_backend *backend __attribute__ ((unused)), struct perf_event_attr *attr, int cgroup_fd, int cpu, int group_fd, unsigned long flags)
+{
+    return perf_event_open(attr, cgroup_fd, cpu, group_fd, flags);
+}
+
+static ssize_t
+kernel_read_group(struct perf_backend *backend __attribute__ ((unused)), int group_fd, void *buffer, size_t size)
+{
+    return read(group_fd, buffer, size);
+}
+
+static int
+kernel_control_group(struct perf_backend *backend __attribute__ ((unused)), int group_fd, unsigned long request)
+{
+    return ioctl(group_fd, request, PERF_IOC_FLAG_GROUP);
+}
+
+static void
+kernel_close(struct perf_backend *backend __attribute__ ((unused)), int fd)
+{
+    close(fd);
+}
+
+static void
+kernel_destroy(struct perf_backend *backend __attribute__ ((unused)))
+{
+    return;
+}
+
+struct perf_backend *
+perf_backend_kernel_create(void)
+{
+    struct perf_backend *backend = (struct perf_backend *) malloc(sizeof(struct perf_backend));
+
+    if (!backend)
+        return NULL;
+
+    backend->context = NULL;
+    backend->open_cgroup = kernel_open_cgroup;
+    backend->is_same_cgroup = kernel_is_same_cgroup;
+    backend->open_event = kernel_open_event;
+    backend->read_group = kernel_read_group;
+    backend->control_group = kernel_control_group;
+    backend->close = kernel_close;
+    backend->destroy = kernel_destroy;
+
+    return backend;
+}
+
+void
+perf_backend_destroy(struct perf_backend *backend)
+{
+    if (!backend)
+        return;
+
+    (*backend->destroy)(backend);
+    free(backend);
+}
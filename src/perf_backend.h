@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PERF_BACKEND_H
+#define PERF_BACKEND_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <linux/perf_event.h>
+
+/*
+ * perf_backend is a generic interface for the providers of the perf events counters.
+ * The file descriptors returned by a backend are only meaningful to the backend that created them.
+ */
+struct perf_backend
+{
+    void *context;
+    int (*open_cgroup)(struct perf_backend *self, const char *cgroup_path);
+    bool (*is_same_cgroup)(struct perf_backend *self, int cgroup_fd, const char *cgroup_path);
+    int (*open_event)(struct perf_backend *self, struct perf_event_attr *attr, int cgroup_fd, int cpu, int group_fd, unsigned long flags);
+    ssize_t (*read_group)(struct perf_backend *self, int group_fd, void *buffer, size_t size);
+    int (*control_group)(struct perf_backend *self, int group_fd, unsigned long request);
+    void (*close)(struct perf_backend *self, int fd);
+    void (*destroy)(struct perf_backend *self);
+};
+
+/*
+ * perf_backend_kernel_create creates the backend using the perf_event subsystem of the kernel.
+ */
+struct perf_backend *perf_backend_kernel_create(void);
+
+/*
+ * perf_backend_destroy free the allocated resources for the perf backend.
+ */
+void perf_backend_destroy(struct perf_backend *backend);
+
+#endif /* PERF_BACKEND_H */
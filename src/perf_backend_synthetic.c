@@ -0,0 +1,340 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "perf.h"
+#include "perf_backend_synthetic.h"
+
+/*
+ * SYNTHETIC_EVENTS_PER_PAGE is the number of synthetic events stored in a page of the events table.
+ * SYNTHETIC_MAX_PAGES is the maximum number of pages, the pages are never moved so that they can be read without locking.
+ */
+#define SYNTHETIC_EVENTS_PER_PAGE 4096
+#define SYNTHETIC_MAX_PAGES 16384
+
+/*
+ * synthetic_event stores the state of a synthetic cgroup or event, the group leader holds the state of its group.
+ */
+struct synthetic_event
+{
+    int leader_fd; /* fd of the group leader, itself for a leader */
+    int next_fd; /* next member of the group, -1 for the last one */
+    int last_fd; /* last member of the group, only set for a leader */
+    uint64_t nr; /* number of events of the group, only set for a leader */
+    uint64_t config;
+    uint64_t load_permille; /* share of the cpu used by the monitored cgroup */
+    bool enabled;
+    uint64_t time_enabled_ns; /* time accumulated until the last disabling */
+    uint64_t enabled_since_ns;
+};
+
+/*
+ * synthetic_context stores the context of the synthetic backend.
+ */
+struct synthetic_context
+{
+    pthread_mutex_t lock;
+    int num_fds;
+    struct synthetic_event *pages[SYNTHETIC_MAX_PAGES];
+};
+
+static uint64_t
+get_monotonic_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static uint64_t
+hash_string(const char *str)
+{
+    uint64_t hash = 14695981039346656037ULL; /* FNV-1a */
+
+    for (; *str; str++) {
+        hash ^= (unsigned char) *str;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static struct synthetic_event *
+lookup_event(struct synthetic_context *ctx, int fd)
+{
+    if (fd < 0 || fd >= __atomic_load_n(&ctx->num_fds, __ATOMIC_ACQUIRE))
+        return NULL;
+
+    return &ctx->pages[fd / SYNTHETIC_EVENTS_PER_PAGE][fd % SYNTHETIC_EVENTS_PER_PAGE];
+}
+
+static int
+allocate_event(struct synthetic_context *ctx, struct synthetic_event **event_ptr)
+{
+    int fd = -1;
+    struct synthetic_event *page = NULL;
+
+    pthread_mutex_lock(&ctx->lock);
+
+    if (ctx->num_fds / SYNTHETIC_EVENTS_PER_PAGE >= SYNTHETIC_MAX_PAGES) {
+        errno = EMFILE;
+        goto out;
+    }
+
+    if (ctx->num_fds % SYNTHETIC_EVENTS_PER_PAGE == 0) {
+        page = (struct synthetic_event *) calloc(SYNTHETIC_EVENTS_PER_PAGE, sizeof(struct synthetic_event));
+        if (!page) {
+            errno = ENOMEM;
+            goto out;
+        }
+        ctx->pages[ctx->num_fds / SYNTHETIC_EVENTS_PER_PAGE] = page;
+    }
+
+    fd = ctx->num_fds;
+    *event_ptr = &ctx->pages[fd / SYNTHETIC_EVENTS_PER_PAGE][fd % SYNTHETIC_EVENTS_PER_PAGE];
+    __atomic_store_n(&ctx->num_fds, fd + 1, __ATOMIC_RELEASE);
+
+out:
+    pthread_mutex_unlock(&ctx->lock);
+    return fd;
+}
+
+static int
+synthetic_open_cgroup(struct perf_backend *backend, const char *cgroup_path)
+{
+    struct synthetic_context *ctx = (struct synthetic_context *) backend->context;
+    struct synthetic_event *cgroup = NULL;
+    int fd;
+
+    fd = allocate_event(ctx, &cgroup);
+    if (fd < 0)
+        return -1;
+
+    /* the hash of the path seeds the load of the cgroup on every cpu */
+    *cgroup = (struct synthetic_event){ .leader_fd = fd, .next_fd = -1, .last_fd = fd, .nr = 0, .config = hash_string(cgroup_path), .load_permille = 0, .enabled = false, .time_enabled_ns = 0, .enabled_since_ns = 0 };
+    return fd;
+}
+
+static bool
+synthetic_is_same_cgroup(struct perf_backend *backend, int cgroup_fd, const char *cgroup_path)
+{
+    struct synthetic_event *cgroup = lookup_event((struct synthetic_context *) backend->context, cgroup_fd);
+
+    return cgroup && cgroup->config == hash_string(cgroup_path);
+}
+
+static int
+synthetic_open_event(struct perf_backend *backend, struct perf_event_attr *attr, int cgroup_fd, int cpu, int group_fd, unsigned long flags __attribute__ ((unused)))
+{
+    struct synthetic_context *ctx = (struct synthetic_context *) backend->context;
+    struct synthetic_event *cgroup = NULL;
+    struct synthetic_event *leader = NULL;
+    struct synthetic_event *event = NULL;
+    uint64_t load_permille = 1000; /* system wide monitoring */
+    int fd;
+
+    if (cgroup_fd >= 0) {
+        cgroup = lookup_event(ctx, cgroup_fd);
+        if (!cgroup) {
+            errno = EBADF;
+            return -1;
+        }
+        load_permille = (cgroup->config + (uint64_t) cpu * 2654435761ULL) % 1001;
+    }
+
+    if (group_fd >= 0) {
+        leader = lookup_event(ctx, group_fd);
+        if (!leader || leader->leader_fd != group_fd) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+
+    fd = allocate_event(ctx, &event);
+    if (fd < 0)
+        return -1;
+
+    *event = (struct synthetic_event){ .leader_fd = fd, .next_fd = -1, .last_fd = fd, .nr = 1, .config = attr->config, .load_permille = load_permille, .enabled = !attr->disabled, .time_enabled_ns = 0, .enabled_since_ns = get_monotonic_time_ns() };
+
+    /* the members of a group are opened by the same thread, only the leader links them */
+    if (leader) {
+        event->leader_fd = group_fd;
+        lookup_event(ctx, leader->last_fd)->next_fd = fd;
+        leader->last_fd = fd;
+        leader->nr++;
+    }
+
+    return fd;
+}
+
+static uint64_t
+get_time_enabled(const struct synthetic_event *leader, uint64_t now_ns)
+{
+    return leader->time_enabled_ns + ((leader->enabled) ? now_ns - leader->enabled_since_ns : 0);
+}
+
+static ssize_t
+synthetic_read_group(struct perf_backend *backend, int group_fd, void *buffer, size_t size)
+{
+    struct synthetic_context *ctx = (struct synthetic_context *) backend->context;
+    struct synthetic_event *leader = lookup_event(ctx, group_fd);
+    struct synthetic_event *event = NULL;
+    struct perf_read_format *sample = (struct perf_read_format *) buffer;
+    size_t sample_size;
+    uint64_t time_enabled;
+    uint64_t i = 0;
+    int fd;
+
+    if (!leader || leader->leader_fd != group_fd) {
+        errno = EBADF;
+        return -1;
+    }
+
+    sample_size = offsetof(struct perf_read_format, values) + sizeof(struct perf_counter_value) * leader->nr;
+    if (size < sample_size) {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    time_enabled = get_time_enabled(leader, get_monotonic_time_ns());
+    sample->nr = leader->nr;
+    sample->time_enabled = time_enabled;
+    sample->time_running = time_enabled;
+
+    /* every event counts at a rate depending on its config and on the load of the cgroup on the cpu */
+    for (fd = group_fd; fd >= 0; fd = event->next_fd) {
+        event = lookup_event(ctx, fd);
+        sample->values[i++].value = time_enabled / 1000 * event->load_permille * ((event->config % 4) + 1) / 1000;
+    }
+
+    return (ssize_t) sample_size;
+}
+
+static int
+synthetic_control_group(struct perf_backend *backend, int group_fd, unsigned long request)
+{
+    struct synthetic_event *leader = lookup_event((struct synthetic_context *) backend->context, group_fd);
+    uint64_t now_ns = get_monotonic_time_ns();
+
+    if (!leader || leader->leader_fd != group_fd) {
+        errno = EBADF;
+        return -1;
+    }
+
+    switch (request) {
+        case PERF_EVENT_IOC_RESET:
+            leader->time_enabled_ns = 0;
+            leader->enabled_since_ns = now_ns;
+            return 0;
+
+        case PERF_EVENT_IOC_ENABLE:
+            if (!leader->enabled) {
+                leader->enabled = true;
+                leader->enabled_since_ns = now_ns;
+            }
+            return 0;
+
+        case PERF_EVENT_IOC_DISABLE:
+            leader->time_enabled_ns = get_time_enabled(leader, now_ns);
+            leader->enabled = false;
+            return 0;
+
+        default:
+            errno = ENOTTY;
+            return -1;
+    }
+}
+
+static void
+synthetic_close(struct perf_backend *backend __attribute__ ((unused)), int fd __attribute__ ((unused)))
+{
+    /* the synthetic events are never reused, they are released with the backend */
+    return;
+}
+
+static void
+synthetic_destroy_context(struct synthetic_context *ctx)
+{
+    for (int page_i = 0; page_i < SYNTHETIC_MAX_PAGES && ctx->pages[page_i]; page_i++) {
+        free(ctx->pages[page_i]);
+    }
+
+    pthread_mutex_destroy(&ctx->lock);
+    free(ctx);
+}
+
+static void
+synthetic_destroy(struct perf_backend *backend)
+{
+    synthetic_destroy_context((struct synthetic_context *) backend->context);
+}
+
+struct perf_backend *
+perf_backend_synthetic_create(void)
+{
+    struct perf_backend *backend = (struct perf_backend *) malloc(sizeof(struct perf_backend));
+    struct synthetic_context *ctx = NULL;
+    struct synthetic_event *reserved = NULL;
+
+    if (!backend)
+        return NULL;
+
+    ctx = (struct synthetic_context *) calloc(1, sizeof(struct synthetic_context));
+    if (!ctx) {
+        free(backend);
+        return NULL;
+    }
+
+    pthread_mutex_init(&ctx->lock, NULL);
+    ctx->num_fds = 0;
+
+    /* the fd 0 is reserved, as it is rejected by the perf actors like for the kernel backend */
+    if (allocate_event(ctx, &reserved) < 0) {
+        synthetic_destroy_context(ctx);
+        free(backend);
+        return NULL;
+    }
+
+    backend->context = ctx;
+    backend->open_cgroup = synthetic_open_cgroup;
+    backend->is_same_cgroup = synthetic_is_same_cgroup;
+    backend->open_event = synthetic_open_event;
+    backend->read_group = synthetic_read_group;
+    backend->control_group = synthetic_control_group;
+    backend->close = synthetic_close;
+    backend->destroy = synthetic_destroy;
+
+    return backend;
+}
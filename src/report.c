@@ -39,6 +39,8 @@
 #include "payload.h"
 #include "perf.h"
 #include "storage.h"
+#include "overload.h"
+#include "self_monitor.h"
 
 struct report_config *
 report_config_create(struct storage_module *storage_module)
@@ -49,6 +51,8 @@ report_config_create(struct storage_module *storage_module)
         return NULL;
 
     config->storage = storage_module;
+    config->unattributed = false;
+    config->overload = NULL;
 
     return config;
 }
@@ -75,6 +79,9 @@ report_context_create(struct report_config *config, zsock_t *pipe)
     ctx->reporting = zsock_new_pull("inproc://reporting");
     ctx->poller = zpoller_new(ctx->pipe, ctx->reporting, NULL);
     ctx->config = config;
+    ctx->accounting_timestamp = 0;
+    ctx->system_payload = NULL;
+    ctx->monitored_payload = NULL;
     
     return ctx;
 }
@@ -87,23 +94,295 @@ report_context_destroy(struct report_context *ctx)
 
     zpoller_destroy(&ctx->poller);
     zsock_destroy(&ctx->reporting);
+    payload_destroy(ctx->system_payload);
+    payload_destroy(ctx->monitored_payload);
     free(ctx);
 }
 
 static void
 handle_pipe(struct report_context *ctx)
 {
-    char *command = zstr_recv(ctx->pipe);
+    zmsg_t *msg = zmsg_recv(ctx->pipe);
+    char *command = NULL;
+    zframe_t *storage_frame = NULL;
+    struct storage_module *storage = NULL;
+    char *unattributed = NULL;
 
-    if (streq(command, "$TERM")) {
+    if (!msg)
+        return;
+
+    command = zmsg_popstr(msg);
+    if (!command) {
+        zsys_error("reporting: empty pipe command");
+    }
+    else if (streq(command, "$TERM")) {
         ctx->terminated = true;
         zsys_info("reporting: bye!");
     }
+    else if (streq(command, "STORAGE")) {
+        /* the previous storage module is released by the sender once the reply is received */
+        storage_frame = zmsg_pop(msg);
+        if (storage_frame && zframe_size(storage_frame) == sizeof(storage))
+            memcpy(&storage, zframe_data(storage_frame), sizeof(storage));
+
+        if (storage) {
+            ctx->config->storage = storage;
+            zsys_info("reporting: storage module replaced");
+        }
+        zsock_signal(ctx->pipe, (storage) ? 0 : 1);
+    }
+    else if (streq(command, "UNATTRIBUTED")) {
+        /* the payloads of the tick being accounted may not cover the same interval anymore */
+        unattributed = zmsg_popstr(msg);
+        ctx->config->unattributed = unattributed && streq(unattributed, "1");
+        payload_destroy(ctx->system_payload);
+        ctx->system_payload = NULL;
+        payload_destroy(ctx->monitored_payload);
+        ctx->monitored_payload = NULL;
+    }
     else {
         zsys_error("reporting: invalid pipe command: %s", command);
     }
 
+    zframe_destroy(&storage_frame);
+    zstr_free(&unattributed);
     zstr_free(&command);
+    zmsg_destroy(&msg);
+}
+
+static bool
+is_system_payload(struct payload *payload)
+{
+    return streq(payload->target_name, "all");
+}
+
+static bool
+is_self_payload(struct payload *payload)
+{
+    return streq(payload->target_name, SELF_MONITOR_TARGET_NAME);
+}
+
+static bool
+is_counter_event(const char *event_name)
+{
+    return !streq(event_name, "time_enabled") && !streq(event_name, "time_running");
+}
+
+static int
+accumulate_cpu_data(struct payload_cpu_data *dst, struct payload_cpu_data *src)
+{
+    uint64_t *src_value = NULL;
+    const char *event_name = NULL;
+    uint64_t *dst_value = NULL;
+
+    for (src_value = (uint64_t *) zhashx_first(src->events); src_value; src_value = (uint64_t *) zhashx_next(src->events)) {
+        event_name = (const char *) zhashx_cursor(src->events);
+        if (!is_counter_event(event_name))
+            continue;
+
+        dst_value = (uint64_t *) zhashx_lookup(dst->events, event_name);
+        if (dst_value) {
+            *dst_value += *src_value;
+        }
+        else if (zhashx_insert(dst->events, event_name, src_value)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+accumulate_payload(struct payload *dst, struct payload *src)
+{
+    struct payload_group_data *src_group = NULL;
+    const char *group_name = NULL;
+    struct payload_group_data *dst_group = NULL;
+    struct payload_pkg_data *src_pkg = NULL;
+    const char *pkg_id = NULL;
+    struct payload_pkg_data *dst_pkg = NULL;
+    struct payload_cpu_data *src_cpu = NULL;
+    const char *cpu_id = NULL;
+    struct payload_cpu_data *dst_cpu = NULL;
+
+    for (src_group = (struct payload_group_data *) zhashx_first(src->groups); src_group; src_group = (struct payload_group_data *) zhashx_next(src->groups)) {
+        group_name = (const char *) zhashx_cursor(src->groups);
+        dst_group = (struct payload_group_data *) zhashx_lookup(dst->groups, group_name);
+        if (!dst_group) {
+            dst_group = payload_group_data_create();
+            if (!dst_group || zhashx_insert(dst->groups, group_name, dst_group)) {
+                payload_group_data_destroy(&dst_group);
+                return -1;
+            }
+        }
+
+        for (src_pkg = (struct payload_pkg_data *) zhashx_first(src_group->pkgs); src_pkg; src_pkg = (struct payload_pkg_data *) zhashx_next(src_group->pkgs)) {
+            pkg_id = (const char *) zhashx_cursor(src_group->pkgs);
+            dst_pkg = (struct payload_pkg_data *) zhashx_lookup(dst_group->pkgs, pkg_id);
+            if (!dst_pkg) {
+                dst_pkg = payload_pkg_data_create();
+                if (!dst_pkg || zhashx_insert(dst_group->pkgs, pkg_id, dst_pkg)) {
+                    payload_pkg_data_destroy(&dst_pkg);
+                    return -1;
+                }
+            }
+
+            for (src_cpu = (struct payload_cpu_data *) zhashx_first(src_pkg->cpus); src_cpu; src_cpu = (struct payload_cpu_data *) zhashx_next(src_pkg->cpus)) {
+                cpu_id = (const char *) zhashx_cursor(src_pkg->cpus);
+                dst_cpu = (struct payload_cpu_data *) zhashx_lookup(dst_pkg->cpus, cpu_id);
+                if (!dst_cpu) {
+                    dst_cpu = payload_cpu_data_create();
+                    if (!dst_cpu || zhashx_insert(dst_pkg->cpus, cpu_id, dst_cpu)) {
+                        payload_cpu_data_destroy(&dst_cpu);
+                        return -1;
+                    }
+                }
+
+                if (accumulate_cpu_data(dst_cpu, src_cpu)) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int
+merge_payload_groups(struct payload *dst, struct payload *src)
+{
+    struct payload_group_data *group_data = NULL;
+    struct payload_group_data *group_data_copy = NULL;
+
+    for (group_data = (struct payload_group_data *) zhashx_first(src->groups); group_data; group_data = (struct payload_group_data *) zhashx_next(src->groups)) {
+        group_data_copy = payload_group_data_dup(group_data);
+        if (!group_data_copy || zhashx_insert(dst->groups, zhashx_cursor(src->groups), group_data_copy)) {
+            payload_group_data_destroy(&group_data_copy);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void
+subtract_payload(struct payload *dst, struct payload *src)
+{
+    struct payload_group_data *dst_group = NULL;
+    struct payload_group_data *src_group = NULL;
+    struct payload_pkg_data *dst_pkg = NULL;
+    struct payload_pkg_data *src_pkg = NULL;
+    struct payload_cpu_data *dst_cpu = NULL;
+    struct payload_cpu_data *src_cpu = NULL;
+    uint64_t *dst_value = NULL;
+    uint64_t *src_value = NULL;
+
+    for (dst_group = (struct payload_group_data *) zhashx_first(dst->groups); dst_group; dst_group = (struct payload_group_data *) zhashx_next(dst->groups)) {
+        src_group = (struct payload_group_data *) zhashx_lookup(src->groups, zhashx_cursor(dst->groups));
+        if (!src_group)
+            continue;
+
+        for (dst_pkg = (struct payload_pkg_data *) zhashx_first(dst_group->pkgs); dst_pkg; dst_pkg = (struct payload_pkg_data *) zhashx_next(dst_group->pkgs)) {
+            src_pkg = (struct payload_pkg_data *) zhashx_lookup(src_group->pkgs, zhashx_cursor(dst_group->pkgs));
+            if (!src_pkg)
+                continue;
+
+            for (dst_cpu = (struct payload_cpu_data *) zhashx_first(dst_pkg->cpus); dst_cpu; dst_cpu = (struct payload_cpu_data *) zhashx_next(dst_pkg->cpus)) {
+                src_cpu = (struct payload_cpu_data *) zhashx_lookup(src_pkg->cpus, zhashx_cursor(dst_pkg->cpus));
+                if (!src_cpu)
+                    continue;
+
+                for (dst_value = (uint64_t *) zhashx_first(dst_cpu->events); dst_value; dst_value = (uint64_t *) zhashx_next(dst_cpu->events)) {
+                    src_value = (uint64_t *) zhashx_lookup(src_cpu->events, zhashx_cursor(dst_cpu->events));
+                    if (!src_value)
+                        continue;
+
+                    /* the counters are not read atomically across the targets, clamp to avoid underflows */
+                    *dst_value = (*dst_value > *src_value) ? *dst_value - *src_value : 0;
+                }
+            }
+        }
+    }
+}
+
+static void
+store_report(struct report_context *ctx, struct payload *payload)
+{
+    if (storage_module_store_report(ctx->config->storage, payload)) {
+        zsys_error("report: failed to store the report for timestamp=%lu", payload->timestamp);
+    }
+}
+
+static void
+flush_unattributed(struct report_context *ctx)
+{
+    struct payload *unattributed = NULL;
+
+    if (ctx->system_payload) {
+        unattributed = ctx->system_payload;
+        ctx->system_payload = NULL;
+
+        free(unattributed->target_name);
+        unattributed->target_name = strdup("unattributed");
+
+        if (ctx->monitored_payload) {
+            subtract_payload(unattributed, ctx->monitored_payload);
+        }
+
+        store_report(ctx, unattributed);
+        payload_destroy(unattributed);
+    }
+
+    payload_destroy(ctx->monitored_payload);
+    ctx->monitored_payload = NULL;
+}
+
+static void
+account_payload(struct report_context *ctx, struct payload *payload)
+{
+    /* the payloads of a tick share its timestamp, a newer one means that the accounted tick is complete */
+    if (payload->timestamp > ctx->accounting_timestamp) {
+        flush_unattributed(ctx);
+        ctx->accounting_timestamp = payload->timestamp;
+    }
+    else if (payload->timestamp < ctx->accounting_timestamp) {
+        zsys_debug("report: late payload of target=%s for timestamp=%lu not accounted", payload->target_name, payload->timestamp);
+        return;
+    }
+
+    /* the overhead of the sensor is not an activity of the monitored system */
+    if (is_self_payload(payload))
+        return;
+
+    /* the groups of the system target can be read by several payloads when their sampling intervals differ */
+    if (is_system_payload(payload)) {
+        if (!ctx->system_payload) {
+            ctx->system_payload = payload_create(payload->timestamp, payload->target_name);
+            if (!ctx->system_payload) {
+                zsys_error("report: failed to allocate the system payload for timestamp=%lu", payload->timestamp);
+                return;
+            }
+            ctx->system_payload->interval_ms = payload->interval_ms;
+            ctx->system_payload->partial = payload->partial;
+        }
+
+        if (merge_payload_groups(ctx->system_payload, payload)) {
+            zsys_error("report: failed to copy the system payload for timestamp=%lu", payload->timestamp);
+        }
+        return;
+    }
+
+    if (!ctx->monitored_payload) {
+        ctx->monitored_payload = payload_create(payload->timestamp, "monitored");
+        if (!ctx->monitored_payload) {
+            zsys_error("report: failed to allocate the monitored payload for timestamp=%lu", payload->timestamp);
+            return;
+        }
+    }
+
+    if (accumulate_payload(ctx->monitored_payload, payload)) {
+        zsys_error("report: failed to account the payload of target=%s for timestamp=%lu", payload->target_name, payload->timestamp);
+    }
 }
 
 static void
@@ -116,11 +395,13 @@ handle_reporting(struct report_context *ctx)
     if (!payload)
         return;
 
-    if (storage_module_store_report(ctx->config->storage, payload)) {
-        zsys_error("report: failed to store the report for timestamp=%lu", payload->timestamp);
+    if (ctx->config->unattributed) {
+        account_payload(ctx, payload);
     }
 
+    store_report(ctx, payload);
     payload_destroy(payload);
+    overload_monitor_payload_stored(ctx->config->overload);
 }
 
 void
@@ -151,6 +432,9 @@ reporting_actor(zsock_t *pipe, void *args)
         }
     }
 
+    /* the last accounted tick is complete when the sensor stops */
+    flush_unattributed(ctx);
+
     report_context_destroy(ctx);
 }
 
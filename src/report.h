@@ -41,6 +41,8 @@
 struct report_config
 {
     struct storage_module *storage;
+    bool unattributed; /* report the system activity not accounted to the monitored targets, only valid when every target is read on each tick */
+    struct overload_monitor *overload; /* NULL to disable the overload detection */
 };
 
 /*
@@ -53,6 +55,9 @@ struct report_context
     zsock_t *pipe;
     zsock_t *reporting;
     zpoller_t *poller;
+    uint64_t accounting_timestamp; /* timestamp of the tick being accounted */
+    struct payload *system_payload; /* copy of the system payload of the accounted tick */
+    struct payload *monitored_payload; /* sum of the targets payloads of the accounted tick */
 };
 
 /*
@@ -67,6 +72,8 @@ void report_config_destroy(struct report_config *config);
 
 /*
  * reporting_actor is the reporting actor entrypoint.
+ * The actor accepts the STORAGE pipe command (storage module pointer) to replace its storage module, it replies with a signal
+ * whose status is 0 once the previous module is no longer used.
  */
 void reporting_actor(zsock_t *pipe, void *args);
 
@@ -0,0 +1,492 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <perfmon/pfmlib_perf_event.h>
+
+#include "payload.h"
+#include "self_monitor.h"
+#include "util.h"
+
+/*
+ * self_event stores the definition of an event counted for every thread of the sensor.
+ */
+struct self_event
+{
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+};
+
+static const struct self_event self_events[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+/*
+ * SELF_NUM_EVENTS stores the number of events counted for every thread of the sensor.
+ */
+#define SELF_NUM_EVENTS (sizeof(self_events) / sizeof(self_events[0]))
+
+/*
+ * self_thread_counters stores the events opened for a thread of the sensor.
+ */
+struct self_thread_counters
+{
+    int fds[SELF_NUM_EVENTS]; /* -1 when the event cannot be counted for the thread */
+    bool alive; /* the thread was found during the last scan */
+};
+
+/*
+ * self_monitor_context stores the context of a self monitoring actor.
+ */
+struct self_monitor_context
+{
+    struct self_monitor_config *config;
+    bool terminated;
+    zsock_t *pipe;
+    zsock_t *ticker;
+    zpoller_t *poller;
+    zsock_t *reporting;
+    zhashx_t *threads; /* char *tid -> struct self_thread_counters *counters */
+    bool available[SELF_NUM_EVENTS]; /* the event is supported by the machine */
+    uint64_t retired[SELF_NUM_EVENTS]; /* final values of the exited threads */
+    uint64_t previous[SELF_NUM_EVENTS]; /* process wide values at the previous report */
+    struct rusage previous_usage;
+    uint64_t last_read_timestamp; /* 0 before the first report */
+    uint64_t last_actual_read_timestamp;
+    uint64_t start_timestamp;
+};
+
+struct self_monitor_config *
+self_monitor_config_create(unsigned int stride, struct overload_monitor *overload)
+{
+    struct self_monitor_config *config = (struct self_monitor_config *) malloc(sizeof(struct self_monitor_config));
+
+    if (!config)
+        return NULL;
+
+    config->stride = (stride) ? stride : 1;
+    config->overload = overload;
+
+    return config;
+}
+
+void
+self_monitor_config_destroy(struct self_monitor_config *config)
+{
+    if (!config)
+        return;
+
+    free(config);
+}
+
+static void
+self_thread_counters_destroy(struct self_thread_counters **counters_ptr)
+{
+    if (!*counters_ptr)
+        return;
+
+    for (size_t event_i = 0; event_i < SELF_NUM_EVENTS; event_i++) {
+        if ((*counters_ptr)->fds[event_i] >= 0)
+            close((*counters_ptr)->fds[event_i]);
+    }
+
+    free(*counters_ptr);
+    *counters_ptr = NULL;
+}
+
+static struct self_monitor_context *
+self_monitor_context_create(struct self_monitor_config *config, zsock_t *pipe)
+{
+    struct self_monitor_context *ctx = (struct self_monitor_context *) malloc(sizeof(struct self_monitor_context));
+
+    if (!ctx)
+        return NULL;
+
+    ctx->config = config;
+    ctx->terminated = false;
+    ctx->pipe = pipe;
+    ctx->ticker = zsock_new_sub("inproc://ticker", "CLOCK_TICK");
+    ctx->poller = zpoller_new(ctx->pipe, ctx->ticker, NULL);
+    ctx->reporting = zsock_new_push("inproc://reporting");
+    ctx->threads = zhashx_new();
+    zhashx_set_destructor(ctx->threads, (zhashx_destructor_fn *) self_thread_counters_destroy);
+    for (size_t event_i = 0; event_i < SELF_NUM_EVENTS; event_i++) {
+        ctx->available[event_i] = true;
+        ctx->retired[event_i] = 0;
+        ctx->previous[event_i] = 0;
+    }
+    ctx->previous_usage = (struct rusage){};
+    ctx->last_read_timestamp = 0;
+    ctx->last_actual_read_timestamp = 0;
+    ctx->start_timestamp = (uint64_t) zclock_time();
+
+    return ctx;
+}
+
+static void
+self_monitor_context_destroy(struct self_monitor_context *ctx)
+{
+    if (!ctx)
+        return;
+
+    zpoller_destroy(&ctx->poller);
+    zsock_destroy(&ctx->ticker);
+    zsock_destroy(&ctx->reporting);
+    zhashx_destroy(&ctx->threads);
+    free(ctx);
+}
+
+static struct self_thread_counters *
+open_thread_counters(struct self_monitor_context *ctx, pid_t tid)
+{
+    struct self_thread_counters *counters = (struct self_thread_counters *) malloc(sizeof(struct self_thread_counters));
+    struct perf_event_attr attr = {};
+
+    if (!counters)
+        return NULL;
+
+    counters->alive = true;
+    for (size_t event_i = 0; event_i < SELF_NUM_EVENTS; event_i++) {
+        counters->fds[event_i] = -1;
+        if (!ctx->available[event_i])
+            continue;
+
+        attr = (struct perf_event_attr){};
+        attr.type = self_events[event_i].type;
+        attr.size = sizeof(struct perf_event_attr);
+        attr.config = self_events[event_i].config;
+        attr.exclude_hv = 1;
+
+        errno = 0;
+        counters->fds[event_i] = perf_event_open(&attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (counters->fds[event_i] < 0 && errno != ESRCH) {
+            /* the hardware events are not available on every machine (virtual machines for instance) */
+            zsys_warning("self: cannot count event %s errno=%d, it will not be reported", self_events[event_i].name, errno);
+            ctx->available[event_i] = false;
+        }
+    }
+
+    return counters;
+}
+
+static int
+scan_threads(struct self_monitor_context *ctx)
+{
+    struct self_thread_counters *counters = NULL;
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+    unsigned int tid;
+
+    dir = opendir("/proc/self/task");
+    if (!dir) {
+        zsys_error("self: failed to list the threads of the sensor errno=%d", errno);
+        return -1;
+    }
+
+    for (counters = (struct self_thread_counters *) zhashx_first(ctx->threads); counters; counters = (struct self_thread_counters *) zhashx_next(ctx->threads)) {
+        counters->alive = false;
+    }
+
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] == '.' || str_to_uint(entry->d_name, &tid))
+            continue;
+
+        counters = (struct self_thread_counters *) zhashx_lookup(ctx->threads, entry->d_name);
+        if (counters) {
+            counters->alive = true;
+            continue;
+        }
+
+        /* the events of the threads started since the previous scan are opened now */
+        counters = open_thread_counters(ctx, (pid_t) tid);
+        if (!counters || zhashx_insert(ctx->threads, entry->d_name, counters)) {
+            zsys_error("self: failed to open the counters of thread=%s", entry->d_name);
+            self_thread_counters_destroy(&counters);
+        }
+    }
+
+    closedir(dir);
+    return 0;
+}
+
+static void
+read_process_counters(struct self_monitor_context *ctx, uint64_t *totals)
+{
+    struct self_thread_counters *counters = NULL;
+    zlistx_t *exited = zlistx_new(); /* char *tid */
+    uint64_t value;
+
+    if (exited) {
+        zlistx_set_duplicator(exited, (zlistx_duplicator_fn *) strdup);
+        zlistx_set_destructor(exited, (zlistx_destructor_fn *) zstr_free);
+    }
+
+    for (size_t event_i = 0; event_i < SELF_NUM_EVENTS; event_i++) {
+        totals[event_i] = ctx->retired[event_i];
+    }
+
+    for (counters = (struct self_thread_counters *) zhashx_first(ctx->threads); counters; counters = (struct self_thread_counters *) zhashx_next(ctx->threads)) {
+        /* the counters of an exited thread keep their final values until they are closed */
+        for (size_t event_i = 0; event_i < SELF_NUM_EVENTS; event_i++) {
+            if (counters->fds[event_i] < 0 || read(counters->fds[event_i], &value, sizeof(uint64_t)) != sizeof(uint64_t))
+                continue;
+
+            totals[event_i] += value;
+            if (!counters->alive)
+                ctx->retired[event_i] += value;
+        }
+
+        if (!counters->alive && exited)
+            zlistx_add_end(exited, (void *) zhashx_cursor(ctx->threads));
+    }
+
+    for (const char *tid = (const char *) zlistx_first(exited); tid; tid = (const char *) zlistx_next(exited)) {
+        zhashx_delete(ctx->threads, tid);
+    }
+    zlistx_destroy(&exited);
+}
+
+static uint64_t
+timeval_delta_us(const struct timeval *current, const struct timeval *previous)
+{
+    const int64_t delta = ((int64_t) current->tv_sec - previous->tv_sec) * 1000000 + (current->tv_usec - previous->tv_usec);
+
+    return (delta > 0) ? (uint64_t) delta : 0;
+}
+
+static uint64_t
+get_resident_set_size(void)
+{
+    FILE *statm = fopen("/proc/self/statm", "r");
+    unsigned long size = 0;
+    unsigned long resident = 0;
+
+    if (!statm)
+        return 0;
+
+    if (fscanf(statm, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+
+    fclose(statm);
+    return (uint64_t) resident * (uint64_t) sysconf(_SC_PAGESIZE);
+}
+
+static int
+insert_value(struct payload_cpu_data *cpu_data, const char *name, uint64_t value)
+{
+    return zhashx_insert(cpu_data->events, name, &value);
+}
+
+static int
+populate_cpu_data(struct self_monitor_context *ctx, struct payload_cpu_data *cpu_data)
+{
+    uint64_t totals[SELF_NUM_EVENTS] = {};
+    struct rusage usage = {};
+    uint64_t delta;
+
+    if (scan_threads(ctx))
+        return -1;
+
+    read_process_counters(ctx, totals);
+    for (size_t event_i = 0; event_i < SELF_NUM_EVENTS; event_i++) {
+        if (!ctx->available[event_i])
+            continue;
+
+        /* a counter that could not be read is not accounted until it is readable again */
+        delta = (totals[event_i] > ctx->previous[event_i]) ? totals[event_i] - ctx->previous[event_i] : 0;
+        if (insert_value(cpu_data, self_events[event_i].name, delta))
+            return -1;
+
+        if (totals[event_i] > ctx->previous[event_i])
+            ctx->previous[event_i] = totals[event_i];
+    }
+
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        zsys_error("self: failed to get the resources usage errno=%d", errno);
+        return -1;
+    }
+
+    if (insert_value(cpu_data, "user_time_us", timeval_delta_us(&usage.ru_utime, &ctx->previous_usage.ru_utime)) ||
+        insert_value(cpu_data, "system_time_us", timeval_delta_us(&usage.ru_stime, &ctx->previous_usage.ru_stime)) ||
+        insert_value(cpu_data, "max_rss_bytes", (uint64_t) usage.ru_maxrss * 1024) ||
+        insert_value(cpu_data, "rss_bytes", get_resident_set_size()))
+        return -1;
+
+    ctx->previous_usage = usage;
+    return 0;
+}
+
+static struct payload *
+build_payload(struct self_monitor_context *ctx, uint64_t timestamp)
+{
+    struct payload *payload = NULL;
+    struct payload_group_data *group_data = NULL;
+    struct payload_pkg_data *pkg_data = NULL;
+    struct payload_cpu_data *cpu_data = NULL;
+
+    payload = payload_create(timestamp, SELF_MONITOR_TARGET_NAME);
+    group_data = payload_group_data_create();
+    pkg_data = payload_pkg_data_create();
+    cpu_data = payload_cpu_data_create();
+    if (!payload || !group_data || !pkg_data || !cpu_data)
+        goto error;
+
+    payload->read_timestamp = (uint64_t) zclock_time();
+    if (populate_cpu_data(ctx, cpu_data))
+        goto error;
+
+    if (zhashx_insert(pkg_data->cpus, "0", cpu_data))
+        goto error;
+    cpu_data = NULL;
+
+    if (zhashx_insert(group_data->pkgs, "0", pkg_data))
+        goto error;
+    pkg_data = NULL;
+
+    if (zhashx_insert(payload->groups, SELF_MONITOR_GROUP_NAME, group_data))
+        goto error;
+
+    return payload;
+
+error:
+    payload_cpu_data_destroy(&cpu_data);
+    payload_pkg_data_destroy(&pkg_data);
+    payload_group_data_destroy(&group_data);
+    payload_destroy(payload);
+    return NULL;
+}
+
+static void
+handle_ticker(struct self_monitor_context *ctx)
+{
+    struct payload *payload = NULL;
+    uint64_t timestamp;
+    uint64_t tick;
+    unsigned int overload_factor;
+
+    zsock_recv(ctx->ticker, "s884", NULL, &timestamp, &tick, &overload_factor);
+
+    if (tick % ((uint64_t) ctx->config->stride * overload_factor))
+        return;
+
+    payload = build_payload(ctx, timestamp);
+    if (!payload) {
+        zsys_error("self: failed to build the overhead report for timestamp=%lu", timestamp);
+        return;
+    }
+
+    /* the first report covers the time elapsed since the start of the actor */
+    if (!ctx->last_read_timestamp) {
+        payload->partial = true;
+        payload->interval_ms = (timestamp > ctx->start_timestamp) ? timestamp - ctx->start_timestamp : 0;
+        payload->interval_start_timestamp = ctx->start_timestamp;
+    }
+    else {
+        payload->interval_ms = timestamp - ctx->last_read_timestamp;
+        payload->interval_start_timestamp = ctx->last_actual_read_timestamp;
+    }
+    payload->overload_factor = overload_factor;
+    ctx->last_read_timestamp = timestamp;
+    ctx->last_actual_read_timestamp = payload->read_timestamp;
+
+    overload_monitor_payload_queued(ctx->config->overload);
+    zsock_send(ctx->reporting, "p", payload);
+}
+
+static void
+handle_pipe(struct self_monitor_context *ctx)
+{
+    char *command = zstr_recv(ctx->pipe);
+
+    if (streq(command, "$TERM")) {
+        ctx->terminated = true;
+        zsys_info("self: shutting down actor");
+    }
+    else {
+        zsys_error("self: invalid pipe command: %s", command);
+    }
+
+    zstr_free(&command);
+}
+
+void
+self_monitoring_actor(zsock_t *pipe, void *args)
+{
+    struct self_monitor_config *config = (struct self_monitor_config *) args;
+    struct self_monitor_context *ctx = self_monitor_context_create(config, pipe);
+    uint64_t totals[SELF_NUM_EVENTS] = {};
+    zsock_t *which = NULL;
+
+    zsock_signal(pipe, 0);
+
+    if (!ctx) {
+        zsys_error("self: cannot create context");
+        goto cleanup;
+    }
+
+    /* the values of the first report are relative to the start of the actor */
+    if (scan_threads(ctx) || getrusage(RUSAGE_SELF, &ctx->previous_usage))
+        goto cleanup;
+    read_process_counters(ctx, totals);
+    for (size_t event_i = 0; event_i < SELF_NUM_EVENTS; event_i++) {
+        ctx->previous[event_i] = totals[event_i];
+    }
+
+    zsys_info("self: monitoring actor started");
+
+    while (!ctx->terminated) {
+        which = (zsock_t *) zpoller_wait(ctx->poller, -1);
+
+        if (zpoller_terminated(ctx->poller))
+            break;
+
+        if (which == ctx->pipe)
+            handle_pipe(ctx);
+        else if (which == ctx->ticker)
+            handle_ticker(ctx);
+    }
+
+cleanup:
+    self_monitor_context_destroy(ctx);
+    self_monitor_config_destroy(config);
+}
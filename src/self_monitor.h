@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SELF_MONITOR_H
+#define SELF_MONITOR_H
+
+#include <czmq.h>
+
+#include "overload.h"
+
+/*
+ * SELF_MONITOR_TARGET_NAME stores the name of the target of the reports of the sensor own overhead.
+ */
+#define SELF_MONITOR_TARGET_NAME "hwpc-sensor"
+
+/*
+ * SELF_MONITOR_GROUP_NAME stores the name of the group of the reports of the sensor own overhead.
+ */
+#define SELF_MONITOR_GROUP_NAME "overhead"
+
+/*
+ * self_monitor_config stores the configuration of a self monitoring actor.
+ * The actor counts the cycles, instructions, context switches and page faults of every thread of the sensor process
+ * and reports them with its resources usage (cpu time and memory) as the SELF_MONITOR_TARGET_NAME target.
+ * The values are process wide and are reported for the socket 0 and cpu 0.
+ */
+struct self_monitor_config
+{
+    unsigned int stride; /* number of ticks between two reports */
+    struct overload_monitor *overload; /* NULL to disable the overload detection */
+};
+
+/*
+ * self_monitor_config_create allocate the resource of a self monitoring actor configuration.
+ */
+struct self_monitor_config *self_monitor_config_create(unsigned int stride, struct overload_monitor *overload);
+
+/*
+ * self_monitor_config_destroy free the allocated resource of the self monitoring actor configuration.
+ */
+void self_monitor_config_destroy(struct self_monitor_config *config);
+
+/*
+ * self_monitoring_actor is the self monitoring actor entrypoint.
+ */
+void self_monitoring_actor(zsock_t *pipe, void *args);
+
+#endif /* SELF_MONITOR_H */
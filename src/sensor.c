@@ -31,9 +31,12 @@
 
 #include <signal.h>
 #include <ctype.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
 #include <sys/utsname.h>
 #include <unistd.h>
 #include <czmq.h>
@@ -46,77 +49,259 @@
 #include "events.h"
 #include "hwinfo.h"
 #include "perf.h"
+#include "perf_backend.h"
 #include "report.h"
 #include "ticker.h"
 #include "target.h"
+#include "target_resolver.h"
 #include "storage.h"
-#include "storage_null.h"
-#include "storage_csv.h"
-#include "storage_socket.h"
+#include "util.h"
+#include "work_pool.h"
+#include "overload.h"
+#include "trace.h"
+#include "self_monitor.h"
 
 #ifdef HAVE_CAPABILITY_HARDENING
 #include "capabilities.h"
 #endif
 
-#ifdef HAVE_MONGODB
-#include "storage_mongodb.h"
-#endif
+static unsigned int
+gcd(unsigned int a, unsigned int b)
+{
+    unsigned int r;
 
-static struct storage_module *
-setup_storage_module(struct config *config)
-{
-    switch (config->storage.type)
-    {
-        case STORAGE_NULL:
-            return storage_null_create(config);
-        case STORAGE_CSV:
-            return storage_csv_create(config);
-        case STORAGE_SOCKET:
-            return storage_socket_create(config);
-#ifdef HAVE_MONGODB
-        case STORAGE_MONGODB:
-            return storage_mongodb_create(config);
-#endif
-        default:
-            return NULL;
+    while (b) {
+        r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+static unsigned int
+compute_ticker_interval(unsigned int interval_ms, zhashx_t *events_groups)
+{
+    struct events_group *events_group = NULL;
+
+    for (events_group = (struct events_group *) zhashx_first(events_groups); events_group; events_group = (struct events_group *) zhashx_next(events_groups)) {
+        if (events_group->interval_ms)
+            interval_ms = gcd(interval_ms, events_group->interval_ms);
+    }
+
+    return interval_ms;
+}
+
+static bool
+has_events_groups_interval(zhashx_t *events_groups)
+{
+    struct events_group *events_group = NULL;
+
+    for (events_group = (struct events_group *) zhashx_first(events_groups); events_group; events_group = (struct events_group *) zhashx_next(events_groups)) {
+        if (events_group->interval_ms)
+            return true;
     }
+
+    return false;
+}
+
+static bool
+is_unattributed_accountable(struct config *config)
+{
+    if (!config->sensor.min_lifetime_cycles && !config->sensor.min_lifetime_ms)
+        return false;
+
+    if (!zhashx_size(config->events.system) || !zhashx_size(config->events.containers))
+        return false;
+
+    /* the payloads of a tick only cover the same interval when every target is read on each tick, a skipped target would be counted as unattributed */
+    if (config->sensor.adaptive_threshold && config->sensor.adaptive_max_stride > 1)
+        return false;
+
+    return !has_events_groups_interval(config->events.system) && !has_events_groups_interval(config->events.containers);
+}
+
+/*
+ * pending_target stores the lifetime of a discovered target that is not yet monitored.
+ */
+struct pending_target
+{
+    int64_t first_seen_ms;
+    unsigned int survived_cycles;
+};
+
+static bool
+is_target_lifetime_reached(const struct config_sensor *sensor_config, zhashx_t *pending_targets, const char *cgroup_path)
+{
+    struct pending_target *pending = NULL;
+
+    if (sensor_config->min_lifetime_cycles == 0 && sensor_config->min_lifetime_ms == 0)
+        return true;
+
+    pending = (struct pending_target *) zhashx_lookup(pending_targets, cgroup_path);
+    if (!pending) {
+        pending = (struct pending_target *) malloc(sizeof(struct pending_target));
+        if (!pending) {
+            zsys_error("sensor: failed to allocate pending target for cgroup=%s", cgroup_path);
+            return true;
+        }
+
+        pending->first_seen_ms = zclock_mono();
+        pending->survived_cycles = 0;
+        zhashx_insert(pending_targets, cgroup_path, pending);
+        return false;
+    }
+
+    pending->survived_cycles++;
+    if ((sensor_config->min_lifetime_cycles && pending->survived_cycles >= sensor_config->min_lifetime_cycles) ||
+        (sensor_config->min_lifetime_ms && zclock_mono() - pending->first_seen_ms >= (int64_t) sensor_config->min_lifetime_ms)) {
+        zhashx_delete(pending_targets, cgroup_path);
+        return true;
+    }
+
+    return false;
 }
 
 static void
-sync_cgroups_running_monitored(struct hwinfo *hwinfo, zhashx_t *container_events_groups, const char *cgroup_basepath, zhashx_t *container_monitoring_actors)
+forget_departed_pending_targets(zhashx_t *pending_targets, zhashx_t *running_targets)
+{
+    zlistx_t *pending_paths = NULL;
+    const char *cgroup_path = NULL;
+
+    pending_paths = zhashx_keys(pending_targets);
+    if (!pending_paths)
+        return;
+
+    for (cgroup_path = (const char *) zlistx_first(pending_paths); cgroup_path; cgroup_path = (const char *) zlistx_next(pending_paths)) {
+        if (!zhashx_lookup(running_targets, cgroup_path)) {
+            zhashx_delete(pending_targets, cgroup_path);
+        }
+    }
+
+    zlistx_destroy(&pending_paths);
+}
+
+/*
+ * container_monitor stores the monitoring actor of a container.
+ */
+struct container_monitor
+{
+    zactor_t *actor;
+    int64_t departed_ms; /* time at which the container disappeared, 0 while it is running */
+    bool paused; /* monitoring suspended by the control socket */
+};
+
+static struct container_monitor *
+container_monitor_create(zactor_t *actor)
+{
+    struct container_monitor *monitor = (struct container_monitor *) malloc(sizeof(struct container_monitor));
+
+    if (!monitor)
+        return NULL;
+
+    monitor->actor = actor;
+    monitor->departed_ms = 0;
+    monitor->paused = false;
+
+    return monitor;
+}
+
+static void
+container_monitor_destroy(struct container_monitor **monitor_ptr)
+{
+    if (!*monitor_ptr)
+        return;
+
+    zactor_destroy(&(*monitor_ptr)->actor);
+    free(*monitor_ptr);
+    *monitor_ptr = NULL;
+}
+
+static void
+container_monitor_suspend(struct container_monitor *monitor)
+{
+    zstr_send(monitor->actor, "DISABLE");
+    monitor->departed_ms = zclock_mono();
+}
+
+static bool
+container_monitor_resume(struct container_monitor *monitor)
+{
+    /* a paused container stays disabled until it is resumed by the control socket */
+    if (!monitor->paused) {
+        zstr_send(monitor->actor, "ENABLE");
+        if (zsock_wait(monitor->actor))
+            return false;
+    }
+
+    monitor->departed_ms = 0;
+    return true;
+}
+
+static void
+sync_cgroups_running_monitored(const struct config_sensor *sensor_config, struct hwinfo *hwinfo, struct perf_backend *backend, struct work_pool *setup_pool, const struct perf_sampling_config *sampling, zhashx_t *container_events_groups, struct target_discovery *discovery, struct target_resolver *resolver, zhashx_t *pending_targets, zhashx_t *container_monitoring_actors)
 {
     zhashx_t *running_targets = NULL; /* char *cgroup_path -> struct target *target */
+    struct container_monitor *monitor = NULL;
     zactor_t *perf_monitor = NULL;
     const char *cgroup_path = NULL;
     struct target *target = NULL;
     struct perf_config *monitor_config = NULL;
+    const struct target_metadata *metadata = NULL;
 
     /* to store running cgroups name and absolute path */
     running_targets = zhashx_new();
 
     /* get running (and identifiable) container(s) */
-    if (target_discover_running(cgroup_basepath, running_targets)) {
+    if (target_discover_running(discovery, running_targets)) {
         zsys_error("sensor: error when retrieving the running targets.");
         goto out;
     }
 
-    /* stop monitoring dead container(s) */
-    for (perf_monitor = (zactor_t *) zhashx_first(container_monitoring_actors); perf_monitor; perf_monitor = (zactor_t *) zhashx_next(container_monitoring_actors)) {
+    /* suspend the monitoring of departed container(s) and stop it once their grace period is over */
+    for (monitor = (struct container_monitor *) zhashx_first(container_monitoring_actors); monitor; monitor = (struct container_monitor *) zhashx_next(container_monitoring_actors)) {
         cgroup_path = (const char *) zhashx_cursor(container_monitoring_actors);
-        target = (struct target *) zhashx_lookup(running_targets, cgroup_path);
-        if (!target) {
-            zhashx_freefn(running_targets, cgroup_path, (zhashx_free_fn *) target_destroy);
+        if (zhashx_lookup(running_targets, cgroup_path))
+            continue;
+
+        if (!monitor->departed_ms && sensor_config->cgroup_grace_period_ms) {
+            container_monitor_suspend(monitor);
+        }
+        else if (!monitor->departed_ms || zclock_mono() - monitor->departed_ms >= (int64_t) sensor_config->cgroup_grace_period_ms) {
+            target_resolver_invalidate(resolver, cgroup_path);
             zhashx_delete(container_monitoring_actors, cgroup_path);
         }
     }
 
-    /* start monitoring new container(s) */
+    /* forget the container(s) that died before being monitored */
+    forget_departed_pending_targets(pending_targets, running_targets);
+
+    /* start monitoring new container(s) that lived long enough */
     for (target = (struct target *) zhashx_first(running_targets); target; target = (struct target *) zhashx_next(running_targets)) {
         cgroup_path = (const char *) zhashx_cursor(running_targets);
-        if (!zhashx_lookup(container_monitoring_actors, cgroup_path)) {
-            monitor_config = perf_config_create(hwinfo, container_events_groups, target);
+        monitor = (struct container_monitor *) zhashx_lookup(container_monitoring_actors, cgroup_path);
+
+        /* reattach to the perf events of a container that reappeared during its grace period */
+        if (monitor && monitor->departed_ms && !container_monitor_resume(monitor)) {
+            target_resolver_invalidate(resolver, cgroup_path);
+            zhashx_delete(container_monitoring_actors, cgroup_path);
+            monitor = NULL;
+        }
+
+        if (!monitor && is_target_lifetime_reached(sensor_config, pending_targets, cgroup_path)) {
+            metadata = target_resolver_resolve(resolver, target);
+            if (metadata)
+                target_metadata_apply(metadata, target);
+
+            monitor_config = perf_config_create(hwinfo, container_events_groups, target, backend, setup_pool, sampling);
             perf_monitor = zactor_new(perf_monitoring_actor, monitor_config);
-            zhashx_insert(container_monitoring_actors, cgroup_path, perf_monitor);
+            monitor = container_monitor_create(perf_monitor);
+            if (!monitor) {
+                zsys_error("sensor: failed to allocate the monitor of cgroup=%s", cgroup_path);
+                zactor_destroy(&perf_monitor);
+                continue;
+            }
+            zhashx_insert(container_monitoring_actors, cgroup_path, monitor);
         } else {
             zhashx_freefn(running_targets, cgroup_path, (zhashx_free_fn *) target_destroy);
         }
@@ -126,6 +311,794 @@ out:
     zhashx_destroy(&running_targets);
 }
 
+#define CONTROL_DELIMITERS " \t\r\n"
+#define CONTROL_REPLY_MAX 256
+
+/*
+ * control_context stores the state of the sensor changed at runtime by the commands of the control socket and the
+ * reloads of the configuration.
+ */
+struct control_context
+{
+    struct config *config;
+    struct hwinfo **hwinfo;
+    struct perf_backend *backend;
+    struct work_pool *setup_pool;
+    struct perf_sampling_config *sampling;
+    struct target_discovery **discovery;
+    struct target_resolver **resolver;
+    zactor_t **system_perf_monitor;
+    bool system_paused; /* monitoring of the system suspended by the control socket */
+    zhashx_t *container_monitoring_actors; /* char *cgroup_path -> struct container_monitor *monitor */
+    zhashx_t *pending_targets; /* char *cgroup_path -> struct pending_target *pending */
+    zactor_t *reporting;
+    bool unattributed; /* accounting of the unattributed activity enabled in the reporting actor */
+    struct storage_module **storage;
+    struct config *storage_config; /* reloaded config referenced by the storage module, NULL for the running one */
+};
+
+static void
+start_system_monitor(struct control_context *control)
+{
+    struct target *system_target = NULL;
+    struct perf_config *monitor_config = NULL;
+
+    system_target = target_create(TARGET_TYPE_GLOBAL, NULL, NULL);
+    monitor_config = perf_config_create(*control->hwinfo, control->config->events.system, system_target, control->backend, control->setup_pool, control->sampling);
+    *control->system_perf_monitor = zactor_new(perf_monitoring_actor, monitor_config);
+    control->system_paused = false;
+}
+
+static void
+stop_containers_monitors(struct control_context *control)
+{
+    const struct container_monitor *monitor = NULL;
+
+    for (monitor = (const struct container_monitor *) zhashx_first(control->container_monitoring_actors); monitor; monitor = (const struct container_monitor *) zhashx_next(control->container_monitoring_actors)) {
+        target_resolver_invalidate(*control->resolver, (const char *) zhashx_cursor(control->container_monitoring_actors));
+    }
+
+    zhashx_purge(control->container_monitoring_actors);
+}
+
+static int
+send_actor_command(zactor_t *actor, zmsg_t *command)
+{
+    zmsg_t *copy = zmsg_dup(command);
+
+    if (!copy)
+        return -1;
+
+    if (zmsg_send(&copy, actor)) {
+        zmsg_destroy(&copy);
+        return -1;
+    }
+
+    return zsock_wait(actor) ? -1 : 0;
+}
+
+static unsigned int
+broadcast_actors_command(struct control_context *control, bool system, zmsg_t *command)
+{
+    struct container_monitor *monitor = NULL;
+    unsigned int failures = 0;
+
+    if (system)
+        return (*control->system_perf_monitor && send_actor_command(*control->system_perf_monitor, command)) ? 1 : 0;
+
+    for (monitor = (struct container_monitor *) zhashx_first(control->container_monitoring_actors); monitor; monitor = (struct container_monitor *) zhashx_next(control->container_monitoring_actors)) {
+        if (send_actor_command(monitor->actor, command)) {
+            zsys_error("sensor: control command failed for cgroup=%s", (const char *) zhashx_cursor(control->container_monitoring_actors));
+            failures++;
+        }
+    }
+
+    return failures;
+}
+
+static unsigned int
+add_events_group(struct control_context *control, zhashx_t *events_groups, struct events_group *events_group)
+{
+    bool system = (events_groups == control->config->events.system);
+    zmsg_t *command = NULL;
+    unsigned int failures;
+
+    /* the containers discovered later are monitored with the updated events groups */
+    zhashx_insert(events_groups, events_group->name, events_group);
+
+    /* the system is only monitored when it has events groups */
+    if (system && !*control->system_perf_monitor) {
+        start_system_monitor(control);
+        return 0;
+    }
+
+    /* the actors copy the group before replying */
+    command = zmsg_new();
+    zmsg_addstr(command, "ADD-GROUP");
+    zmsg_addmem(command, &events_group, sizeof(events_group));
+    failures = broadcast_actors_command(control, system, command);
+    zmsg_destroy(&command);
+    return failures;
+}
+
+static unsigned int
+remove_events_group(struct control_context *control, zhashx_t *events_groups, const char *group_name, bool readded)
+{
+    bool system = (events_groups == control->config->events.system);
+    zmsg_t *command = NULL;
+    unsigned int failures;
+
+    /* the name can be owned by the removed group */
+    command = zmsg_new();
+    zmsg_addstr(command, "REMOVE-GROUP");
+    zmsg_addstr(command, group_name);
+    zhashx_delete(events_groups, group_name);
+
+    /* the targets are no longer monitored without events groups, unless the group is added again right after */
+    if (zhashx_size(events_groups) == 0 && !readded) {
+        if (system)
+            zactor_destroy(control->system_perf_monitor);
+        else
+            stop_containers_monitors(control);
+
+        zmsg_destroy(&command);
+        return 0;
+    }
+
+    failures = broadcast_actors_command(control, system, command);
+    zmsg_destroy(&command);
+    return failures;
+}
+
+static unsigned int
+set_events_group_interval(struct control_context *control, zhashx_t *events_groups, struct events_group *events_group, unsigned int interval_ms)
+{
+    bool system = (events_groups == control->config->events.system);
+    struct events_group *changed_group = NULL;
+    zmsg_t *command = NULL;
+    unsigned int failures;
+
+    /* the group is shared with the perf actors, the containers discovered later are monitored with a changed copy */
+    changed_group = events_group_dup(events_group);
+    if (!changed_group) {
+        zsys_error("sensor: failed to copy the events group=%s", events_group->name);
+        return 1;
+    }
+
+    changed_group->interval_ms = interval_ms;
+    zhashx_update(events_groups, changed_group->name, changed_group);
+
+    command = zmsg_new();
+    zmsg_addstr(command, "SET-INTERVAL");
+    zmsg_addstr(command, changed_group->name);
+    zmsg_addstrf(command, "%u", interval_ms);
+    events_group_destroy(&changed_group);
+    failures = broadcast_actors_command(control, system, command);
+    zmsg_destroy(&command);
+    return failures;
+}
+
+static void
+update_unattributed_accounting(struct control_context *control)
+{
+    bool unattributed = is_unattributed_accountable(control->config);
+
+    if (unattributed == control->unattributed)
+        return;
+
+    zsock_send(control->reporting, "si", "UNATTRIBUTED", (int) unattributed);
+    control->unattributed = unattributed;
+    zsys_info("sensor: accounting of the unattributed activity %s", (unattributed) ? "enabled" : "disabled");
+}
+
+static zhashx_t *
+lookup_control_scope(struct control_context *control, const char *scope)
+{
+    if (!scope)
+        return NULL;
+
+    if (streq(scope, "system"))
+        return control->config->events.system;
+
+    if (streq(scope, "containers"))
+        return control->config->events.containers;
+
+    return NULL;
+}
+
+static bool
+is_interval_supported(struct control_context *control, unsigned int interval_ms)
+{
+    /* the ticker period is fixed at startup, it has to divide the sampling interval of every group */
+    return interval_ms % control->sampling->tick_ms == 0;
+}
+
+static int
+parse_control_interval(struct control_context *control, const char *interval, unsigned int *interval_ms, char *reply, size_t reply_size)
+{
+    if (!interval || str_to_uint(interval, interval_ms) || !is_interval_supported(control, *interval_ms)) {
+        snprintf(reply, reply_size, "ERROR interval must be 0 or a multiple of %u ms", control->sampling->tick_ms);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+reply_broadcast_result(unsigned int failures, char *reply, size_t reply_size)
+{
+    if (failures) {
+        snprintf(reply, reply_size, "ERROR command failed for %u targets", failures);
+        return -1;
+    }
+
+    snprintf(reply, reply_size, "OK");
+    return 0;
+}
+
+static int
+handle_control_add_group(struct control_context *control, char **saveptr, char *reply, size_t reply_size)
+{
+    const char *scope = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    const char *group_name = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    const char *interval = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    const char *event_name = NULL;
+    zhashx_t *events_groups = lookup_control_scope(control, scope);
+    unsigned int interval_ms = 0;
+    struct events_group *events_group = NULL;
+    int ret = -1;
+
+    if (!events_groups || !group_name) {
+        snprintf(reply, reply_size, "ERROR usage: ADD-GROUP system|containers NAME INTERVAL_MS EVENT...");
+        return -1;
+    }
+
+    if (zhashx_lookup(events_groups, group_name)) {
+        snprintf(reply, reply_size, "ERROR group %s already exists", group_name);
+        return -1;
+    }
+
+    if (parse_control_interval(control, interval, &interval_ms, reply, reply_size))
+        return -1;
+
+    events_group = events_group_create(group_name);
+    if (!events_group) {
+        snprintf(reply, reply_size, "ERROR failed to allocate group %s", group_name);
+        return -1;
+    }
+
+    events_group->interval_ms = interval_ms;
+    while ((event_name = strtok_r(NULL, CONTROL_DELIMITERS, saveptr))) {
+        if (events_group_append_event(events_group, event_name)) {
+            snprintf(reply, reply_size, "ERROR invalid event %s", event_name);
+            goto out;
+        }
+    }
+
+    if (events_group->num_events == 0) {
+        snprintf(reply, reply_size, "ERROR group %s has no events", group_name);
+        goto out;
+    }
+
+    ret = reply_broadcast_result(add_events_group(control, events_groups, events_group), reply, reply_size);
+
+out:
+    events_group_destroy(&events_group);
+    return ret;
+}
+
+static int
+handle_control_remove_group(struct control_context *control, char **saveptr, char *reply, size_t reply_size)
+{
+    const char *scope = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    const char *group_name = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    zhashx_t *events_groups = lookup_control_scope(control, scope);
+
+    if (!events_groups || !group_name) {
+        snprintf(reply, reply_size, "ERROR usage: REMOVE-GROUP system|containers NAME");
+        return -1;
+    }
+
+    if (!zhashx_lookup(events_groups, group_name)) {
+        snprintf(reply, reply_size, "ERROR group %s does not exist", group_name);
+        return -1;
+    }
+
+    return reply_broadcast_result(remove_events_group(control, events_groups, group_name, false), reply, reply_size);
+}
+
+static int
+handle_control_set_interval(struct control_context *control, char **saveptr, char *reply, size_t reply_size)
+{
+    const char *scope = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    const char *group_name = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    const char *interval = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    zhashx_t *events_groups = lookup_control_scope(control, scope);
+    struct events_group *events_group = NULL;
+    unsigned int interval_ms = 0;
+
+    if (!events_groups || !group_name) {
+        snprintf(reply, reply_size, "ERROR usage: SET-INTERVAL system|containers NAME INTERVAL_MS");
+        return -1;
+    }
+
+    events_group = (struct events_group *) zhashx_lookup(events_groups, group_name);
+    if (!events_group) {
+        snprintf(reply, reply_size, "ERROR group %s does not exist", group_name);
+        return -1;
+    }
+
+    if (parse_control_interval(control, interval, &interval_ms, reply, reply_size))
+        return -1;
+
+    return reply_broadcast_result(set_events_group_interval(control, events_groups, events_group, interval_ms), reply, reply_size);
+}
+
+static int
+pause_system_monitor(struct control_context *control, bool paused)
+{
+    if (paused == control->system_paused)
+        return 0;
+
+    if (paused) {
+        zstr_send(*control->system_perf_monitor, "DISABLE");
+    }
+    else {
+        zstr_send(*control->system_perf_monitor, "ENABLE");
+        if (zsock_wait(*control->system_perf_monitor))
+            return -1;
+    }
+
+    control->system_paused = paused;
+    return 0;
+}
+
+static int
+pause_container_monitor(struct control_context *control, const char *cgroup_path, struct container_monitor *monitor, bool paused)
+{
+    if (paused == monitor->paused)
+        return 0;
+
+    monitor->paused = paused;
+
+    /* the events of a departed container are already disabled, they are enabled again when it reappears */
+    if (monitor->departed_ms)
+        return 0;
+
+    if (paused) {
+        zstr_send(monitor->actor, "DISABLE");
+        return 0;
+    }
+
+    /* a recreated cgroup is monitored again by a new actor at the next discovery */
+    if (!container_monitor_resume(monitor)) {
+        target_resolver_invalidate(*control->resolver, cgroup_path);
+        zhashx_delete(control->container_monitoring_actors, cgroup_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+handle_control_pause(struct control_context *control, char **saveptr, bool paused, char *reply, size_t reply_size)
+{
+    const char *target = strtok_r(NULL, CONTROL_DELIMITERS, saveptr);
+    struct container_monitor *monitor = NULL;
+    zlistx_t *cgroup_paths = NULL;
+    const char *cgroup_path = NULL;
+    unsigned int failures = 0;
+
+    if (!target) {
+        snprintf(reply, reply_size, "ERROR usage: %s system|all|CGROUP_PATH", (paused) ? "PAUSE" : "RESUME");
+        return -1;
+    }
+
+    if (streq(target, "system") || streq(target, "all")) {
+        if (*control->system_perf_monitor)
+            failures += (pause_system_monitor(control, paused)) ? 1 : 0;
+        else if (streq(target, "system")) {
+            snprintf(reply, reply_size, "ERROR system is not monitored");
+            return -1;
+        }
+    }
+
+    if (streq(target, "all")) {
+        /* a cgroup whose monitoring cannot be resumed is removed from the monitored ones */
+        cgroup_paths = zhashx_keys(control->container_monitoring_actors);
+        for (cgroup_path = (const char *) zlistx_first(cgroup_paths); cgroup_path; cgroup_path = (const char *) zlistx_next(cgroup_paths)) {
+            monitor = (struct container_monitor *) zhashx_lookup(control->container_monitoring_actors, cgroup_path);
+            failures += (pause_container_monitor(control, cgroup_path, monitor, paused)) ? 1 : 0;
+        }
+        zlistx_destroy(&cgroup_paths);
+    }
+    else if (!streq(target, "system")) {
+        monitor = (struct container_monitor *) zhashx_lookup(control->container_monitoring_actors, target);
+        if (!monitor) {
+            snprintf(reply, reply_size, "ERROR cgroup %s is not monitored", target);
+            return -1;
+        }
+        failures += (pause_container_monitor(control, target, monitor, paused)) ? 1 : 0;
+    }
+
+    return reply_broadcast_result(failures, reply, reply_size);
+}
+
+static void
+handle_control_request(struct control_context *control, zsock_t *control_socket)
+{
+    char *request = zstr_recv(control_socket);
+    char reply[CONTROL_REPLY_MAX] = {};
+    char *saveptr = NULL;
+    const char *command = NULL;
+
+    if (!request)
+        return;
+
+    command = strtok_r(request, CONTROL_DELIMITERS, &saveptr);
+    if (!command)
+        snprintf(reply, sizeof(reply), "ERROR empty command");
+    else if (streq(command, "ADD-GROUP"))
+        handle_control_add_group(control, &saveptr, reply, sizeof(reply));
+    else if (streq(command, "REMOVE-GROUP"))
+        handle_control_remove_group(control, &saveptr, reply, sizeof(reply));
+    else if (streq(command, "SET-INTERVAL"))
+        handle_control_set_interval(control, &saveptr, reply, sizeof(reply));
+    else if (streq(command, "PAUSE"))
+        handle_control_pause(control, &saveptr, true, reply, sizeof(reply));
+    else if (streq(command, "RESUME"))
+        handle_control_pause(control, &saveptr, false, reply, sizeof(reply));
+    else
+        snprintf(reply, sizeof(reply), "ERROR unknown command %s", command);
+
+    zsys_info("sensor: control command %s: %s", (command) ? command : "", reply);
+
+    /* the groups and their intervals can be changed by the command */
+    update_unattributed_accounting(control);
+
+    /* the request socket expects a reply to every request */
+    zstr_send(control_socket, reply);
+    zstr_free(&request);
+}
+
+static void
+refresh_topology(struct control_context *control)
+{
+    struct hwinfo *hwinfo = NULL;
+    zmsg_t *command = NULL;
+    unsigned int failures;
+
+    /* the cpus brought online or offline are detected by polling sysfs at each discovery of the running containers */
+    hwinfo = hwinfo_create();
+    if (!hwinfo || hwinfo_detect(hwinfo)) {
+        zsys_error("hwinfo: error while detecting hardware information");
+        goto out;
+    }
+
+    if (hwinfo_equal(*control->hwinfo, hwinfo))
+        goto out;
+
+    zsys_info("hwinfo: topology changed, %zu cpus online on %zu packages (previously %zu cpus on %zu packages)", hwinfo->num_cpus, hwinfo->num_pkgs, (*control->hwinfo)->num_cpus, (*control->hwinfo)->num_pkgs);
+
+    /* the topology is sent by pointer, the actors take their own reference */
+    command = zmsg_new();
+    if (!command || zmsg_addstr(command, "SET-TOPOLOGY") || zmsg_addmem(command, &hwinfo, sizeof(hwinfo))) {
+        zsys_error("sensor: failed to build the topology update command");
+        goto out;
+    }
+
+    failures = broadcast_actors_command(control, true, command) + broadcast_actors_command(control, false, command);
+    if (failures)
+        zsys_warning("sensor: topology update failed for %u monitoring actors", failures);
+
+    /* the shared topology is replaced, the actors started from now on monitor the new cpus */
+    hwinfo_destroy(*control->hwinfo);
+    *control->hwinfo = hwinfo;
+    hwinfo = NULL;
+
+out:
+    zmsg_destroy(&command);
+    hwinfo_destroy(hwinfo);
+}
+
+static zsock_t *
+create_control_socket(const char *endpoint)
+{
+    zsock_t *socket = NULL;
+    mode_t mask;
+
+    /* only the user running the sensor can connect to the socket file */
+    mask = umask(S_IRWXG | S_IRWXO);
+    socket = zsock_new_rep(endpoint);
+    umask(mask);
+
+    return socket;
+}
+
+static int
+setup_reload_signal(void)
+{
+    sigset_t mask;
+
+    /* the threads created from now on inherit the mask, only the main loop receives the signal */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGHUP);
+    if (pthread_sigmask(SIG_BLOCK, &mask, NULL))
+        return -1;
+
+    return signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+}
+
+static bool
+receive_reload_signal(int reload_signal_fd)
+{
+    struct signalfd_siginfo siginfo;
+    bool requested = false;
+
+    /* the signals received since the last reload are merged */
+    while (read(reload_signal_fd, &siginfo, sizeof(siginfo)) == sizeof(siginfo))
+        requested = true;
+
+    return requested;
+}
+
+static bool
+wait_next_discovery(struct control_context *control, zsock_t *control_socket, int *reload_signal_fd, zpoller_t *control_poller, unsigned int interval_ms)
+{
+    int64_t deadline_ms = zclock_mono() + (int64_t) interval_ms;
+    int64_t remaining_ms;
+    void *which = NULL;
+
+    /* handle the control requests until the next discovery of the running containers or a reload of the config */
+    while (!zsys_interrupted && (remaining_ms = deadline_ms - zclock_mono()) > 0) {
+        which = zpoller_wait(control_poller, (int) remaining_ms);
+        if (control_socket && which == control_socket)
+            handle_control_request(control, control_socket);
+        else if (which == reload_signal_fd && receive_reload_signal(*reload_signal_fd))
+            return true;
+        else if (zpoller_terminated(control_poller))
+            break;
+    }
+
+    return false;
+}
+
+static void
+reload_events_groups(struct control_context *control, zhashx_t *events_groups, zhashx_t *new_events_groups)
+{
+    struct events_group *new_events_group = NULL;
+    struct events_group *events_group = NULL;
+    zlistx_t *groups_name = NULL;
+    const char *group_name = NULL;
+    unsigned int failures = 0;
+
+    for (new_events_group = (struct events_group *) zhashx_first(new_events_groups); new_events_group; new_events_group = (struct events_group *) zhashx_next(new_events_groups)) {
+        if (!is_interval_supported(control, new_events_group->interval_ms)) {
+            zsys_error("sensor: reload: interval of group=%s must be a multiple of %u ms, a restart is required", new_events_group->name, control->sampling->tick_ms);
+            continue;
+        }
+
+        events_group = (struct events_group *) zhashx_lookup(events_groups, new_events_group->name);
+        if (!events_group) {
+            failures += add_events_group(control, events_groups, new_events_group);
+            continue;
+        }
+
+        /* only the events of a changed group are reopened */
+        if (!events_group_has_same_events(events_group, new_events_group)) {
+            failures += remove_events_group(control, events_groups, new_events_group->name, true);
+            failures += add_events_group(control, events_groups, new_events_group);
+            continue;
+        }
+
+        if (events_group->interval_ms != new_events_group->interval_ms)
+            failures += set_events_group_interval(control, events_groups, events_group, new_events_group->interval_ms);
+    }
+
+    /* the groups are removed last to keep monitoring the targets having only changed groups */
+    groups_name = zhashx_keys(events_groups);
+    for (group_name = (const char *) zlistx_first(groups_name); group_name; group_name = (const char *) zlistx_next(groups_name)) {
+        if (!zhashx_lookup(new_events_groups, group_name))
+            failures += remove_events_group(control, events_groups, group_name, false);
+    }
+    zlistx_destroy(&groups_name);
+
+    if (failures)
+        zsys_error("sensor: reload: failed to apply the events groups changes to %u targets", failures);
+}
+
+static void
+reload_sampling_interval(struct control_context *control, unsigned int interval_ms)
+{
+    zmsg_t *command = NULL;
+    unsigned int failures = 0;
+
+    if (interval_ms == control->config->sensor.perf_sampling_interval_ms)
+        return;
+
+    if (!is_interval_supported(control, interval_ms)) {
+        zsys_error("sensor: reload: sampling interval must be a multiple of %u ms, a restart is required", control->sampling->tick_ms);
+        return;
+    }
+
+    control->config->sensor.perf_sampling_interval_ms = interval_ms;
+    control->sampling->interval_ms = interval_ms;
+
+    command = zmsg_new();
+    zmsg_addstr(command, "SET-SAMPLING-INTERVAL");
+    zmsg_addstrf(command, "%u", interval_ms);
+    failures += broadcast_actors_command(control, true, command);
+    failures += broadcast_actors_command(control, false, command);
+    zmsg_destroy(&command);
+
+    if (failures)
+        zsys_error("sensor: reload: failed to apply the sampling interval to %u targets", failures);
+}
+
+static bool
+are_patterns_equal(zlistx_t *patterns, zlistx_t *other_patterns)
+{
+    const char *pattern = NULL;
+    const char *other_pattern = NULL;
+
+    if (zlistx_size(patterns) != zlistx_size(other_patterns))
+        return false;
+
+    for (pattern = (const char *) zlistx_first(patterns), other_pattern = (const char *) zlistx_first(other_patterns);
+         pattern && other_pattern;
+         pattern = (const char *) zlistx_next(patterns), other_pattern = (const char *) zlistx_next(other_patterns)) {
+        if (strcmp(pattern, other_pattern))
+            return false;
+    }
+
+    return true;
+}
+
+static void
+reload_targets_discovery(struct control_context *control, struct config_sensor *new_sensor)
+{
+    struct config_sensor *sensor = &control->config->sensor;
+    bool is_basepath_changed = strcmp(sensor->cgroup_basepath, new_sensor->cgroup_basepath);
+    struct target_discovery *discovery = NULL;
+    struct target_resolver *resolver = NULL;
+    zlistx_t *patterns = NULL;
+
+    if (strcmp(sensor->host_root, new_sensor->host_root)) {
+        resolver = target_resolver_create(new_sensor->host_root);
+        if (resolver) {
+            target_resolver_destroy(control->resolver);
+            *control->resolver = resolver;
+            snprintf(sensor->host_root, PATH_MAX, "%s", new_sensor->host_root);
+        }
+        else
+            zsys_error("sensor: reload: failed to setup the cgroups name resolver");
+    }
+
+    if (!is_basepath_changed && sensor->cgroup_depth == new_sensor->cgroup_depth && !strcmp(sensor->cgroup_pattern, new_sensor->cgroup_pattern) &&
+        are_patterns_equal(sensor->cgroup_include, new_sensor->cgroup_include) && are_patterns_equal(sensor->cgroup_exclude, new_sensor->cgroup_exclude))
+        return;
+
+    /* the monitored cgroups reference the base path of the discovery */
+    if (is_basepath_changed) {
+        stop_containers_monitors(control);
+        zhashx_purge(control->pending_targets);
+        snprintf(sensor->cgroup_basepath, PATH_MAX, "%s", new_sensor->cgroup_basepath);
+    }
+
+    sensor->cgroup_depth = new_sensor->cgroup_depth;
+    snprintf(sensor->cgroup_pattern, PATH_MAX, "%s", new_sensor->cgroup_pattern);
+    patterns = sensor->cgroup_include;
+    sensor->cgroup_include = new_sensor->cgroup_include;
+    new_sensor->cgroup_include = patterns;
+    patterns = sensor->cgroup_exclude;
+    sensor->cgroup_exclude = new_sensor->cgroup_exclude;
+    new_sensor->cgroup_exclude = patterns;
+
+    /* the cgroups no longer matching the rules are handled as departed by the next discovery */
+    discovery = target_discovery_create(sensor->cgroup_basepath, sensor->cgroup_depth, sensor->cgroup_pattern, sensor->cgroup_include, sensor->cgroup_exclude);
+    if (!discovery) {
+        zsys_error("sensor: reload: failed to setup the cgroups discovery rules");
+        return;
+    }
+
+    target_discovery_destroy(control->discovery);
+    *control->discovery = discovery;
+}
+
+static int
+reload_storage(struct control_context *control, struct config *new_config)
+{
+    struct storage_module *storage = NULL;
+    struct storage_module *previous_storage = *control->storage;
+
+    storage = storage_module_create(new_config, &new_config->storage);
+    if (!storage) {
+        zsys_error("sensor: reload: failed to create '%s' storage module", storage_types_name[new_config->storage.type]);
+        return -1;
+    }
+
+    /* the running storage module is kept when the new one is not working */
+    if (storage_module_initialize(storage) || storage_module_ping(storage)) {
+        zsys_error("sensor: reload: failed to initialize '%s' storage module", storage_types_name[new_config->storage.type]);
+        storage_module_destroy(storage);
+        return -1;
+    }
+
+    zsock_send(control->reporting, "sp", "STORAGE", storage);
+    if (zsock_wait(control->reporting)) {
+        zsys_error("sensor: reload: failed to replace the storage module");
+        storage_module_destroy(storage);
+        return -1;
+    }
+
+    *control->storage = storage;
+    storage_module_destroy(previous_storage);
+    return 0;
+}
+
+static void
+warn_restart_required(const struct config_sensor *sensor, const struct config_sensor *new_sensor)
+{
+    if (sensor->aligned_ticks != new_sensor->aligned_ticks || sensor->overload_queue_depth != new_sensor->overload_queue_depth ||
+        sensor->overload_read_latency_ms != new_sensor->overload_read_latency_ms || sensor->overload_max_factor != new_sensor->overload_max_factor)
+        zsys_warning("sensor: reload: the ticks and overload settings are only applied after a restart");
+
+    if (sensor->adaptive_threshold != new_sensor->adaptive_threshold || sensor->adaptive_max_stride != new_sensor->adaptive_max_stride)
+        zsys_warning("sensor: reload: the adaptive sampling settings are only applied after a restart");
+
+    if (sensor->perf_setup_workers != new_sensor->perf_setup_workers || sensor->self_monitoring != new_sensor->self_monitoring ||
+        strcmp(sensor->trace_output, new_sensor->trace_output) || strcmp(sensor->control_endpoint, new_sensor->control_endpoint) ||
+        strcmp(sensor->name, new_sensor->name))
+        zsys_warning("sensor: reload: the name, setup workers, self monitoring, trace and control settings are only applied after a restart");
+}
+
+static void
+reload_config(struct control_context *control, int argc, char **argv)
+{
+    struct config *config = control->config;
+    struct config *new_config = NULL;
+    const struct config_storage *running_storage = (control->storage_config) ? &control->storage_config->storage : &config->storage;
+
+    zsys_info("sensor: reloading the configuration...");
+
+    /* the command-line arguments keep their precedence over the configuration file */
+    new_config = config_create();
+    if (!new_config) {
+        zsys_error("sensor: reload: failed to create config container");
+        return;
+    }
+    if (config_setup_from_cli(argc, argv, new_config) || config_validate(new_config)) {
+        zsys_error("sensor: reload: invalid configuration, keeping the running one");
+        goto out;
+    }
+
+    warn_restart_required(&config->sensor, &new_config->sensor);
+
+    /* only the changed parts are applied, the perf events of the unchanged groups stay open */
+    reload_events_groups(control, config->events.system, new_config->events.system);
+    reload_events_groups(control, config->events.containers, new_config->events.containers);
+    reload_sampling_interval(control, new_config->sensor.perf_sampling_interval_ms);
+    reload_targets_discovery(control, &new_config->sensor);
+
+    config->sensor.cgroup_discovery_interval_ms = new_config->sensor.cgroup_discovery_interval_ms;
+    config->sensor.min_lifetime_cycles = new_config->sensor.min_lifetime_cycles;
+    config->sensor.min_lifetime_ms = new_config->sensor.min_lifetime_ms;
+    config->sensor.cgroup_grace_period_ms = new_config->sensor.cgroup_grace_period_ms;
+    update_unattributed_accounting(control);
+
+    /* the storage module references the config it was created from */
+    if (!config_storage_equal(running_storage, &new_config->storage) && !reload_storage(control, new_config)) {
+        config_destroy(control->storage_config);
+        control->storage_config = new_config;
+        new_config = NULL;
+    }
+
+    zsys_info("sensor: configuration reloaded");
+
+out:
+    config_destroy(new_config);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -139,17 +1112,40 @@ main(int argc, char **argv)
     struct report_config reporting_conf = {};
     zactor_t *reporting = NULL;
     zhashx_t *cgroups_running = NULL; /* char *cgroup_name -> char *cgroup_absolute_path */
-    zhashx_t *container_monitoring_actors = NULL; /* char *actor_name -> zactor_t *actor */
+    zhashx_t *container_monitoring_actors = NULL; /* char *cgroup_path -> struct container_monitor *monitor */
+    zhashx_t *pending_targets = NULL; /* char *cgroup_path -> struct pending_target *pending */
     struct ticker_config *ticker_conf = NULL;
     zactor_t *ticker = NULL;
     struct target *system_target = NULL;
     struct perf_config *system_monitor_config = NULL;
     zactor_t *system_perf_monitor = NULL;
+    struct target_discovery *cgroup_discovery = NULL;
+    struct target_resolver *cgroup_resolver = NULL;
+    struct perf_backend *perf_backend = NULL;
+    struct work_pool *perf_setup_pool = NULL;
+    struct perf_sampling_config sampling_conf = {};
+    struct overload_monitor *overload = NULL;
+    struct trace_writer *trace = NULL;
+    struct self_monitor_config *self_monitor_conf = NULL;
+    zactor_t *self_monitor = NULL;
+    struct control_context control = {};
+    zsock_t *control_socket = NULL;
+    zpoller_t *control_poller = NULL;
+    int reload_signal_fd = -1;
+    bool reload_requested = false;
 
     signal(SIGPIPE, SIG_IGN);
 
+    /* must be done before any thread is started */
+    reload_signal_fd = setup_reload_signal();
+    if (reload_signal_fd == -1) {
+        fprintf(stderr, "sensor: failed to setup the reload signal handling\n");
+        return ret;
+    }
+
     if (!zsys_init()) {
         fprintf(stderr, "czmq: failed to initialize zsys context\n");
+        close(reload_signal_fd);
         return ret;
     }
 
@@ -236,8 +1232,17 @@ main(int argc, char **argv)
         goto cleanup;
     }
 
+    /* start the runtime control socket only when needed, before the threads creating files are started */
+    if (config->sensor.control_endpoint[0] != '\0') {
+        control_socket = create_control_socket(config->sensor.control_endpoint);
+        if (!control_socket) {
+            zsys_error("sensor: failed to bind the control socket to '%s'", config->sensor.control_endpoint);
+            goto cleanup;
+        }
+    }
+
     /* setup storage module */
-    storage = setup_storage_module(config);
+    storage = storage_module_create(config, &config->storage);
     if (!storage) {
         zsys_error("sensor: failed to create '%s' storage module", storage_types_name[config->storage.type]);
         goto cleanup;
@@ -255,45 +1260,167 @@ main(int argc, char **argv)
     zsys_info("sensor: configuration is valid, starting monitoring...");
 
     /* start reporting actor */
+    /* setup the overload detection only when needed */
+    if (config->sensor.overload_queue_depth || config->sensor.overload_read_latency_ms) {
+        overload = overload_monitor_create(config->sensor.overload_queue_depth, config->sensor.overload_read_latency_ms, config->sensor.overload_max_factor);
+        if (!overload) {
+            zsys_error("sensor: failed to create the overload monitor");
+            goto cleanup;
+        }
+    }
+
     reporting_conf = (struct report_config){
-        .storage = storage
+        .storage = storage,
+        .unattributed = is_unattributed_accountable(config),
+        .overload = overload
     };
     reporting = zactor_new(reporting_actor, &reporting_conf);
 
+    /* the perf actors access the events counters through the kernel perf_event subsystem */
+    perf_backend = perf_backend_kernel_create();
+    if (!perf_backend) {
+        zsys_error("sensor: failed to create the perf backend");
+        goto cleanup;
+    }
+
+    /* start the workers opening the perf events */
+    if (config->sensor.perf_setup_workers > 1) {
+        perf_setup_pool = work_pool_create(config->sensor.perf_setup_workers);
+        if (!perf_setup_pool) {
+            zsys_error("sensor: failed to start the perf setup workers");
+            goto cleanup;
+        }
+    }
+
+    /* capture the raw samples read by the perf actors only when requested */
+    if (config->sensor.trace_output[0] != '\0') {
+        trace = trace_writer_create(config->sensor.trace_output);
+        if (!trace) {
+            zsys_error("sensor: failed to create the trace file");
+            goto cleanup;
+        }
+    }
+
+    /* setup the sampling rate of the perf actors */
+    sampling_conf = (struct perf_sampling_config){
+        .tick_ms = compute_ticker_interval(compute_ticker_interval(config->sensor.perf_sampling_interval_ms, config->events.system), config->events.containers),
+        .interval_ms = config->sensor.perf_sampling_interval_ms,
+        .activity_threshold = config->sensor.adaptive_threshold,
+        .max_stride = config->sensor.adaptive_max_stride,
+        .overload = overload,
+        .trace = trace
+    };
+
     /* start ticker actor */
-    ticker_conf = ticker_config_create(config->sensor.perf_sampling_interval_ms);
+    /* the ticker period divides the sampling interval of every events group */
+    ticker_conf = ticker_config_create(sampling_conf.tick_ms, config->sensor.aligned_ticks, overload);
     ticker = zactor_new(ticker_actor, ticker_conf);
 
     /* start system monitoring actor only when needed */
     if (zhashx_size(config->events.system)) {
         system_target = target_create(TARGET_TYPE_GLOBAL, NULL, NULL);
-        system_monitor_config = perf_config_create(hwinfo, config->events.system, system_target);
+        system_monitor_config = perf_config_create(hwinfo, config->events.system, system_target, perf_backend, perf_setup_pool, &sampling_conf);
         system_perf_monitor = zactor_new(perf_monitoring_actor, system_monitor_config);
     }
 
+    /* start self monitoring actor only when needed, it reports at the sampling interval of the sensor */
+    if (config->sensor.self_monitoring) {
+        self_monitor_conf = self_monitor_config_create(config->sensor.perf_sampling_interval_ms / sampling_conf.tick_ms, overload);
+        if (!self_monitor_conf) {
+            zsys_error("sensor: failed to create the self monitoring config");
+            goto cleanup;
+        }
+        self_monitor = zactor_new(self_monitoring_actor, self_monitor_conf);
+    }
+
+    /* setup the cgroups discovery rules */
+    cgroup_discovery = target_discovery_create(config->sensor.cgroup_basepath, config->sensor.cgroup_depth, config->sensor.cgroup_pattern, config->sensor.cgroup_include, config->sensor.cgroup_exclude);
+    if (!cgroup_discovery) {
+        zsys_error("sensor: failed to setup the cgroups discovery rules");
+        goto cleanup;
+    }
+
+    /* setup the cgroups name resolver */
+    cgroup_resolver = target_resolver_create(config->sensor.host_root);
+    if (!cgroup_resolver) {
+        zsys_error("sensor: failed to setup the cgroups name resolver");
+        goto cleanup;
+    }
+
     /* monitor running containers */
     container_monitoring_actors = zhashx_new();
-    zhashx_set_destructor(container_monitoring_actors, (zhashx_destructor_fn *) zactor_destroy);
+    zhashx_set_destructor(container_monitoring_actors, (zhashx_destructor_fn *) container_monitor_destroy);
+    pending_targets = zhashx_new();
+    zhashx_set_destructor(pending_targets, (zhashx_destructor_fn *) ptrfree);
+
+    /* state changed at runtime by the control socket and the reloads */
+    control = (struct control_context){
+        .config = config,
+        .hwinfo = &hwinfo,
+        .backend = perf_backend,
+        .setup_pool = perf_setup_pool,
+        .sampling = &sampling_conf,
+        .discovery = &cgroup_discovery,
+        .resolver = &cgroup_resolver,
+        .system_perf_monitor = &system_perf_monitor,
+        .system_paused = false,
+        .container_monitoring_actors = container_monitoring_actors,
+        .pending_targets = pending_targets,
+        .reporting = reporting,
+        .unattributed = reporting_conf.unattributed,
+        .storage = &storage,
+        .storage_config = NULL
+    };
+    control_poller = zpoller_new(&reload_signal_fd, NULL);
+    if (!control_poller) {
+        zsys_error("sensor: failed to create the control poller");
+        goto cleanup;
+    }
+    if (control_socket && zpoller_add(control_poller, control_socket)) {
+        zsys_error("sensor: failed to poll the control socket");
+        goto cleanup;
+    }
+
     while (!zsys_interrupted) {
+        if (reload_requested) {
+            reload_requested = false;
+            reload_config(&control, argc, argv);
+        }
+
+        refresh_topology(&control);
+
         /* monitor containers only when needed */
         if (zhashx_size(config->events.containers)) {
-            sync_cgroups_running_monitored(hwinfo, config->events.containers, config->sensor.cgroup_basepath, container_monitoring_actors);
+            sync_cgroups_running_monitored(&config->sensor, hwinfo, perf_backend, perf_setup_pool, &sampling_conf, config->events.containers, cgroup_discovery, cgroup_resolver, pending_targets, container_monitoring_actors);
         }
 
-        zclock_sleep((int)config->sensor.cgroup_discovery_interval_ms);
+        reload_requested = wait_next_discovery(&control, control_socket, &reload_signal_fd, control_poller, config->sensor.cgroup_discovery_interval_ms);
     }
 
     ret = 0;
 
 cleanup:
+    zpoller_destroy(&control_poller);
+    zsock_destroy(&control_socket);
+    close(reload_signal_fd);
     zactor_destroy(&ticker);
     zhashx_destroy(&cgroups_running);
     zhashx_destroy(&container_monitoring_actors);
+    zhashx_destroy(&pending_targets);
     zactor_destroy(&system_perf_monitor);
+    zactor_destroy(&self_monitor);
+    work_pool_destroy(&perf_setup_pool);
+    perf_backend_destroy(perf_backend);
+    trace_writer_destroy(&trace);
+    target_discovery_destroy(&cgroup_discovery);
+    target_resolver_destroy(&cgroup_resolver);
     zactor_destroy(&reporting);
+    overload_monitor_destroy(&overload);
     storage_module_destroy(storage);
+    config_destroy(control.storage_config);
     config_destroy(config);
     pmu_topology_destroy(sys_pmu_topology);
+    event_encodings_clear();
     pmu_deinitialize();
     hwinfo_destroy(hwinfo);
     zsys_shutdown();
@@ -33,12 +33,27 @@
 #include <strings.h>
 
 #include "storage.h"
+#include "storage_null.h"
+#include "storage_csv.h"
+#include "storage_socket.h"
+#include "storage_columnar.h"
+#include "storage_timeseries.h"
+#include "storage_fanout.h"
+#include "storage_prometheus.h"
+
+#ifdef HAVE_MONGODB
+#include "storage_mongodb.h"
+#endif
 
 const char *storage_types_name[] = {
     [STORAGE_UNKNOWN] = "unknown",
     [STORAGE_NULL] = "null",
     [STORAGE_CSV] = "csv",
     [STORAGE_SOCKET] = "socket",
+    [STORAGE_COLUMNAR] = "columnar",
+    [STORAGE_TIMESERIES] = "timeseries",
+    [STORAGE_FANOUT] = "fanout",
+    [STORAGE_PROMETHEUS] = "prometheus",
 #ifdef HAVE_MONGODB
     [STORAGE_MONGODB] = "mongodb",
 #endif
@@ -59,6 +74,22 @@ storage_module_get_type(const char *type_name)
         return STORAGE_SOCKET;
     }
 
+    if (strcasecmp(type_name, storage_types_name[STORAGE_COLUMNAR]) == 0) {
+        return STORAGE_COLUMNAR;
+    }
+
+    if (strcasecmp(type_name, storage_types_name[STORAGE_TIMESERIES]) == 0) {
+        return STORAGE_TIMESERIES;
+    }
+
+    if (strcasecmp(type_name, storage_types_name[STORAGE_FANOUT]) == 0) {
+        return STORAGE_FANOUT;
+    }
+
+    if (strcasecmp(type_name, storage_types_name[STORAGE_PROMETHEUS]) == 0) {
+        return STORAGE_PROMETHEUS;
+    }
+
 #ifdef HAVE_MONGODB
     if (strcasecmp(type_name, storage_types_name[STORAGE_MONGODB]) == 0) {
         return STORAGE_MONGODB;
@@ -68,6 +99,34 @@ storage_module_get_type(const char *type_name)
     return STORAGE_UNKNOWN;
 }
 
+struct storage_module *
+storage_module_create(struct config *config, const struct config_storage *storage)
+{
+    switch (storage->type)
+    {
+        case STORAGE_NULL:
+            return storage_null_create(config, storage);
+        case STORAGE_CSV:
+            return storage_csv_create(config, storage);
+        case STORAGE_SOCKET:
+            return storage_socket_create(config, storage);
+        case STORAGE_COLUMNAR:
+            return storage_columnar_create(config, storage);
+        case STORAGE_TIMESERIES:
+            return storage_timeseries_create(config, storage);
+        case STORAGE_FANOUT:
+            return storage_fanout_create(config, storage);
+        case STORAGE_PROMETHEUS:
+            return storage_prometheus_create(config, storage);
+#ifdef HAVE_MONGODB
+        case STORAGE_MONGODB:
+            return storage_mongodb_create(config, storage);
+#endif
+        default:
+            return NULL;
+    }
+}
+
 int
 storage_module_initialize(struct storage_module *module)
 {
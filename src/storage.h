@@ -35,6 +35,9 @@
 #include "payload.h"
 #include "report.h"
 
+struct config;
+struct config_storage;
+
 /*
  * storage_type enumeration allows to select a storage type to generate.
  */
@@ -44,6 +47,10 @@ enum storage_type
     STORAGE_NULL,
     STORAGE_CSV,
     STORAGE_SOCKET,
+    STORAGE_COLUMNAR,
+    STORAGE_TIMESERIES,
+    STORAGE_FANOUT,
+    STORAGE_PROMETHEUS,
 #ifdef HAVE_MONGODB
     STORAGE_MONGODB,
 #endif
@@ -74,6 +81,11 @@ struct storage_module
  */
 enum storage_type storage_module_get_type(const char *type_name);
 
+/*
+ * storage_module_create creates the storage module described by the given storage config.
+ */
+struct storage_module *storage_module_create(struct config *config, const struct config_storage *storage);
+
 /*
  * storage_module_initialize initialize the storage module.
  */
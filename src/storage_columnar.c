@@ -0,0 +1,498 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <endian.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h>
+#include <linux/limits.h>
+
+#include "storage.h"
+#include "storage_columnar.h"
+#include "config.h"
+#include "util.h"
+
+static int
+write_string(FILE *file, const char *str)
+{
+    size_t len = strlen(str);
+    uint16_t len16 = htole16((uint16_t) len);
+
+    if (len > UINT16_MAX)
+        return -1;
+
+    if (fwrite(&len16, sizeof(len16), 1, file) != 1)
+        return -1;
+
+    if (len && fwrite(str, len, 1, file) != 1)
+        return -1;
+
+    return 0;
+}
+
+static int
+flush_row_group(struct columnar_group_writer *writer, unsigned int row_group_size)
+{
+    const uint32_t num_rows = (uint32_t) writer->num_rows;
+    const uint32_t num_rows_le = htole32(num_rows);
+    const uint32_t num_new_targets = htole32((uint32_t) zlistx_size(writer->new_targets));
+    const char *target_name = NULL;
+
+    if (writer->num_rows == 0)
+        return 0;
+
+    if (fwrite(COLUMNAR_ROW_GROUP_MAGIC, strlen(COLUMNAR_ROW_GROUP_MAGIC), 1, writer->file) != 1 ||
+        fwrite(&num_rows_le, sizeof(num_rows_le), 1, writer->file) != 1 ||
+        fwrite(&num_new_targets, sizeof(num_new_targets), 1, writer->file) != 1)
+        return -1;
+
+    for (target_name = (const char *) zlistx_first(writer->new_targets); target_name; target_name = (const char *) zlistx_next(writer->new_targets)) {
+        if (write_string(writer->file, target_name))
+            return -1;
+    }
+
+    if (fwrite(writer->timestamps, sizeof(uint64_t), num_rows, writer->file) != num_rows ||
+        fwrite(writer->targets, sizeof(uint32_t), num_rows, writer->file) != num_rows ||
+        fwrite(writer->sockets, sizeof(uint32_t), num_rows, writer->file) != num_rows ||
+        fwrite(writer->cpus, sizeof(uint32_t), num_rows, writer->file) != num_rows ||
+        fwrite(writer->intervals_ms, sizeof(uint64_t), num_rows, writer->file) != num_rows ||
+        fwrite(writer->overload_factors, sizeof(uint32_t), num_rows, writer->file) != num_rows ||
+        fwrite(writer->partials, sizeof(uint8_t), num_rows, writer->file) != num_rows)
+        return -1;
+
+    for (size_t event_i = 0; event_i < writer->num_events; event_i++) {
+        if (fwrite(writer->values + event_i * row_group_size, sizeof(uint64_t), num_rows, writer->file) != num_rows)
+            return -1;
+    }
+
+    fflush(writer->file);
+
+    zlistx_purge(writer->new_targets);
+    writer->num_rows = 0;
+    return 0;
+}
+
+static void
+group_writer_destroy(struct columnar_group_writer **writer_ptr)
+{
+    struct columnar_group_writer *writer = *writer_ptr;
+
+    if (!writer)
+        return;
+
+    if (writer->file) {
+        fflush(writer->file);
+        fsync(fileno(writer->file));
+        fclose(writer->file);
+    }
+
+    zlistx_destroy(&writer->events_name);
+    free(writer->timestamps);
+    free(writer->targets);
+    free(writer->sockets);
+    free(writer->cpus);
+    free(writer->intervals_ms);
+    free(writer->overload_factors);
+    free(writer->partials);
+    free(writer->values);
+    zhashx_destroy(&writer->targets_dict);
+    zlistx_destroy(&writer->new_targets);
+    free(writer);
+    *writer_ptr = NULL;
+}
+
+static struct columnar_group_writer *
+group_writer_create(zlistx_t *events_name, unsigned int row_group_size)
+{
+    struct columnar_group_writer *writer = (struct columnar_group_writer *) malloc(sizeof(struct columnar_group_writer));
+
+    if (!writer)
+        return NULL;
+
+    writer->file = NULL;
+    writer->events_name = events_name;
+    writer->num_events = zlistx_size(events_name);
+    writer->num_rows = 0;
+    writer->timestamps = (uint64_t *) calloc(row_group_size, sizeof(uint64_t));
+    writer->targets = (uint32_t *) calloc(row_group_size, sizeof(uint32_t));
+    writer->sockets = (uint32_t *) calloc(row_group_size, sizeof(uint32_t));
+    writer->cpus = (uint32_t *) calloc(row_group_size, sizeof(uint32_t));
+    writer->intervals_ms = (uint64_t *) calloc(row_group_size, sizeof(uint64_t));
+    writer->overload_factors = (uint32_t *) calloc(row_group_size, sizeof(uint32_t));
+    writer->partials = (uint8_t *) calloc(row_group_size, sizeof(uint8_t));
+    writer->values = (uint64_t *) calloc(writer->num_events * row_group_size, sizeof(uint64_t));
+
+    writer->targets_dict = zhashx_new();
+    zhashx_set_duplicator(writer->targets_dict, (zhashx_duplicator_fn *) uint64ptrdup);
+    zhashx_set_destructor(writer->targets_dict, (zhashx_destructor_fn *) ptrfree);
+
+    writer->new_targets = zlistx_new();
+    zlistx_set_duplicator(writer->new_targets, (zlistx_duplicator_fn *) strdup);
+    zlistx_set_destructor(writer->new_targets, (zlistx_destructor_fn *) ptrfree);
+
+    if (!writer->timestamps || !writer->targets || !writer->sockets || !writer->cpus || !writer->intervals_ms || !writer->overload_factors || !writer->partials || !writer->values) {
+        group_writer_destroy(&writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+static struct columnar_context *
+columnar_context_create(const char *sensor_name, const char *output_dir, unsigned int row_group_size)
+{
+    struct columnar_context *ctx = (struct columnar_context *) malloc(sizeof(struct columnar_context));
+
+    if (!ctx)
+        return NULL;
+
+    ctx->config.sensor_name = sensor_name;
+    ctx->config.output_dir = output_dir;
+    ctx->config.row_group_size = (row_group_size) ? row_group_size : COLUMNAR_DEFAULT_ROW_GROUP_SIZE;
+
+    ctx->groups_writer = zhashx_new();
+    zhashx_set_destructor(ctx->groups_writer, (zhashx_destructor_fn *) group_writer_destroy);
+
+    return ctx;
+}
+
+static void
+columnar_context_destroy(struct columnar_context *ctx)
+{
+    if (!ctx)
+        return;
+
+    zhashx_destroy(&ctx->groups_writer);
+    free(ctx);
+}
+
+static int
+columnar_initialize(struct storage_module *module)
+{
+    struct columnar_context *ctx = (struct columnar_context *) module->context;
+    struct stat outdir_stat = {};
+
+    errno = 0;
+    if (mkdir(ctx->config.output_dir, 0755) == -1 && errno != EEXIST) {
+        zsys_error("columnar: failed to create output directory: %s", strerror(errno));
+        return -1;
+    }
+
+    errno = 0;
+    if (stat(ctx->config.output_dir, &outdir_stat) == -1) {
+        zsys_error("columnar: failed to check output dir: %s", strerror(errno));
+        return -1;
+    }
+    if (!S_ISDIR(outdir_stat.st_mode)) {
+        zsys_error("columnar: output path already exists and is not a directory");
+        return -1;
+    }
+
+    errno = 0;
+    if (access(ctx->config.output_dir, W_OK)) {
+        zsys_error("columnar: output path is not writable: %s", strerror(errno));
+        return -1;
+    }
+
+    module->is_initialized = true;
+    return 0;
+}
+
+static int
+columnar_ping(struct storage_module *module __attribute__ ((unused)))
+{
+    /* ping is not needed because the relevant checks are done when initializing the module */
+    return 0;
+}
+
+static int
+build_segment_path(struct columnar_context *ctx, const char *group_name, unsigned int attempt, char *path)
+{
+    char timestamp[32] = {};
+    time_t now = time(NULL);
+    struct tm tm = {};
+    int len;
+
+    if (!gmtime_r(&now, &tm) || !strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%SZ", &tm))
+        return -1;
+
+    if (attempt == 0)
+        len = snprintf(path, PATH_MAX, "%s/%s-%s.hwpcc", ctx->config.output_dir, group_name, timestamp);
+    else
+        len = snprintf(path, PATH_MAX, "%s/%s-%s-%u.hwpcc", ctx->config.output_dir, group_name, timestamp, attempt);
+
+    return len >= PATH_MAX;
+}
+
+static int
+open_group_outfile(struct columnar_context *ctx, const char *group_name, struct columnar_group_writer *writer)
+{
+    char path[PATH_MAX] = {};
+    const uint32_t num_events = htole32((uint32_t) writer->num_events);
+    const char *event_name = NULL;
+    int fd = -1;
+
+    /* files opened during the same second, by a quick restart or a reinitialization, get a numbered suffix */
+    for (unsigned int attempt = 0; fd == -1 && attempt < COLUMNAR_SEGMENT_NAME_MAX_ATTEMPTS; attempt++) {
+        if (build_segment_path(ctx, group_name, attempt, path)) {
+            zsys_error("columnar: the destination path for output file of group %s is too long", group_name);
+            return -1;
+        }
+
+        errno = 0;
+        fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd == -1 && errno != EEXIST)
+            break;
+    }
+
+    if (fd == -1) {
+        zsys_error("columnar: failed to open output file for group %s: %s", group_name, strerror(errno));
+        return -1;
+    }
+
+    writer->file = fdopen(fd, "w");
+    if (!writer->file) {
+        zsys_error("columnar: failed to associate a stream to output file of group %s: %s", group_name, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    if (fwrite(COLUMNAR_FILE_MAGIC, strlen(COLUMNAR_FILE_MAGIC), 1, writer->file) != 1 || fwrite(&num_events, sizeof(num_events), 1, writer->file) != 1)
+        return -1;
+
+    for (event_name = (const char *) zlistx_first(writer->events_name); event_name; event_name = (const char *) zlistx_next(writer->events_name)) {
+        if (write_string(writer->file, event_name))
+            return -1;
+    }
+
+    if (write_string(writer->file, ctx->config.sensor_name))
+        return -1;
+
+    return 0;
+}
+
+static struct columnar_group_writer *
+setup_group_writer(struct columnar_context *ctx, const char *group_name, zhashx_t *events)
+{
+    zlistx_t *events_name = NULL;
+    struct columnar_group_writer *writer = NULL;
+
+    /* the schema of the group is defined by the events of its first report */
+    events_name = zhashx_keys(events);
+    if (!events_name)
+        return NULL;
+
+    zlistx_set_comparator(events_name, (zlistx_comparator_fn *) strcmp);
+    zlistx_sort(events_name);
+
+    writer = group_writer_create(events_name, ctx->config.row_group_size);
+    if (!writer) {
+        zlistx_destroy(&events_name);
+        return NULL;
+    }
+
+    if (open_group_outfile(ctx, group_name, writer)) {
+        group_writer_destroy(&writer);
+        return NULL;
+    }
+
+    zhashx_insert(ctx->groups_writer, group_name, writer);
+    return writer;
+}
+
+static int
+lookup_target_index(struct columnar_group_writer *writer, const char *target_name, uint32_t *target_idx)
+{
+    uint64_t *idx = NULL;
+    uint64_t new_idx;
+
+    idx = (uint64_t *) zhashx_lookup(writer->targets_dict, target_name);
+    if (idx) {
+        *target_idx = (uint32_t) *idx;
+        return 0;
+    }
+
+    new_idx = zhashx_size(writer->targets_dict);
+    if (zhashx_insert(writer->targets_dict, target_name, &new_idx))
+        return -1;
+
+    zlistx_add_end(writer->new_targets, (void *) target_name);
+    *target_idx = (uint32_t) new_idx;
+    return 0;
+}
+
+static int
+append_row(struct columnar_context *ctx, struct columnar_group_writer *writer, const struct payload *payload, uint32_t target_idx, const char *pkg_id, const char *cpu_id, zhashx_t *events)
+{
+    const size_t row = writer->num_rows;
+    unsigned int socket = 0;
+    unsigned int cpu = 0;
+    const char *event_name = NULL;
+    const uint64_t *event_value = NULL;
+    size_t event_i = 0;
+
+    if (str_to_uint(pkg_id, &socket) || str_to_uint(cpu_id, &cpu))
+        return -1;
+
+    for (event_name = (const char *) zlistx_first(writer->events_name); event_name; event_name = (const char *) zlistx_next(writer->events_name), event_i++) {
+        event_value = (const uint64_t *) zhashx_lookup(events, event_name);
+        if (!event_value)
+            return -1;
+
+        writer->values[event_i * ctx->config.row_group_size + row] = htole64(*event_value);
+    }
+
+    /* the columns are stored in the byte order of the file */
+    writer->timestamps[row] = htole64(payload->timestamp);
+    writer->targets[row] = htole32(target_idx);
+    writer->sockets[row] = htole32(socket);
+    writer->cpus[row] = htole32(cpu);
+    writer->intervals_ms[row] = htole64(payload->interval_ms);
+    writer->overload_factors[row] = htole32(payload->overload_factor);
+    writer->partials[row] = (payload->partial) ? 1 : 0;
+    writer->num_rows++;
+
+    if (writer->num_rows == ctx->config.row_group_size)
+        return flush_row_group(writer, ctx->config.row_group_size);
+
+    return 0;
+}
+
+static int
+columnar_store_report(struct storage_module *module, struct payload *payload)
+{
+    struct columnar_context *ctx = (struct columnar_context *) module->context;
+    struct payload_group_data *group_data = NULL;
+    const char *group_name = NULL;
+    struct columnar_group_writer *writer = NULL;
+    uint32_t target_idx = 0;
+    struct payload_pkg_data *pkg_data = NULL;
+    const char *pkg_id = NULL;
+    struct payload_cpu_data *cpu_data = NULL;
+    const char *cpu_id = NULL;
+
+    for (group_data = (struct payload_group_data *) zhashx_first(payload->groups); group_data; group_data = (struct payload_group_data *) zhashx_next(payload->groups)) {
+        group_name = (const char *) zhashx_cursor(payload->groups);
+        writer = (struct columnar_group_writer *) zhashx_lookup(ctx->groups_writer, group_name);
+
+        for (pkg_data = (struct payload_pkg_data *) zhashx_first(group_data->pkgs); pkg_data; pkg_data = (struct payload_pkg_data *) zhashx_next(group_data->pkgs)) {
+            pkg_id = (const char *) zhashx_cursor(group_data->pkgs);
+
+            for (cpu_data = (struct payload_cpu_data *) zhashx_first(pkg_data->cpus); cpu_data; cpu_data = (struct payload_cpu_data *) zhashx_next(pkg_data->cpus)) {
+                cpu_id = (const char *) zhashx_cursor(pkg_data->cpus);
+
+                if (!writer) {
+                    writer = setup_group_writer(ctx, group_name, cpu_data->events);
+                    if (!writer) {
+                        zsys_error("columnar: failed to setup output file for group=%s", group_name);
+                        return -1;
+                    }
+                }
+
+                if (lookup_target_index(writer, payload->target_name, &target_idx)) {
+                    zsys_error("columnar: failed to store target name for group=%s target=%s", group_name, payload->target_name);
+                    return -1;
+                }
+
+                if (append_row(ctx, writer, payload, target_idx, pkg_id, cpu_id, cpu_data->events)) {
+                    zsys_error("columnar: failed to write report for group=%s timestamp=%" PRIu64, group_name, payload->timestamp);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int
+columnar_deinitialize(struct storage_module *module)
+{
+    struct columnar_context *ctx = (struct columnar_context *) module->context;
+    struct columnar_group_writer *writer = NULL;
+    const char *group_name = NULL;
+
+    if (!module->is_initialized)
+        return 0;
+
+    /* write the partially filled row groups */
+    for (writer = (struct columnar_group_writer *) zhashx_first(ctx->groups_writer); writer; writer = (struct columnar_group_writer *) zhashx_next(ctx->groups_writer)) {
+        group_name = (const char *) zhashx_cursor(ctx->groups_writer);
+        if (flush_row_group(writer, ctx->config.row_group_size))
+            zsys_error("columnar: failed to write the last row group for group=%s", group_name);
+    }
+
+    /* close the output files, a new file is created for each group if the module is initialized again */
+    zhashx_purge(ctx->groups_writer);
+
+    module->is_initialized = false;
+    return 0;
+}
+
+static void
+columnar_destroy(struct storage_module *module)
+{
+    if (!module)
+        return;
+
+    columnar_context_destroy((struct columnar_context *) module->context);
+}
+
+struct storage_module *
+storage_columnar_create(struct config *config, const struct config_storage *storage)
+{
+    struct storage_module *module = NULL;
+    struct columnar_context *ctx = NULL;
+
+    module = (struct storage_module *) malloc(sizeof(struct storage_module));
+    if (!module)
+        goto error;
+
+    ctx = columnar_context_create(config->sensor.name, storage->columnar.outdir, storage->columnar.row_group_size);
+    if (!ctx)
+        goto error;
+
+    module->type = STORAGE_COLUMNAR;
+    module->context = ctx;
+    module->is_initialized = false;
+    module->initialize = columnar_initialize;
+    module->ping = columnar_ping;
+    module->store_report = columnar_store_report;
+    module->deinitialize = columnar_deinitialize;
+    module->destroy = columnar_destroy;
+
+    return module;
+
+error:
+    columnar_context_destroy(ctx);
+    free(module);
+    return NULL;
+}
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef STORAGE_COLUMNAR_H
+#define STORAGE_COLUMNAR_H
+
+#include <czmq.h>
+#include <stdint.h>
+
+#include "storage.h"
+#include "config.h"
+
+/*
+ * The columnar storage module writes the reports of each events group into a binary file
+ * where the rows are grouped and stored column by column. (all values are little-endian)
+ *
+ * File header:
+ *   char     magic[8]                  "HWPCCOL2"
+ *   uint32_t num_events
+ *   string   events_name[num_events]   sorted by name
+ *   string   sensor_name
+ *
+ * Row group (repeated until the end of file):
+ *   char     magic[4]                  "RGRP"
+ *   uint32_t num_rows
+ *   uint32_t num_new_targets
+ *   string   targets_name[num_new_targets]  appended to the dictionary of the file
+ *   uint64_t timestamp[num_rows]
+ *   uint32_t target[num_rows]               index into the targets dictionary
+ *   uint32_t socket[num_rows]
+ *   uint32_t cpu[num_rows]
+ *   uint64_t interval_ms[num_rows]          time elapsed since the previous report of the target
+ *   uint32_t overload_factor[num_rows]
+ *   uint8_t  partial[num_rows]              1 when the values do not cover a whole sampling interval
+ *   uint64_t values[num_events][num_rows]   one column per event
+ *
+ * Strings are stored as an uint16_t length followed by the (non null-terminated) characters.
+ */
+
+/*
+ * COLUMNAR_FILE_MAGIC stores the magic bytes at the beginning of a columnar file.
+ */
+#define COLUMNAR_FILE_MAGIC "HWPCCOL2"
+
+/*
+ * COLUMNAR_ROW_GROUP_MAGIC stores the magic bytes at the beginning of a row group.
+ */
+#define COLUMNAR_ROW_GROUP_MAGIC "RGRP"
+
+/*
+ * COLUMNAR_DEFAULT_ROW_GROUP_SIZE stores the default number of rows per row group.
+ */
+#define COLUMNAR_DEFAULT_ROW_GROUP_SIZE 4096
+
+/*
+ * COLUMNAR_SEGMENT_NAME_MAX_ATTEMPTS stores the maximum number of suffixes tried to find a free name for a new output file.
+ */
+#define COLUMNAR_SEGMENT_NAME_MAX_ATTEMPTS 100
+
+/*
+ * columnar_config stores the required information for the module.
+ */
+struct columnar_config
+{
+    const char *sensor_name;
+    const char *output_dir;
+    unsigned int row_group_size;
+};
+
+/*
+ * columnar_group_writer stores the buffered row group of an events group.
+ */
+struct columnar_group_writer
+{
+    FILE *file;
+    zlistx_t *events_name; /* char *event_name (sorted) */
+    size_t num_events;
+    size_t num_rows;
+    uint64_t *timestamps;
+    uint32_t *targets;
+    uint32_t *sockets;
+    uint32_t *cpus;
+    uint64_t *intervals_ms;
+    uint32_t *overload_factors;
+    uint8_t *partials;
+    uint64_t *values; /* column-major: values[event_idx * row_group_size + row_idx] */
+    zhashx_t *targets_dict; /* char *target_name -> uint64_t *target_idx */
+    zlistx_t *new_targets; /* char *target_name (not yet written to file) */
+};
+
+/*
+ * columnar_context stores the context of the module.
+ */
+struct columnar_context
+{
+    struct columnar_config config;
+    zhashx_t *groups_writer; /* char *group_name -> struct columnar_group_writer *writer */
+};
+
+/*
+ * storage_columnar_create creates and configure a columnar storage module.
+ */
+struct storage_module *storage_columnar_create(struct config *config, const struct config_storage *storage);
+
+#endif /* STORAGE_COLUMNAR_H */
@@ -32,41 +32,166 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <time.h>
 #include <linux/limits.h>
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 #include "storage.h"
 #include "storage_csv.h"
 #include "config.h"
 
+/*
+ * CSV_COMPRESSION_BUFFER_SIZE stores the size of the buffer used to compress a segment.
+ */
+#define CSV_COMPRESSION_BUFFER_SIZE 65536
+
+static void
+close_segment_file(FILE *file)
+{
+    fflush(file);
+    fsync(fileno(file));
+    fclose(file);
+}
+
 static void
-group_fd_destroy(FILE **fd_ptr)
+group_output_destroy(struct csv_group_output **output_ptr)
 {
-    if (!*fd_ptr)
+    if (!*output_ptr)
         return;
 
-    fflush(*fd_ptr);
-    fsync(fileno(*fd_ptr));
-    fclose(*fd_ptr);
-    *fd_ptr = NULL;
+    if ((*output_ptr)->file)
+        close_segment_file((*output_ptr)->file);
+
+    free(*output_ptr);
+    *output_ptr = NULL;
+}
+
+#ifdef HAVE_ZLIB
+static int
+compress_segment_file(const char *path)
+{
+    char compressed_path[PATH_MAX] = {};
+    char buffer[CSV_COMPRESSION_BUFFER_SIZE];
+    FILE *src = NULL;
+    gzFile dst = NULL;
+    size_t nread;
+    int ret = -1;
+
+    if (snprintf(compressed_path, PATH_MAX, "%s.gz", path) >= PATH_MAX) {
+        zsys_error("csv: the destination path of compressed segment %s is too long", path);
+        return -1;
+    }
+
+    src = fopen(path, "r");
+    if (!src) {
+        zsys_error("csv: failed to open segment %s for compression: %s", path, strerror(errno));
+        return -1;
+    }
+
+    /* the 'x' mode flag prevents overwriting an existing file */
+    dst = gzopen(compressed_path, "wbx");
+    if (!dst) {
+        zsys_error("csv: failed to create compressed segment %s", compressed_path);
+        goto cleanup;
+    }
+
+    while ((nread = fread(buffer, 1, sizeof(buffer), src)) > 0) {
+        if (gzwrite(dst, buffer, (unsigned int) nread) != (int) nread) {
+            zsys_error("csv: failed to write compressed segment %s", compressed_path);
+            goto cleanup;
+        }
+    }
+
+    if (ferror(src)) {
+        zsys_error("csv: failed to read segment %s for compression", path);
+        goto cleanup;
+    }
+
+    ret = 0;
+
+cleanup:
+    if (dst && gzclose(dst) != Z_OK)
+        ret = -1;
+    fclose(src);
+
+    /* only keep the compressed file when it is complete */
+    if (ret) {
+        if (dst)
+            unlink(compressed_path);
+    }
+    else {
+        unlink(path);
+    }
+
+    return ret;
+}
+#endif
+
+/*
+ * segments_closer_actor flush, close and (optionally) compress the rotated segments.
+ * This is done in background to avoid blocking the reporting actor on disk I/O.
+ */
+static void
+segments_closer_actor(zsock_t *pipe, void *args)
+{
+    const struct csv_config *config = (const struct csv_config *) args;
+    char *command = NULL;
+    FILE *file = NULL;
+    char *path = NULL;
+    bool terminated = false;
+
+    zsock_signal(pipe, 0);
+
+    while (!terminated) {
+        if (zsock_recv(pipe, "sps", &command, &file, &path) == -1)
+            break;
+
+        if (streq(command, "$TERM")) {
+            terminated = true;
+        }
+        else if (streq(command, "SEGMENT") && file && path) {
+            close_segment_file(file);
+#ifdef HAVE_ZLIB
+            if (config->compress)
+                compress_segment_file(path);
+#else
+            (void) config;
+#endif
+        }
+        else {
+            zsys_error("csv: invalid segments closer command: %s", command);
+        }
+
+        zstr_free(&command);
+        zstr_free(&path);
+    }
 }
 
 static struct csv_context *
-csv_context_create(const char *sensor_name, const char *output_dir)
+csv_context_create(const char *sensor_name, const struct config_storage *storage)
 {
     struct csv_context *ctx = (struct csv_context *) malloc(sizeof(struct csv_context));
 
     if (!ctx)
         return NULL;
 
-    ctx->config.output_dir = output_dir;
+    ctx->config.output_dir = storage->csv.outdir;
     ctx->config.sensor_name = sensor_name;
+    ctx->config.rotate_size = storage->csv.rotate_size;
+    ctx->config.rotate_interval_s = storage->csv.rotate_interval_s;
+    ctx->config.compress = storage->csv.compress;
 
-    ctx->groups_fd = zhashx_new();
-    zhashx_set_destructor(ctx->groups_fd, (zhashx_destructor_fn *) group_fd_destroy);
+    ctx->groups_output = zhashx_new();
+    zhashx_set_destructor(ctx->groups_output, (zhashx_destructor_fn *) group_output_destroy);
 
     ctx->groups_events = zhashx_new();
     zhashx_set_destructor(ctx->groups_events, (zhashx_destructor_fn *) zlistx_destroy);
 
+    ctx->segments_closer = NULL;
+
     return ctx;
 }
 
@@ -76,11 +201,18 @@ csv_context_destroy(struct csv_context *ctx)
     if (!ctx)
         return;
 
-    zhashx_destroy(&ctx->groups_fd);
+    zhashx_destroy(&ctx->groups_output);
+    zactor_destroy(&ctx->segments_closer);
     zhashx_destroy(&ctx->groups_events);
     free(ctx);
 }
 
+static bool
+is_rotation_enabled(const struct csv_context *ctx)
+{
+    return ctx->config.rotate_size || ctx->config.rotate_interval_s;
+}
+
 static int
 csv_initialize(struct storage_module *module)
 {
@@ -115,6 +247,14 @@ csv_initialize(struct storage_module *module)
         return -1;
     }
 
+    if (is_rotation_enabled(ctx)) {
+        ctx->segments_closer = zactor_new(segments_closer_actor, &ctx->config);
+        if (!ctx->segments_closer) {
+            zsys_error("csv: failed to start the segments closer actor");
+            return -1;
+        }
+    }
+
     module->is_initialized = true;
     return 0;
 }
@@ -127,87 +267,240 @@ csv_ping(struct storage_module *module __attribute__ ((unused)))
 }
 
 static int
-write_group_header(struct csv_context *ctx, const char *group, FILE *fd, zhashx_t *events)
+build_header_line(zlistx_t *events_name, char *buffer)
 {
-    char buffer[CSV_LINE_BUFFER_SIZE] = {};
     int pos = 0;
-    zlistx_t *events_name = NULL;
     const char *event_name = NULL;
 
-    events_name = zhashx_keys(events);
-    if (!events_name)
-        return -1;
-
-    /* sort events by name */
-    zlistx_set_comparator(events_name, (zlistx_comparator_fn *) strcmp);
-    zlistx_sort(events_name);
-
     /* write static elements to buffer */
-    pos += snprintf(buffer, CSV_LINE_BUFFER_SIZE, "timestamp,sensor,target,socket,cpu");
+    pos += snprintf(buffer, CSV_LINE_BUFFER_SIZE, "timestamp,sensor,target,socket,cpu,interval_ms,partial,overload_factor");
 
     /* append dynamic elements (events) to buffer */
     for (event_name = (const char * ) zlistx_first(events_name); event_name; event_name = (const char * ) zlistx_next(events_name)) {
         pos += snprintf(buffer + pos, CSV_LINE_BUFFER_SIZE - pos, ",%s", event_name);
         if (pos >= CSV_LINE_BUFFER_SIZE)
-            goto error_buffer_too_small;
+            return -1;
     }
 
-    if (fprintf(fd, "%s\n", buffer) < 0)
-        goto error_failed_write;
+    return 0;
+}
+
+static int
+write_header_line(struct csv_group_output *output, zlistx_t *events_name)
+{
+    char buffer[CSV_LINE_BUFFER_SIZE] = {};
+    int written = 0;
+
+    if (build_header_line(events_name, buffer))
+        return -1;
+
+    written = fprintf(output->file, "%s\n", buffer);
+    if (written < 0)
+        return -1;
 
     /* force writing to the disk */
-    fflush(fd);
+    fflush(output->file);
+
+    output->size += (uint64_t) written;
+    return 0;
+}
+
+static bool
+is_header_matching(const char *path, zlistx_t *events_name)
+{
+    char header[CSV_LINE_BUFFER_SIZE] = {};
+    char line[CSV_LINE_BUFFER_SIZE + 1] = {};
+    FILE *file = NULL;
+    bool matching = false;
+
+    if (build_header_line(events_name, header))
+        return false;
+
+    file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    if (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\n")] = '\0';
+        matching = streq(line, header);
+    }
+
+    fclose(file);
+    return matching;
+}
+
+static int
+open_group_outfile(struct csv_context *ctx, const char *group_name, struct csv_group_output *output, bool timestamped);
+
+static int
+write_group_header(struct csv_context *ctx, const char *group, struct csv_group_output *output, zhashx_t *events)
+{
+    zlistx_t *events_name = NULL;
+
+    events_name = zhashx_keys(events);
+    if (!events_name)
+        return -1;
+
+    /* sort events by name */
+    zlistx_set_comparator(events_name, (zlistx_comparator_fn *) strcmp);
+    zlistx_sort(events_name);
+
+    /* the rows appended to a file from a previous run must match its header (events and columns) */
+    if (output->size && !is_header_matching(output->path, events_name)) {
+        zsys_warning("csv: the header of %s does not match the reports of group=%s, writing them to a new file", output->path, group);
+        fclose(output->file);
+        output->file = NULL;
+        if (open_group_outfile(ctx, group, output, true)) {
+            zlistx_destroy(&events_name);
+            return -1;
+        }
+    }
+
+    /* an appended file already starts with the header */
+    if (output->size == 0 && write_header_line(output, events_name)) {
+        zlistx_destroy(&events_name);
+        return -1;
+    }
 
     /* store events name in the order written in header */
     zhashx_insert(ctx->groups_events, group, events_name);
 
     return 0;
+}
 
-error_failed_write:
-error_buffer_too_small:
-    zlistx_destroy(&events_name);
-    return -1;
+static int
+build_segment_path(struct csv_context *ctx, const char *group_name, unsigned int attempt, bool timestamped, char *path)
+{
+    char timestamp[32] = {};
+    time_t now = time(NULL);
+    struct tm tm = {};
+    int len;
+
+    /* without rotation, the group have a single output file unless its header does not match */
+    if (!timestamped)
+        return snprintf(path, PATH_MAX, "%s/%s.csv", ctx->config.output_dir, group_name) >= PATH_MAX;
+
+    if (!gmtime_r(&now, &tm) || !strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%SZ", &tm))
+        return -1;
+
+    if (attempt == 0)
+        len = snprintf(path, PATH_MAX, "%s/%s-%s.csv", ctx->config.output_dir, group_name, timestamp);
+    else
+        len = snprintf(path, PATH_MAX, "%s/%s-%s-%u.csv", ctx->config.output_dir, group_name, timestamp, attempt);
+
+    return len >= PATH_MAX;
 }
 
 static int
-open_group_outfile(struct csv_context *ctx, const char *group_name)
+open_group_outfile(struct csv_context *ctx, const char *group_name, struct csv_group_output *output, bool timestamped)
 {
     char path[PATH_MAX] = {};
+    struct stat file_stat = {};
     int fd = -1;
     FILE *file = NULL;
 
-    if (snprintf(path, PATH_MAX, "%s/%s.csv", ctx->config.output_dir, group_name) >= PATH_MAX) {
-        zsys_error("csv: the destination path for output file of group %s is too long", group_name);
-        return -1;
+    /* segments opened during the same second get a numbered suffix */
+    for (unsigned int attempt = 0; fd == -1 && attempt < CSV_SEGMENT_NAME_MAX_ATTEMPTS; attempt++) {
+        if (build_segment_path(ctx, group_name, attempt, timestamped, path)) {
+            zsys_error("csv: the destination path for output file of group %s is too long", group_name);
+            return -1;
+        }
+
+        /* without rotation, the reports are appended to the file of the previous runs */
+        errno = 0;
+        fd = open(path, O_WRONLY | O_CREAT | ((timestamped) ? O_EXCL : O_APPEND), 0644);
+        if (fd == -1 && (errno != EEXIST || !timestamped))
+            break;
     }
 
-    errno = 0;
-    fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
     if (fd == -1) {
         zsys_error("csv: failed to open output file for group %s: %s", group_name, strerror(errno));
         return -1;
     }
 
     errno = 0;
-    file = fdopen(fd, "w");
+    if (fstat(fd, &file_stat)) {
+        zsys_error("csv: failed to get the size of output file for group %s: %s", group_name, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    errno = 0;
+    file = fdopen(fd, (timestamped) ? "w" : "a");
     if (!file) {
         zsys_error("csv: failed to associate a stream to output file of group %s: %s", group_name, strerror(errno));
         close(fd);
         return -1;
     }
 
-    zhashx_insert(ctx->groups_fd, group_name, file);
+    output->file = file;
+    snprintf(output->path, PATH_MAX, "%s", path);
+    output->size = (uint64_t) file_stat.st_size;
+    output->opened_at = zclock_mono();
     return 0;
 }
 
+static struct csv_group_output *
+create_group_output(struct csv_context *ctx, const char *group_name)
+{
+    struct csv_group_output *output = (struct csv_group_output *) malloc(sizeof(struct csv_group_output));
+
+    if (!output)
+        return NULL;
+
+    if (open_group_outfile(ctx, group_name, output, is_rotation_enabled(ctx))) {
+        free(output);
+        return NULL;
+    }
+
+    zhashx_insert(ctx->groups_output, group_name, output);
+    return output;
+}
+
+static bool
+is_rotation_needed(const struct csv_context *ctx, const struct csv_group_output *output)
+{
+    if (ctx->config.rotate_size && output->size >= ctx->config.rotate_size)
+        return true;
+
+    if (ctx->config.rotate_interval_s && zclock_mono() - output->opened_at >= (int64_t) ctx->config.rotate_interval_s * 1000)
+        return true;
+
+    return false;
+}
+
 static int
-write_events_value(struct csv_context *ctx, const char *group, FILE *fd, uint64_t timestamp, const char *target, const char *socket, const char *cpu, zhashx_t *events)
+rotate_group_outfile(struct csv_context *ctx, const char *group_name, struct csv_group_output *output)
+{
+    FILE *old_file = output->file;
+    char old_path[PATH_MAX] = {};
+    zlistx_t *events_name = NULL;
+
+    snprintf(old_path, PATH_MAX, "%s", output->path);
+    if (open_group_outfile(ctx, group_name, output, true))
+        return -1;
+
+    /* the closing (and compression) of the previous segment is done in background */
+    zsock_send(ctx->segments_closer, "sps", "SEGMENT", old_file, old_path);
+
+    events_name = (zlistx_t *) zhashx_lookup(ctx->groups_events, group_name);
+    if (!events_name || write_header_line(output, events_name)) {
+        zsys_error("csv: failed to write header to new segment for group=%s", group_name);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+write_events_value(struct csv_context *ctx, const char *group, struct csv_group_output *output, const struct payload *payload, const char *socket, const char *cpu, zhashx_t *events)
 {
     zlistx_t *events_name = NULL;
     char buffer[CSV_LINE_BUFFER_SIZE] = {};
     int pos = 0;
     const char *event_name = NULL;
     const uint64_t *event_value = NULL;
+    int written = 0;
 
     /* get events name in the order of csv header */
     events_name = (zlistx_t *) zhashx_lookup(ctx->groups_events, group);
@@ -215,7 +508,7 @@ write_events_value(struct csv_context *ctx, const char *group, FILE *fd, uint64_
         return -1;
 
     /* write static elements to buffer */
-    pos += snprintf(buffer, CSV_LINE_BUFFER_SIZE, "%" PRIu64 ",%s,%s,%s,%s", timestamp, ctx->config.sensor_name, target, socket, cpu);
+    pos += snprintf(buffer, CSV_LINE_BUFFER_SIZE, "%" PRIu64 ",%s,%s,%s,%s,%" PRIu64 ",%d,%u", payload->timestamp, ctx->config.sensor_name, payload->target_name, socket, cpu, payload->interval_ms, payload->partial, payload->overload_factor);
  
     /* write dynamic elements (events) to buffer */
     for (event_name = (const char *) zlistx_first(events_name); event_name; event_name = (const char * ) zlistx_next(events_name)) {
@@ -228,9 +521,11 @@ write_events_value(struct csv_context *ctx, const char *group, FILE *fd, uint64_
             return -1;
     }
 
-    if (fprintf(fd, "%s\n", buffer) < 0)
+    written = fprintf(output->file, "%s\n", buffer);
+    if (written < 0)
         return -1;
 
+    output->size += (uint64_t) written;
     return 0;
 }
 
@@ -240,7 +535,7 @@ csv_store_report(struct storage_module *module, struct payload *payload)
     struct csv_context *ctx = (struct csv_context *) module->context;
     struct payload_group_data *group_data = NULL;
     const char *group_name = NULL;
-    FILE *group_fd = NULL;
+    struct csv_group_output *group_output = NULL;
     bool write_header = false;
     struct payload_pkg_data *pkg_data = NULL;
     const char *pkg_id = NULL;
@@ -249,19 +544,25 @@ csv_store_report(struct storage_module *module, struct payload *payload)
 
     /* 
      * write report into csv file as following: 
-     * timestamp,sensor,target,socket,cpu,INSTRUCTIONS_RETIRED,LLC_MISSES
-     * 1538327257673,grvingt-64,system,0,56,5996,108
+     * timestamp,sensor,target,socket,cpu,interval_ms,partial,overload_factor,INSTRUCTIONS_RETIRED,LLC_MISSES
+     * 1538327257673,grvingt-64,system,0,56,1000,0,1,5996,108
      */
     for (group_data = (struct payload_group_data *) zhashx_first(payload->groups); group_data; group_data = (struct payload_group_data *) zhashx_next(payload->groups)) {
         group_name = (const char *) zhashx_cursor(payload->groups);
-        group_fd = (FILE *) zhashx_lookup(ctx->groups_fd, group_name);
-        if (!group_fd) {
-            if (open_group_outfile(ctx, group_name))
+        group_output = (struct csv_group_output *) zhashx_lookup(ctx->groups_output, group_name);
+        if (!group_output) {
+            group_output = create_group_output(ctx, group_name);
+            if (!group_output)
                 return -1;
 
-            group_fd = (FILE *) zhashx_lookup(ctx->groups_fd, group_name);
             write_header = true;
         }
+        else if (is_rotation_enabled(ctx) && is_rotation_needed(ctx, group_output)) {
+            if (rotate_group_outfile(ctx, group_name, group_output)) {
+                zsys_error("csv: failed to rotate output file for group=%s", group_name);
+                return -1;
+            }
+        }
 
         for (pkg_data = (struct payload_pkg_data *) zhashx_first(group_data->pkgs); pkg_data; pkg_data = (struct payload_pkg_data *) zhashx_next(group_data->pkgs)) {
             pkg_id = (const char *) zhashx_cursor(group_data->pkgs);
@@ -270,13 +571,13 @@ csv_store_report(struct storage_module *module, struct payload *payload)
                 cpu_id = (const char *) zhashx_cursor(pkg_data->cpus);
 
                 if (write_header) {
-                    if (write_group_header(ctx, group_name, group_fd, cpu_data->events)) {
+                    if (write_group_header(ctx, group_name, group_output, cpu_data->events)) {
                         zsys_error("csv: failed to write header to file for group=%s", group_name);
                         return -1;
                     }
                     write_header = false;
                 }
-                if (write_events_value(ctx, group_name, group_fd, payload->timestamp, payload->target_name, pkg_id, cpu_id, cpu_data->events)) {
+                if (write_events_value(ctx, group_name, group_output, payload, pkg_id, cpu_id, cpu_data->events)) {
                     zsys_error("csv: failed to write report to file for group=%s timestamp=%" PRIu64, group_name, payload->timestamp);
                     return -1;
                 }
@@ -304,7 +605,7 @@ csv_destroy(struct storage_module *module)
 }
 
 struct storage_module *
-storage_csv_create(struct config *config)
+storage_csv_create(struct config *config, const struct config_storage *storage)
 {
     struct storage_module *module = NULL;
     struct csv_context *ctx = NULL;
@@ -313,7 +614,7 @@ storage_csv_create(struct config *config)
     if (!module)
         goto error;
 
-    ctx = csv_context_create(config->sensor.name, config->storage.csv.outdir);
+    ctx = csv_context_create(config->sensor.name, storage);
     if (!ctx)
         goto error;
 
@@ -333,4 +634,3 @@ error:
     free(module);
     return NULL;
 }
-
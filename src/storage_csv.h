@@ -33,6 +33,7 @@
 #define STORAGE_CSV_H
 
 #include <czmq.h>
+#include <linux/limits.h>
 
 #include "config.h"
 
@@ -41,6 +42,11 @@
  */
 #define CSV_LINE_BUFFER_SIZE 1024
 
+/*
+ * CSV_SEGMENT_NAME_MAX_ATTEMPTS stores the maximum number of suffixes tried to find a free name for a new segment.
+ */
+#define CSV_SEGMENT_NAME_MAX_ATTEMPTS 100
+
 /*
  * csv_config stores the required information for the module.
  */
@@ -48,6 +54,20 @@ struct csv_config
 {
     const char *sensor_name;
     const char *output_dir;
+    uint64_t rotate_size; /* in bytes, 0 to disable */
+    unsigned int rotate_interval_s; /* 0 to disable */
+    bool compress;
+};
+
+/*
+ * csv_group_output stores the state of the output file (segment) of an events group.
+ */
+struct csv_group_output
+{
+    FILE *file;
+    char path[PATH_MAX];
+    uint64_t size; /* in bytes */
+    int64_t opened_at; /* monotonic time in ms */
 };
 
 /*
@@ -56,14 +76,15 @@ struct csv_config
 struct csv_context
 {
     struct csv_config config;
-    zhashx_t *groups_fd; /* char *group_name -> FILE *fd */
+    zhashx_t *groups_output; /* char *group_name -> struct csv_group_output *output */
     zhashx_t *groups_events; /* char *group_name -> zlistx_t *group_events */
+    zactor_t *segments_closer; /* flush, close and compress the rotated segments in background */
 };
 
 /*
  * storage_csv_create creates and configure a csv storage module..
  */
-struct storage_module *storage_csv_create(struct config *config);
+struct storage_module *storage_csv_create(struct config *config, const struct config_storage *storage);
 
 #endif /* CSV_H */
 
@@ -0,0 +1,380 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <inttypes.h>
+
+#include "storage.h"
+#include "storage_fanout.h"
+#include "config.h"
+#include "payload.h"
+
+static void
+store_queued_report(struct fanout_output *output, zsock_t *queue)
+{
+    struct payload *payload = NULL;
+
+    zsock_recv(queue, "p", &payload);
+    if (!payload)
+        return;
+
+    if (storage_module_store_report(output->module, payload)) {
+        zsys_error("fanout: failed to store the report for timestamp=%" PRIu64 " using the '%s' storage module", payload->timestamp, storage_types_name[output->module->type]);
+    }
+
+    payload_destroy(payload);
+}
+
+static void
+output_actor(zsock_t *pipe, void *args)
+{
+    struct fanout_output *output = (struct fanout_output *) args;
+    zsock_t *queue = NULL;
+    zpoller_t *poller = NULL;
+    zsock_t *which = NULL;
+    char *command = NULL;
+    bool terminated = false;
+
+    /* the first signal is consumed by zactor_new, the second one reports whether the queue is ready */
+    zsock_signal(pipe, 0);
+
+    queue = zsock_new(ZMQ_PULL);
+    zsock_set_rcvhwm(queue, (int) output->queue_size);
+    if (zsock_bind(queue, "%s", output->endpoint) == -1) {
+        zsys_error("fanout: failed to bind the queue of the '%s' storage module", storage_types_name[output->module->type]);
+        zsock_destroy(&queue);
+        zsock_signal(pipe, 1);
+        return;
+    }
+
+    poller = zpoller_new(pipe, queue, NULL);
+    zsock_signal(pipe, 0);
+
+    while (!terminated) {
+        which = (zsock_t *) zpoller_wait(poller, -1);
+
+        if (zpoller_terminated(poller)) {
+            break;
+        }
+
+        if (which == pipe) {
+            command = zstr_recv(pipe);
+            if (streq(command, "$TERM")) {
+                terminated = true;
+            }
+            zstr_free(&command);
+        }
+        else if (which == queue) {
+            store_queued_report(output, queue);
+        }
+    }
+
+    /* store the reports still waiting in the queue */
+    while (zsock_events(queue) & ZMQ_POLLIN) {
+        store_queued_report(output, queue);
+    }
+
+    zpoller_destroy(&poller);
+    zsock_destroy(&queue);
+}
+
+static void
+fanout_output_destroy(struct fanout_output **output_ptr)
+{
+    struct fanout_output *output = *output_ptr;
+
+    if (!output)
+        return;
+
+    zactor_destroy(&output->actor);
+    zsock_destroy(&output->queue);
+    storage_module_destroy(output->module);
+    free(output);
+    *output_ptr = NULL;
+}
+
+static struct fanout_output *
+fanout_output_create(struct storage_module *module, unsigned int queue_size)
+{
+    struct fanout_output *output = (struct fanout_output *) malloc(sizeof(struct fanout_output));
+
+    if (!output)
+        return NULL;
+
+    output->module = module;
+    snprintf(output->endpoint, FANOUT_ENDPOINT_SIZE, "inproc://storage-fanout-%p", (void *) output);
+    output->queue_size = queue_size;
+    output->actor = NULL;
+    output->queue = NULL;
+    output->dropped_reports = 0;
+    output->logged_dropped_reports = 0;
+    output->last_drop_log_ms = 0;
+    output->is_overflowing = false;
+
+    return output;
+}
+
+static int
+fanout_output_start(struct fanout_output *output)
+{
+    output->actor = zactor_new(output_actor, output);
+    if (!output->actor || zsock_wait(output->actor))
+        return -1;
+
+    output->queue = zsock_new(ZMQ_PUSH);
+    zsock_set_sndhwm(output->queue, (int) output->queue_size);
+    zsock_set_sndtimeo(output->queue, 0);
+    if (zsock_connect(output->queue, "%s", output->endpoint) == -1)
+        return -1;
+
+    return 0;
+}
+
+static void
+fanout_output_stop(struct fanout_output *output)
+{
+    /* the actor stores the queued reports before exiting, the queue must stay open until then to not drop them */
+    zactor_destroy(&output->actor);
+    zsock_destroy(&output->queue);
+}
+
+static struct fanout_context *
+fanout_context_create(void)
+{
+    struct fanout_context *ctx = (struct fanout_context *) malloc(sizeof(struct fanout_context));
+
+    if (!ctx)
+        return NULL;
+
+    ctx->outputs = zlistx_new();
+    zlistx_set_destructor(ctx->outputs, (zlistx_destructor_fn *) fanout_output_destroy);
+
+    return ctx;
+}
+
+static void
+fanout_context_destroy(struct fanout_context *ctx)
+{
+    if (!ctx)
+        return;
+
+    zlistx_destroy(&ctx->outputs);
+    free(ctx);
+}
+
+static int
+fanout_deinitialize(struct storage_module *module);
+
+static int
+fanout_initialize(struct storage_module *module)
+{
+    struct fanout_context *ctx = (struct fanout_context *) module->context;
+    struct fanout_output *output = NULL;
+
+    for (output = (struct fanout_output *) zlistx_first(ctx->outputs); output; output = (struct fanout_output *) zlistx_next(ctx->outputs)) {
+        if (storage_module_initialize(output->module)) {
+            zsys_error("fanout: failed to initialize the '%s' storage module", storage_types_name[output->module->type]);
+            goto error;
+        }
+    }
+
+    for (output = (struct fanout_output *) zlistx_first(ctx->outputs); output; output = (struct fanout_output *) zlistx_next(ctx->outputs)) {
+        if (fanout_output_start(output)) {
+            zsys_error("fanout: failed to start the queue of the '%s' storage module", storage_types_name[output->module->type]);
+            goto error;
+        }
+    }
+
+    module->is_initialized = true;
+    return 0;
+
+error:
+    module->is_initialized = true;
+    fanout_deinitialize(module);
+    return -1;
+}
+
+static int
+fanout_ping(struct storage_module *module)
+{
+    struct fanout_context *ctx = (struct fanout_context *) module->context;
+    struct fanout_output *output = NULL;
+
+    for (output = (struct fanout_output *) zlistx_first(ctx->outputs); output; output = (struct fanout_output *) zlistx_next(ctx->outputs)) {
+        if (storage_module_ping(output->module)) {
+            zsys_error("fanout: failed to ping the '%s' storage module", storage_types_name[output->module->type]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void
+log_dropped_reports(struct fanout_output *output)
+{
+    const int64_t now_ms = zclock_mono();
+
+    if (now_ms - output->last_drop_log_ms < FANOUT_DROPPED_REPORTS_LOG_INTERVAL_MS)
+        return;
+
+    zsys_warning("fanout: queue of the '%s' storage module is full, %" PRIu64 " reports dropped (%" PRIu64 " so far)", storage_types_name[output->module->type], output->dropped_reports - output->logged_dropped_reports, output->dropped_reports);
+    output->logged_dropped_reports = output->dropped_reports;
+    output->last_drop_log_ms = now_ms;
+}
+
+static int
+fanout_store_report(struct storage_module *module, struct payload *payload)
+{
+    struct fanout_context *ctx = (struct fanout_context *) module->context;
+    struct fanout_output *output = NULL;
+    struct payload *output_payload = NULL;
+    int ret = 0;
+
+    for (output = (struct fanout_output *) zlistx_first(ctx->outputs); output; output = (struct fanout_output *) zlistx_next(ctx->outputs)) {
+        /*
+         * the containers of a payload are not safe to read from several threads, the outputs running concurrently own a copy of it.
+         * the last output shares the payload itself since it is no longer read by the caller once stored.
+         */
+        output_payload = (output == zlistx_tail(ctx->outputs)) ? payload_ref(payload) : payload_dup(payload);
+        if (!output_payload) {
+            ret = -1;
+            continue;
+        }
+
+        /* a full queue means the output is not keeping up, its reports are dropped to never block the other ones and logged periodically */
+        if (zsock_send(output->queue, "p", output_payload)) {
+            payload_destroy(output_payload);
+            output->dropped_reports++;
+            output->is_overflowing = true;
+            log_dropped_reports(output);
+            continue;
+        }
+
+        if (output->is_overflowing) {
+            zsys_warning("fanout: queue of the '%s' storage module is available again (%" PRIu64 " reports dropped so far)", storage_types_name[output->module->type], output->dropped_reports);
+            output->logged_dropped_reports = output->dropped_reports;
+            output->is_overflowing = false;
+        }
+    }
+
+    return ret;
+}
+
+static int
+fanout_deinitialize(struct storage_module *module)
+{
+    struct fanout_context *ctx = (struct fanout_context *) module->context;
+    struct fanout_output *output = NULL;
+
+    if (!module->is_initialized)
+        return 0;
+
+    for (output = (struct fanout_output *) zlistx_first(ctx->outputs); output; output = (struct fanout_output *) zlistx_next(ctx->outputs)) {
+        fanout_output_stop(output);
+    }
+
+    for (output = (struct fanout_output *) zlistx_first(ctx->outputs); output; output = (struct fanout_output *) zlistx_next(ctx->outputs)) {
+        storage_module_deinitialize(output->module);
+    }
+
+    module->is_initialized = false;
+    return 0;
+}
+
+static void
+fanout_destroy(struct storage_module *module)
+{
+    if (!module)
+        return;
+
+    fanout_context_destroy((struct fanout_context *) module->context);
+}
+
+static int
+setup_fanout_outputs(struct fanout_context *ctx, struct config *config, const struct config_storage *storage)
+{
+    const struct config_storage *output_storage = NULL;
+    struct storage_module *output_module = NULL;
+    struct fanout_output *output = NULL;
+    unsigned int queue_size = (storage->fanout.queue_size) ? storage->fanout.queue_size : FANOUT_DEFAULT_QUEUE_SIZE;
+
+    for (output_storage = (const struct config_storage *) zlistx_first(storage->fanout.outputs); output_storage; output_storage = (const struct config_storage *) zlistx_next(storage->fanout.outputs)) {
+        output_module = storage_module_create(config, output_storage);
+        if (!output_module) {
+            zsys_error("fanout: failed to create '%s' storage module", storage_types_name[output_storage->type]);
+            return -1;
+        }
+
+        output = fanout_output_create(output_module, queue_size);
+        if (!output) {
+            storage_module_destroy(output_module);
+            return -1;
+        }
+
+        zlistx_add_end(ctx->outputs, output);
+    }
+
+    return 0;
+}
+
+struct storage_module *
+storage_fanout_create(struct config *config, const struct config_storage *storage)
+{
+    struct storage_module *module = NULL;
+    struct fanout_context *ctx = NULL;
+
+    module = (struct storage_module *) malloc(sizeof(struct storage_module));
+    if (!module)
+        goto error;
+
+    ctx = fanout_context_create();
+    if (!ctx)
+        goto error;
+
+    if (setup_fanout_outputs(ctx, config, storage))
+        goto error;
+
+    module->type = STORAGE_FANOUT;
+    module->context = ctx;
+    module->is_initialized = false;
+    module->initialize = fanout_initialize;
+    module->ping = fanout_ping;
+    module->store_report = fanout_store_report;
+    module->deinitialize = fanout_deinitialize;
+    module->destroy = fanout_destroy;
+
+    return module;
+
+error:
+    fanout_context_destroy(ctx);
+    free(module);
+    return NULL;
+}
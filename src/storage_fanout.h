@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef STORAGE_FANOUT_H
+#define STORAGE_FANOUT_H
+
+#include <czmq.h>
+#include <stdint.h>
+
+#include "storage.h"
+#include "config.h"
+
+/*
+ * FANOUT_DEFAULT_QUEUE_SIZE stores the default maximum number of reports waiting to be stored by an output.
+ */
+#define FANOUT_DEFAULT_QUEUE_SIZE 1024
+
+/*
+ * FANOUT_ENDPOINT_SIZE stores the maximum size of the endpoint of an output queue.
+ */
+#define FANOUT_ENDPOINT_SIZE 64
+
+/*
+ * FANOUT_DROPPED_REPORTS_LOG_INTERVAL_MS stores the minimum duration (in ms) between two logs of the reports dropped by an overflowing output.
+ */
+#define FANOUT_DROPPED_REPORTS_LOG_INTERVAL_MS 10000
+
+/*
+ * fanout_output stores the storage module and the reports queue of an output.
+ * The storage module is only used by the output actor once the module is initialized.
+ */
+struct fanout_output
+{
+    struct storage_module *module;
+    char endpoint[FANOUT_ENDPOINT_SIZE];
+    unsigned int queue_size;
+    zactor_t *actor;
+    zsock_t *queue; /* PUSH socket, the payloads are sent without blocking */
+    uint64_t dropped_reports;
+    uint64_t logged_dropped_reports; /* dropped reports already counted in the logs */
+    int64_t last_drop_log_ms;
+    bool is_overflowing;
+};
+
+/*
+ * fanout_context stores the context of the module.
+ */
+struct fanout_context
+{
+    zlistx_t *outputs; /* struct fanout_output *output */
+};
+
+/*
+ * storage_fanout_create creates and configure a fanout storage module dispatching the reports to several storage modules.
+ */
+struct storage_module *storage_fanout_create(struct config *config, const struct config_storage *storage);
+
+#endif /* STORAGE_FANOUT_H */
@@ -115,11 +115,9 @@ mongodb_ping(struct storage_module *module)
     return ret;
 }
 
-static int
-mongodb_store_report(struct storage_module *module, struct payload *payload)
+void
+mongodb_build_document(const char *sensor_name, struct payload *payload, bson_t *document)
 {
-    struct mongodb_context *ctx = (struct mongodb_context *) module->context;
-    bson_t document = BSON_INITIALIZER;
     bson_t doc_groups;
     struct payload_group_data *group_data = NULL;
     const char *group_name = NULL;
@@ -132,15 +130,22 @@ mongodb_store_report(struct storage_module *module, struct payload *payload)
     bson_t doc_cpu;
     const char *event_name = NULL;
     uint64_t *event_value = NULL;
-    bson_error_t error;
-    int ret = 0;
 
     /*
      * construct mongodb document as following:
      * {
      *    "timestamp": 1529868713854,
+     *    "read_timestamp": 1529868713857,
      *    "sensor": "test.cluster.lan",
      *    "target": "example",
+     *    "namespace": "default", (only when resolved for a container)
+     *    "pod": "example-pod", (only when resolved for a container)
+     *    "container": "example-container", (only when resolved for a container)
+     *    "interval_ms": 1000,
+     *    "interval_start": 1529868712855, (only when the sampling interval was widened)
+     *    "overload_factor": 2, (only when the sampling interval was widened)
+     *    "partial": true, (only for the first report of a target)
+     *    "setup_latency_ms": 42, (only for the first report of a target)
      *    "groups": {
      *      "group_name": {
      *          "pkg_id": {
@@ -158,11 +163,27 @@ mongodb_store_report(struct storage_module *module, struct payload *payload)
      *   }
      * }
      */
-    BSON_APPEND_DATE_TIME(&document, "timestamp", payload->timestamp);
-    BSON_APPEND_UTF8(&document, "sensor", ctx->config.sensor_name);
-    BSON_APPEND_UTF8(&document, "target", payload->target_name);
+    BSON_APPEND_DATE_TIME(document, "timestamp", payload->timestamp);
+    BSON_APPEND_DATE_TIME(document, "read_timestamp", payload->read_timestamp);
+    BSON_APPEND_UTF8(document, "sensor", sensor_name);
+    BSON_APPEND_UTF8(document, "target", payload->target_name);
+    if (payload->target_namespace)
+        BSON_APPEND_UTF8(document, "namespace", payload->target_namespace);
+    if (payload->target_pod)
+        BSON_APPEND_UTF8(document, "pod", payload->target_pod);
+    if (payload->target_container)
+        BSON_APPEND_UTF8(document, "container", payload->target_container);
+    BSON_APPEND_INT64(document, "interval_ms", (int64_t) payload->interval_ms);
+    if (payload->overload_factor > 1) {
+        BSON_APPEND_DATE_TIME(document, "interval_start", payload->interval_start_timestamp);
+        BSON_APPEND_INT64(document, "overload_factor", (int64_t) payload->overload_factor);
+    }
+    if (payload->partial) {
+        BSON_APPEND_BOOL(document, "partial", true);
+        BSON_APPEND_INT64(document, "setup_latency_ms", (int64_t) payload->setup_latency_ms);
+    }
 
-    BSON_APPEND_DOCUMENT_BEGIN(&document, "groups", &doc_groups);
+    BSON_APPEND_DOCUMENT_BEGIN(document, "groups", &doc_groups);
     for (group_data = (struct payload_group_data *) zhashx_first(payload->groups); group_data; group_data = (struct payload_group_data *) zhashx_next(payload->groups)) {
         group_name = (const char *) zhashx_cursor(payload->groups);
         BSON_APPEND_DOCUMENT_BEGIN(&doc_groups, group_name, &doc_group);
@@ -188,7 +209,18 @@ mongodb_store_report(struct storage_module *module, struct payload *payload)
 
         bson_append_document_end(&doc_groups, &doc_group);
     }
-    bson_append_document_end(&document, &doc_groups);
+    bson_append_document_end(document, &doc_groups);
+}
+
+static int
+mongodb_store_report(struct storage_module *module, struct payload *payload)
+{
+    struct mongodb_context *ctx = (struct mongodb_context *) module->context;
+    bson_t document = BSON_INITIALIZER;
+    bson_error_t error;
+    int ret = 0;
+
+    mongodb_build_document(ctx->config.sensor_name, payload, &document);
 
     /* insert document into collection */
     if (!mongoc_collection_insert_one(ctx->collection, &document, NULL, NULL, &error)) {
@@ -226,7 +258,7 @@ mongodb_destroy(struct storage_module *module)
 }
 
 struct storage_module *
-storage_mongodb_create(struct config *config)
+storage_mongodb_create(struct config *config, const struct config_storage *storage)
 {
     struct storage_module *module = NULL;
     struct mongodb_context *ctx = NULL;
@@ -235,7 +267,7 @@ storage_mongodb_create(struct config *config)
     if (!module)
         goto error;
 
-    ctx = mongodb_context_create(config->sensor.name, config->storage.mongodb.uri, config->storage.mongodb.database, config->storage.mongodb.collection);
+    ctx = mongodb_context_create(config->sensor.name, storage->mongodb.uri, storage->mongodb.database, storage->mongodb.collection);
     if (!ctx)
         goto error;
 
@@ -60,10 +60,15 @@ struct mongodb_context
     mongoc_collection_t *collection;
 };
 
+/*
+ * mongodb_build_document appends the fields of the given report to the (initialized) bson document.
+ */
+void mongodb_build_document(const char *sensor_name, struct payload *payload, bson_t *document);
+
 /*
  * storage_mongodb_create creates and configure a mongodb storage module.
  */
-struct storage_module *storage_mongodb_create(struct config *config);
+struct storage_module *storage_mongodb_create(struct config *config, const struct config_storage *storage);
 
 #endif /* STORAGE_MONGODB_H */
 
@@ -68,7 +68,7 @@ null_destroy(struct storage_module *module  __attribute__ ((unused)))
 }
 
 struct storage_module *
-storage_null_create(struct config *config  __attribute__ ((unused)))
+storage_null_create(struct config *config __attribute__ ((unused)), const struct config_storage *storage __attribute__ ((unused)))
 {
     struct storage_module *module = (struct storage_module *) malloc(sizeof(struct storage_module));
 
@@ -37,6 +37,6 @@
 /*
  * storage_null_create creates and configure a null storage module.
  */
-struct storage_module *storage_null_create(struct config *config);
+struct storage_module *storage_null_create(struct config *config, const struct config_storage *storage);
 
 #endif /* STORAGE_NULL_H */
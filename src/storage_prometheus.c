@@ -0,0 +1,574 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+
+#include "storage.h"
+#include "storage_prometheus.h"
+#include "config.h"
+#include "payload.h"
+
+static struct prometheus_context *
+prometheus_context_create(const char *sensor_name, const char *address, const char *port, bool per_cpu)
+{
+    struct prometheus_context *ctx = (struct prometheus_context *) malloc(sizeof(struct prometheus_context));
+
+    if (!ctx)
+        return NULL;
+
+    ctx->config.sensor_name = sensor_name;
+    ctx->config.address = (strlen(address)) ? address : NULL; /* loopback address when not set */
+    ctx->config.port = port;
+    ctx->config.per_cpu = per_cpu;
+
+    pthread_mutex_init(&ctx->lock, NULL);
+    ctx->series = NULL;
+    ctx->num_series = 0;
+    ctx->series_capacity = 0;
+    ctx->series_index = zhashx_new();
+    ctx->last_sweep_timestamp = 0;
+    ctx->overload_factor = 1;
+    ctx->listen_fd = -1;
+    ctx->http_actor = NULL;
+
+    return ctx;
+}
+
+static void
+prometheus_context_destroy(struct prometheus_context *ctx)
+{
+    if (!ctx)
+        return;
+
+    for (size_t i = 0; i < ctx->num_series; i++)
+        free(ctx->series[i].labels);
+    free(ctx->series);
+    zhashx_destroy(&ctx->series_index);
+    pthread_mutex_destroy(&ctx->lock);
+    free(ctx);
+}
+
+static int
+write_all(int fd, const char *data, size_t size)
+{
+    ssize_t nbsend = 0;
+
+    while (size > 0) {
+        nbsend = send(fd, data, size, MSG_NOSIGNAL);
+        if (nbsend == -1) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        data += nbsend;
+        size -= (size_t) nbsend;
+    }
+
+    return 0;
+}
+
+static char *
+format_exposition(struct prometheus_context *ctx, size_t *size)
+{
+    FILE *stream = NULL;
+    char *buffer = NULL;
+
+    stream = open_memstream(&buffer, size);
+    if (!stream)
+        return NULL;
+
+    fprintf(stream, "# TYPE %s counter\n", PROMETHEUS_METRIC_NAME);
+    fprintf(stream, "# HELP %s Cumulative value of the monitored hardware performance events.\n", PROMETHEUS_METRIC_NAME);
+
+    /* a scrape is a single formatting pass over the flat array of series */
+    pthread_mutex_lock(&ctx->lock);
+    for (size_t i = 0; i < ctx->num_series; i++)
+        fprintf(stream, "%s_total{%s} %" PRIu64 "\n", PROMETHEUS_METRIC_NAME, ctx->series[i].labels, ctx->series[i].value);
+
+    fprintf(stream, "# TYPE %s gauge\n", PROMETHEUS_OVERLOAD_METRIC_NAME);
+    fprintf(stream, "# HELP %s Multiple of the sampling intervals applied while the sensor is overloaded.\n", PROMETHEUS_OVERLOAD_METRIC_NAME);
+    fprintf(stream, "%s %u\n", PROMETHEUS_OVERLOAD_METRIC_NAME, ctx->overload_factor);
+    pthread_mutex_unlock(&ctx->lock);
+
+    fprintf(stream, "# EOF\n");
+
+    if (fclose(stream)) {
+        free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+static int
+send_response(int fd, const char *status, const char *content_type, const char *body, size_t body_size)
+{
+    char header[256] = {};
+    int header_size = 0;
+
+    header_size = snprintf(header, sizeof(header), "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n", status, content_type, body_size);
+    if (header_size < 0 || (size_t) header_size >= sizeof(header))
+        return -1;
+
+    if (write_all(fd, header, (size_t) header_size))
+        return -1;
+
+    return write_all(fd, body, body_size);
+}
+
+static int
+read_request(int fd, char *buffer, size_t size)
+{
+    size_t length = 0;
+    ssize_t nbread = 0;
+
+    /* only the request line is used, the headers are read to not reset the connection before answering */
+    while (length < size - 1) {
+        nbread = recv(fd, buffer + length, size - 1 - length, 0);
+        if (nbread == -1 && errno == EINTR)
+            continue;
+        if (nbread <= 0)
+            return -1;
+
+        length += (size_t) nbread;
+        buffer[length] = '\0';
+        if (strstr(buffer, "\r\n\r\n") || strstr(buffer, "\n\n"))
+            return 0;
+    }
+
+    return -1;
+}
+
+static void
+handle_client(struct prometheus_context *ctx, int fd)
+{
+    const struct timeval timeout = { .tv_sec = PROMETHEUS_CLIENT_TIMEOUT_MS / 1000, .tv_usec = (PROMETHEUS_CLIENT_TIMEOUT_MS % 1000) * 1000 };
+    char request[PROMETHEUS_REQUEST_MAX_SIZE] = {};
+    char method[8] = {};
+    char path[256] = {};
+    char *body = NULL;
+    size_t body_size = 0;
+    const char *plain_text = "text/plain; charset=utf-8";
+
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    if (read_request(fd, request, sizeof(request)) || sscanf(request, "%7s %255s", method, path) != 2) {
+        send_response(fd, "400 Bad Request", plain_text, "", 0);
+        return;
+    }
+
+    if (strcmp(method, "GET")) {
+        send_response(fd, "405 Method Not Allowed", plain_text, "", 0);
+        return;
+    }
+
+    path[strcspn(path, "?")] = '\0';
+    if (strcmp(path, "/metrics")) {
+        send_response(fd, "404 Not Found", plain_text, "", 0);
+        return;
+    }
+
+    body = format_exposition(ctx, &body_size);
+    if (!body) {
+        zsys_error("prometheus: failed to format the metrics");
+        send_response(fd, "500 Internal Server Error", plain_text, "", 0);
+        return;
+    }
+
+    if (send_response(fd, "200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8", body, body_size))
+        zsys_warning("prometheus: failed to send the metrics to the client: %s", strerror(errno));
+
+    free(body);
+}
+
+static void
+http_actor(zsock_t *pipe, void *args)
+{
+    struct prometheus_context *ctx = (struct prometheus_context *) args;
+    zpoller_t *poller = zpoller_new(pipe, &ctx->listen_fd, NULL);
+    void *which = NULL; /* The poller mixes ZMQ sockets and a raw listening socket handle. */
+    char *command = NULL;
+    bool terminated = false;
+    int client_fd = -1;
+
+    zsock_signal(pipe, 0);
+
+    while (!terminated) {
+        which = zpoller_wait(poller, -1);
+
+        if (zpoller_terminated(poller))
+            break;
+
+        if (which == pipe) {
+            command = zstr_recv(pipe);
+            if (streq(command, "$TERM"))
+                terminated = true;
+            zstr_free(&command);
+        }
+        else if (which == &ctx->listen_fd) {
+            client_fd = accept4(ctx->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+            if (client_fd == -1) {
+                zsys_warning("prometheus: failed to accept client connection: %s", strerror(errno));
+                continue;
+            }
+            handle_client(ctx, client_fd);
+            close(client_fd);
+        }
+    }
+
+    zpoller_destroy(&poller);
+}
+
+static int
+listen_endpoint(struct prometheus_context *ctx)
+{
+    struct addrinfo hints = {};
+    struct addrinfo *result = NULL, *rp = NULL;
+    const int reuse_addr = 1;
+    int sfd = -1;
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (getaddrinfo(ctx->config.address, ctx->config.port, &hints, &result)) {
+        zsys_error("prometheus: unable to resolve address: %s", (ctx->config.address) ? ctx->config.address : "localhost");
+        return -1;
+    }
+
+    for (rp = result; rp; rp = rp->ai_next) {
+        sfd = socket(rp->ai_family, rp->ai_socktype | SOCK_CLOEXEC, rp->ai_protocol);
+        if (sfd == -1)
+            continue;
+
+        setsockopt(sfd, SOL_SOCKET, SO_REUSEADDR, &reuse_addr, sizeof(reuse_addr));
+        if (!bind(sfd, rp->ai_addr, rp->ai_addrlen) && !listen(sfd, SOMAXCONN))
+            break;
+
+        close(sfd);
+        sfd = -1;
+    }
+
+    freeaddrinfo(result);
+
+    if (sfd == -1) {
+        zsys_error("prometheus: failed to listen on port %s", ctx->config.port);
+        return -1;
+    }
+
+    ctx->listen_fd = sfd;
+    zsys_info("prometheus: serving metrics on port %s", ctx->config.port);
+    return 0;
+}
+
+static int
+prometheus_initialize(struct storage_module *module)
+{
+    struct prometheus_context *ctx = (struct prometheus_context *) module->context;
+
+    if (module->is_initialized)
+        return -1;
+
+    if (listen_endpoint(ctx))
+        return -1;
+
+    ctx->http_actor = zactor_new(http_actor, ctx);
+    if (!ctx->http_actor) {
+        close(ctx->listen_fd);
+        ctx->listen_fd = -1;
+        return -1;
+    }
+
+    module->is_initialized = true;
+    return 0;
+}
+
+static int
+prometheus_ping(struct storage_module *module __attribute__ ((unused)))
+{
+    /* ping is not needed because the listening socket is setup when initializing the module */
+    return 0;
+}
+
+static int
+escape_label_value(char *buffer, size_t size, const char *value)
+{
+    size_t length = 0;
+
+    for (; *value; value++) {
+        /* a truncated value would merge the series of different targets, it is rejected */
+        if (length + ((*value == '\\' || *value == '"' || *value == '\n') ? 2 : 1) >= size)
+            return -1;
+
+        switch (*value) {
+            case '\\':
+            case '"':
+                buffer[length++] = '\\';
+                buffer[length++] = *value;
+                break;
+            case '\n':
+                buffer[length++] = '\\';
+                buffer[length++] = 'n';
+                break;
+            default:
+                buffer[length++] = *value;
+        }
+    }
+
+    buffer[length] = '\0';
+    return 0;
+}
+
+static int
+format_series_labels(struct prometheus_context *ctx, char *labels, const char *target_name, const char *group_name, const char *pkg_id, const char *cpu_id, const char *event_name)
+{
+    char escaped_sensor[2 * NAME_MAX] = {};
+    char escaped_target[PATH_MAX] = {};
+    char escaped_group[2 * NAME_MAX] = {};
+    char escaped_pkg[2 * NAME_MAX] = {};
+    char escaped_cpu[2 * NAME_MAX] = {};
+    char escaped_event[2 * NAME_MAX] = {};
+    int length = 0;
+
+    /* every label value can contain characters to escape, even the ones given by the configuration */
+    if (escape_label_value(escaped_sensor, sizeof(escaped_sensor), ctx->config.sensor_name) ||
+        escape_label_value(escaped_target, sizeof(escaped_target), target_name) ||
+        escape_label_value(escaped_group, sizeof(escaped_group), group_name) ||
+        escape_label_value(escaped_pkg, sizeof(escaped_pkg), pkg_id) ||
+        escape_label_value(escaped_event, sizeof(escaped_event), event_name))
+        return -1;
+
+    if (ctx->config.per_cpu) {
+        if (escape_label_value(escaped_cpu, sizeof(escaped_cpu), cpu_id))
+            return -1;
+        length = snprintf(labels, PROMETHEUS_LABELS_MAX_SIZE, "sensor=\"%s\",target=\"%s\",group=\"%s\",socket=\"%s\",cpu=\"%s\",event=\"%s\"", escaped_sensor, escaped_target, escaped_group, escaped_pkg, escaped_cpu, escaped_event);
+    }
+    else
+        length = snprintf(labels, PROMETHEUS_LABELS_MAX_SIZE, "sensor=\"%s\",target=\"%s\",group=\"%s\",socket=\"%s\",event=\"%s\"", escaped_sensor, escaped_target, escaped_group, escaped_pkg, escaped_event);
+
+    return (length < 0 || length >= PROMETHEUS_LABELS_MAX_SIZE) ? -1 : 0;
+}
+
+static struct prometheus_series *
+lookup_series(struct prometheus_context *ctx, const char *labels)
+{
+    uintptr_t index = (uintptr_t) zhashx_lookup(ctx->series_index, labels);
+    struct prometheus_series *series = NULL;
+    size_t new_capacity = 0;
+
+    if (index)
+        return &ctx->series[index - 1];
+
+    if (ctx->num_series == ctx->series_capacity) {
+        new_capacity = (ctx->series_capacity) ? ctx->series_capacity * 2 : 64;
+        series = (struct prometheus_series *) realloc(ctx->series, new_capacity * sizeof(struct prometheus_series));
+        if (!series)
+            return NULL;
+        ctx->series = series;
+        ctx->series_capacity = new_capacity;
+    }
+
+    series = &ctx->series[ctx->num_series];
+    series->labels = strdup(labels);
+    if (!series->labels)
+        return NULL;
+    series->value = 0;
+    series->last_update = 0;
+
+    ctx->num_series++;
+    zhashx_insert(ctx->series_index, labels, (void *) (uintptr_t) ctx->num_series);
+    return series;
+}
+
+static void
+remove_series(struct prometheus_context *ctx, size_t index)
+{
+    struct prometheus_series *last = &ctx->series[ctx->num_series - 1];
+
+    zhashx_delete(ctx->series_index, ctx->series[index].labels);
+    free(ctx->series[index].labels);
+
+    /* keep the array dense by moving the last series into the freed slot */
+    if (&ctx->series[index] != last) {
+        ctx->series[index] = *last;
+        zhashx_update(ctx->series_index, ctx->series[index].labels, (void *) (uintptr_t) (index + 1));
+    }
+
+    ctx->num_series--;
+}
+
+static void
+sweep_idle_series(struct prometheus_context *ctx, uint64_t timestamp)
+{
+    size_t i = 0;
+
+    /* the timestamps of the payloads are not monotonic across the targets, a late one must not wrap the durations */
+    if (timestamp <= ctx->last_sweep_timestamp || timestamp - ctx->last_sweep_timestamp < PROMETHEUS_SERIES_IDLE_TIMEOUT_MS)
+        return;
+
+    ctx->last_sweep_timestamp = timestamp;
+
+    /* the series of the targets that are no longer monitored are removed to bound the cardinality */
+    while (i < ctx->num_series) {
+        if (timestamp > ctx->series[i].last_update && timestamp - ctx->series[i].last_update >= PROMETHEUS_SERIES_IDLE_TIMEOUT_MS)
+            remove_series(ctx, i);
+        else
+            i++;
+    }
+}
+
+static int
+prometheus_store_report(struct storage_module *module, struct payload *payload)
+{
+    struct prometheus_context *ctx = (struct prometheus_context *) module->context;
+    struct payload_group_data *group_data = NULL;
+    const char *group_name = NULL;
+    struct payload_pkg_data *pkg_data = NULL;
+    const char *pkg_id = NULL;
+    struct payload_cpu_data *cpu_data = NULL;
+    const char *cpu_id = NULL;
+    const uint64_t *event_value = NULL;
+    const char *event_name = NULL;
+    char labels[PROMETHEUS_LABELS_MAX_SIZE] = {};
+    struct prometheus_series *series = NULL;
+    size_t num_skipped_series = 0;
+    int ret = 0;
+
+    pthread_mutex_lock(&ctx->lock);
+
+    if (!ctx->last_sweep_timestamp)
+        ctx->last_sweep_timestamp = payload->timestamp;
+
+    ctx->overload_factor = payload->overload_factor;
+
+    for (group_data = (struct payload_group_data *) zhashx_first(payload->groups); group_data; group_data = (struct payload_group_data *) zhashx_next(payload->groups)) {
+        group_name = (const char *) zhashx_cursor(payload->groups);
+        for (pkg_data = (struct payload_pkg_data *) zhashx_first(group_data->pkgs); pkg_data; pkg_data = (struct payload_pkg_data *) zhashx_next(group_data->pkgs)) {
+            pkg_id = (const char *) zhashx_cursor(group_data->pkgs);
+            for (cpu_data = (struct payload_cpu_data *) zhashx_first(pkg_data->cpus); cpu_data; cpu_data = (struct payload_cpu_data *) zhashx_next(pkg_data->cpus)) {
+                cpu_id = (const char *) zhashx_cursor(pkg_data->cpus);
+                for (event_value = (const uint64_t *) zhashx_first(cpu_data->events); event_value; event_value = (const uint64_t *) zhashx_next(cpu_data->events)) {
+                    event_name = (const char *) zhashx_cursor(cpu_data->events);
+
+                    /* when aggregating per socket, the values of the cpus of a package are accumulated in the same series */
+                    if (format_series_labels(ctx, labels, payload->target_name, group_name, pkg_id, cpu_id, event_name)) {
+                        num_skipped_series++;
+                        ret = -1;
+                        continue;
+                    }
+
+                    series = lookup_series(ctx, labels);
+                    if (!series) {
+                        ret = -1;
+                        continue;
+                    }
+
+                    series->value += *event_value;
+                    if (payload->timestamp > series->last_update)
+                        series->last_update = payload->timestamp;
+                }
+            }
+        }
+    }
+
+    sweep_idle_series(ctx, payload->timestamp);
+
+    pthread_mutex_unlock(&ctx->lock);
+
+    if (num_skipped_series)
+        zsys_error("prometheus: skipped %zu series of target=%s whose labels do not fit for timestamp=%" PRIu64, num_skipped_series, payload->target_name, payload->timestamp);
+    if (ret)
+        zsys_error("prometheus: failed to update some series for timestamp=%" PRIu64, payload->timestamp);
+
+    return ret;
+}
+
+static int
+prometheus_deinitialize(struct storage_module *module)
+{
+    struct prometheus_context *ctx = (struct prometheus_context *) module->context;
+
+    if (!module->is_initialized)
+        return 0;
+
+    zactor_destroy(&ctx->http_actor);
+    close(ctx->listen_fd);
+    ctx->listen_fd = -1;
+
+    module->is_initialized = false;
+    return 0;
+}
+
+static void
+prometheus_destroy(struct storage_module *module)
+{
+    if (!module)
+        return;
+
+    prometheus_context_destroy((struct prometheus_context *) module->context);
+}
+
+struct storage_module *
+storage_prometheus_create(struct config *config, const struct config_storage *storage)
+{
+    struct storage_module *module = NULL;
+    struct prometheus_context *ctx = NULL;
+
+    module = (struct storage_module *) malloc(sizeof(struct storage_module));
+    if (!module)
+        goto error;
+
+    ctx = prometheus_context_create(config->sensor.name, storage->prometheus.address, storage->prometheus.port, storage->prometheus.per_cpu);
+    if (!ctx)
+        goto error;
+
+    module->type = STORAGE_PROMETHEUS;
+    module->context = ctx;
+    module->is_initialized = false;
+    module->initialize = prometheus_initialize;
+    module->ping = prometheus_ping;
+    module->store_report = prometheus_store_report;
+    module->deinitialize = prometheus_deinitialize;
+    module->destroy = prometheus_destroy;
+
+    return module;
+
+error:
+    prometheus_context_destroy(ctx);
+    free(module);
+    return NULL;
+}
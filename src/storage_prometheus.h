@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef STORAGE_PROMETHEUS_H
+#define STORAGE_PROMETHEUS_H
+
+#include <czmq.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "storage.h"
+#include "config.h"
+
+/*
+ * PROMETHEUS_METRIC_NAME stores the name of the metric family exposing the events counters.
+ */
+#define PROMETHEUS_METRIC_NAME "hwpc_events"
+
+/*
+ * PROMETHEUS_OVERLOAD_METRIC_NAME stores the name of the gauge exposing the current widening of the sampling intervals.
+ */
+#define PROMETHEUS_OVERLOAD_METRIC_NAME "hwpc_sensor_overload_factor"
+
+/*
+ * PROMETHEUS_LABELS_MAX_SIZE stores the maximum size of the formatted labels of a series.
+ */
+#define PROMETHEUS_LABELS_MAX_SIZE 1024
+
+/*
+ * PROMETHEUS_SERIES_IDLE_TIMEOUT_MS stores the duration (in ms) after which a series that is no longer updated is removed.
+ */
+#define PROMETHEUS_SERIES_IDLE_TIMEOUT_MS 300000
+
+/*
+ * PROMETHEUS_REQUEST_MAX_SIZE stores the maximum size of a scrape request.
+ */
+#define PROMETHEUS_REQUEST_MAX_SIZE 4096
+
+/*
+ * PROMETHEUS_CLIENT_TIMEOUT_MS stores the maximum duration (in ms) of a read or write operation on a client connection.
+ */
+#define PROMETHEUS_CLIENT_TIMEOUT_MS 1000
+
+/*
+ * prometheus_config stores the required information for the module.
+ */
+struct prometheus_config
+{
+    const char *sensor_name;
+    const char *address;
+    const char *port;
+    bool per_cpu;
+};
+
+/*
+ * prometheus_series stores the cumulative value of a counter and its formatted labels.
+ */
+struct prometheus_series
+{
+    char *labels;
+    uint64_t value;
+    uint64_t last_update;
+};
+
+/*
+ * prometheus_context stores the context of the module.
+ * The series are updated by the reporting thread and formatted by the http actor, both holding the lock.
+ */
+struct prometheus_context
+{
+    struct prometheus_config config;
+    pthread_mutex_t lock;
+    struct prometheus_series *series; /* flat array of series */
+    size_t num_series;
+    size_t series_capacity;
+    zhashx_t *series_index; /* char *labels -> (uintptr_t) index of the series + 1 */
+    uint64_t last_sweep_timestamp;
+    unsigned int overload_factor; /* overload factor of the last stored report */
+    int listen_fd;
+    zactor_t *http_actor;
+};
+
+/*
+ * storage_prometheus_create creates and configure a prometheus storage module.
+ */
+struct storage_module *storage_prometheus_create(struct config *config, const struct config_storage *storage);
+
+#endif /* STORAGE_PROMETHEUS_H */
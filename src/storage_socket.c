@@ -174,10 +174,9 @@ socket_try_reconnect(struct socket_context *ctx)
     return -1;
 }
 
-static int
-socket_store_report(struct storage_module *module, struct payload *payload)
+struct json_object *
+socket_build_document(const char *sensor_name, struct payload *payload)
 {
-    struct socket_context *ctx = (struct socket_context *) module->context;
     struct json_object *jobj = NULL;
     struct json_object *jobj_groups = NULL;
     struct payload_group_data *group_data = NULL;
@@ -191,24 +190,21 @@ socket_store_report(struct storage_module *module, struct payload *payload)
     struct json_object *jobj_cpu = NULL;
     const char *event_name = NULL;
     uint64_t *event_value = NULL;
-    const char *json_report = NULL;
-    size_t json_report_length = 0;
-    struct iovec socket_iov[2] = {};
-    ssize_t nbsend;
-    int retry_once = 1;
-    int ret = -1;
-
-    /* try to reconnect the socket before building the document */
-    if (ctx->socket_fd == -1) {
-        if (socket_try_reconnect(ctx))
-            return -1;
-    }
 
     /*
      * {
      *    "timestamp": 1529868713854,
+     *    "read_timestamp": 1529868713857,
      *    "sensor": "test.cluster.lan",
      *    "target": "example",
+     *    "namespace": "default", (only when resolved for a container)
+     *    "pod": "example-pod", (only when resolved for a container)
+     *    "container": "example-container", (only when resolved for a container)
+     *    "interval_ms": 1000,
+     *    "interval_start": 1529868712855, (only when the sampling interval was widened)
+     *    "overload_factor": 2, (only when the sampling interval was widened)
+     *    "partial": true, (only for the first report of a target)
+     *    "setup_latency_ms": 42, (only for the first report of a target)
      *    "groups": {
      *      "group_name": {
      *          "pkg_id": {
@@ -229,8 +225,24 @@ socket_store_report(struct storage_module *module, struct payload *payload)
     jobj = json_object_new_object();
 
     json_object_object_add(jobj, "timestamp", json_object_new_uint64(payload->timestamp));
-    json_object_object_add(jobj, "sensor", json_object_new_string(ctx->config.sensor_name));
+    json_object_object_add(jobj, "read_timestamp", json_object_new_uint64(payload->read_timestamp));
+    json_object_object_add(jobj, "sensor", json_object_new_string(sensor_name));
     json_object_object_add(jobj, "target", json_object_new_string(payload->target_name));
+    if (payload->target_namespace)
+        json_object_object_add(jobj, "namespace", json_object_new_string(payload->target_namespace));
+    if (payload->target_pod)
+        json_object_object_add(jobj, "pod", json_object_new_string(payload->target_pod));
+    if (payload->target_container)
+        json_object_object_add(jobj, "container", json_object_new_string(payload->target_container));
+    json_object_object_add(jobj, "interval_ms", json_object_new_uint64(payload->interval_ms));
+    if (payload->overload_factor > 1) {
+        json_object_object_add(jobj, "interval_start", json_object_new_uint64(payload->interval_start_timestamp));
+        json_object_object_add(jobj, "overload_factor", json_object_new_uint64(payload->overload_factor));
+    }
+    if (payload->partial) {
+        json_object_object_add(jobj, "partial", json_object_new_boolean(true));
+        json_object_object_add(jobj, "setup_latency_ms", json_object_new_uint64(payload->setup_latency_ms));
+    }
 
     jobj_groups = json_object_new_object();
     json_object_object_add(jobj, "groups", jobj_groups);
@@ -257,6 +269,29 @@ socket_store_report(struct storage_module *module, struct payload *payload)
         }
     }
 
+    return jobj;
+}
+
+static int
+socket_store_report(struct storage_module *module, struct payload *payload)
+{
+    struct socket_context *ctx = (struct socket_context *) module->context;
+    struct json_object *jobj = NULL;
+    const char *json_report = NULL;
+    size_t json_report_length = 0;
+    struct iovec socket_iov[2] = {};
+    ssize_t nbsend;
+    int retry_once = 1;
+    int ret = -1;
+
+    /* try to reconnect the socket before building the document */
+    if (ctx->socket_fd == -1) {
+        if (socket_try_reconnect(ctx))
+            return -1;
+    }
+
+    jobj = socket_build_document(ctx->config.sensor_name, payload);
+
     json_report = json_object_to_json_string_length(jobj, JSON_C_TO_STRING_PLAIN | JSON_C_TO_STRING_NOSLASHESCAPE, &json_report_length);
     if (json_report == NULL) {
         zsys_error("socket: Failed to convert report to json string");
@@ -326,7 +361,7 @@ socket_destroy(struct storage_module *module)
 }
 
 struct storage_module *
-storage_socket_create(struct config *config)
+storage_socket_create(struct config *config, const struct config_storage *storage)
 {
     struct storage_module *module = NULL;
     struct socket_context *ctx = NULL;
@@ -335,7 +370,7 @@ storage_socket_create(struct config *config)
     if (!module)
         goto error;
 
-    ctx = socket_context_create(config->sensor.name, config->storage.socket.hostname, config->storage.socket.port);
+    ctx = socket_context_create(config->sensor.name, storage->socket.hostname, storage->socket.port);
     if (!ctx)
         goto error;
 
@@ -35,6 +35,8 @@
 #include "storage.h"
 #include "config.h"
 
+struct json_object;
+
 /*
  * MAX_DURATION_CONNECTION_RETRY stores the maximal value of a connection retry. (in seconds)
  */
@@ -61,9 +63,14 @@ struct socket_context
     time_t retry_backoff_time;
 };
 
+/*
+ * socket_build_document builds the json document sent for the given report, to be released with json_object_put.
+ */
+struct json_object *socket_build_document(const char *sensor_name, struct payload *payload);
+
 /*
  * storage_socket_create creates and configure a socket storage module.
  */
-struct storage_module *storage_socket_create(struct config *config);
+struct storage_module *storage_socket_create(struct config *config, const struct config_storage *storage);
 
 #endif /* STORAGE_SOCKET_H */
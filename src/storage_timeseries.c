@@ -0,0 +1,567 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h>
+#include <linux/limits.h>
+
+#include "storage.h"
+#include "storage_timeseries.h"
+#include "config.h"
+#include "util.h"
+
+/*
+ * TIMESERIES_SERIES_KEY_SIZE stores the maximum size of the key identifying a series.
+ */
+#define TIMESERIES_SERIES_KEY_SIZE 512
+
+static void
+series_destroy(struct timeseries_series **series_ptr)
+{
+    struct timeseries_series *series = *series_ptr;
+
+    if (!series)
+        return;
+
+    free(series->target_name);
+    ts_column_encoder_release(&series->timestamps);
+    ts_column_encoder_release(&series->intervals_ms);
+    ts_column_encoder_release(&series->partials);
+    ts_column_encoder_release(&series->overload_factors);
+    for (size_t i = 0; series->values && i < series->num_events; i++)
+        ts_column_encoder_release(&series->values[i]);
+    free(series->values);
+    free(series);
+    *series_ptr = NULL;
+}
+
+static struct timeseries_series *
+series_create(const char *target_name, unsigned int socket, unsigned int cpu, size_t num_events)
+{
+    struct timeseries_series *series = (struct timeseries_series *) calloc(1, sizeof(struct timeseries_series));
+
+    if (!series)
+        return NULL;
+
+    series->target_name = strdup(target_name);
+    series->socket = socket;
+    series->cpu = cpu;
+    series->num_events = num_events;
+    series->values = (struct ts_column_encoder *) calloc(num_events, sizeof(struct ts_column_encoder));
+
+    if (!series->target_name || !series->values) {
+        series_destroy(&series);
+        return NULL;
+    }
+
+    return series;
+}
+
+static void
+series_reset(struct timeseries_series *series)
+{
+    ts_column_encoder_reset(&series->timestamps);
+    ts_column_encoder_reset(&series->intervals_ms);
+    ts_column_encoder_reset(&series->partials);
+    ts_column_encoder_reset(&series->overload_factors);
+    for (size_t i = 0; i < series->num_events; i++)
+        ts_column_encoder_reset(&series->values[i]);
+}
+
+static int
+write_series_block(struct timeseries_group_writer *writer, struct timeseries_series *series)
+{
+    struct ts_buffer *block = &writer->block;
+    size_t data_size = series->timestamps.buffer.size + series->intervals_ms.buffer.size + series->partials.buffer.size + series->overload_factors.buffer.size;
+    int ret = 0;
+
+    if (series->timestamps.count == 0)
+        return 0;
+
+    for (size_t i = 0; i < series->num_events; i++)
+        data_size += series->values[i].buffer.size;
+
+    ts_buffer_clear(block);
+    ret |= ts_buffer_append(block, TIMESERIES_BLOCK_MAGIC, strlen(TIMESERIES_BLOCK_MAGIC));
+    ret |= ts_buffer_append_string(block, series->target_name);
+    ret |= ts_buffer_append_varint(block, series->socket);
+    ret |= ts_buffer_append_varint(block, series->cpu);
+    ret |= ts_buffer_append_varint(block, series->timestamps.count);
+    ret |= ts_buffer_append_varint(block, data_size);
+    ret |= ts_buffer_append(block, series->timestamps.buffer.data, series->timestamps.buffer.size);
+    ret |= ts_buffer_append(block, series->intervals_ms.buffer.data, series->intervals_ms.buffer.size);
+    ret |= ts_buffer_append(block, series->partials.buffer.data, series->partials.buffer.size);
+    ret |= ts_buffer_append(block, series->overload_factors.buffer.data, series->overload_factors.buffer.size);
+    for (size_t i = 0; i < series->num_events; i++)
+        ret |= ts_buffer_append(block, series->values[i].buffer.data, series->values[i].buffer.size);
+
+    if (ret || fwrite(block->data, block->size, 1, writer->file) != 1)
+        return -1;
+
+    /* each block is independently decodable */
+    series_reset(series);
+    return 0;
+}
+
+static void
+group_writer_destroy(struct timeseries_group_writer **writer_ptr)
+{
+    struct timeseries_group_writer *writer = *writer_ptr;
+
+    if (!writer)
+        return;
+
+    zhashx_destroy(&writer->series);
+    if (writer->file) {
+        fflush(writer->file);
+        fsync(fileno(writer->file));
+        fclose(writer->file);
+    }
+    zlistx_destroy(&writer->events_name);
+    ts_buffer_release(&writer->block);
+    free(writer);
+    *writer_ptr = NULL;
+}
+
+static struct timeseries_group_writer *
+group_writer_create(zlistx_t *events_name)
+{
+    struct timeseries_group_writer *writer = (struct timeseries_group_writer *) calloc(1, sizeof(struct timeseries_group_writer));
+
+    if (!writer)
+        return NULL;
+
+    writer->file = NULL;
+    writer->events_name = events_name;
+    writer->series = zhashx_new();
+    zhashx_set_destructor(writer->series, (zhashx_destructor_fn *) series_destroy);
+    writer->last_sweep_timestamp = 0;
+
+    return writer;
+}
+
+static int
+flush_group_writer(struct timeseries_group_writer *writer)
+{
+    struct timeseries_series *series = NULL;
+    int ret = 0;
+
+    for (series = (struct timeseries_series *) zhashx_first(writer->series); series; series = (struct timeseries_series *) zhashx_next(writer->series)) {
+        if (write_series_block(writer, series))
+            ret = -1;
+    }
+
+    fflush(writer->file);
+    return ret;
+}
+
+static struct timeseries_context *
+timeseries_context_create(const char *sensor_name, const char *output_dir, unsigned int block_size)
+{
+    struct timeseries_context *ctx = (struct timeseries_context *) malloc(sizeof(struct timeseries_context));
+
+    if (!ctx)
+        return NULL;
+
+    ctx->config.sensor_name = sensor_name;
+    ctx->config.output_dir = output_dir;
+    ctx->config.block_size = (block_size) ? block_size : TIMESERIES_DEFAULT_BLOCK_SIZE;
+
+    ctx->groups_writer = zhashx_new();
+    zhashx_set_destructor(ctx->groups_writer, (zhashx_destructor_fn *) group_writer_destroy);
+
+    return ctx;
+}
+
+static void
+timeseries_context_destroy(struct timeseries_context *ctx)
+{
+    if (!ctx)
+        return;
+
+    zhashx_destroy(&ctx->groups_writer);
+    free(ctx);
+}
+
+static int
+timeseries_initialize(struct storage_module *module)
+{
+    struct timeseries_context *ctx = (struct timeseries_context *) module->context;
+    struct stat outdir_stat = {};
+
+    errno = 0;
+    if (mkdir(ctx->config.output_dir, 0755) == -1 && errno != EEXIST) {
+        zsys_error("timeseries: failed to create output directory: %s", strerror(errno));
+        return -1;
+    }
+
+    errno = 0;
+    if (stat(ctx->config.output_dir, &outdir_stat) == -1) {
+        zsys_error("timeseries: failed to check output dir: %s", strerror(errno));
+        return -1;
+    }
+    if (!S_ISDIR(outdir_stat.st_mode)) {
+        zsys_error("timeseries: output path already exists and is not a directory");
+        return -1;
+    }
+
+    errno = 0;
+    if (access(ctx->config.output_dir, W_OK)) {
+        zsys_error("timeseries: output path is not writable: %s", strerror(errno));
+        return -1;
+    }
+
+    module->is_initialized = true;
+    return 0;
+}
+
+static int
+timeseries_ping(struct storage_module *module __attribute__ ((unused)))
+{
+    /* ping is not needed because the relevant checks are done when initializing the module */
+    return 0;
+}
+
+static int
+build_segment_path(struct timeseries_context *ctx, const char *group_name, unsigned int attempt, char *path)
+{
+    char timestamp[32] = {};
+    time_t now = time(NULL);
+    struct tm tm = {};
+    int len;
+
+    if (!gmtime_r(&now, &tm) || !strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%SZ", &tm))
+        return -1;
+
+    if (attempt == 0)
+        len = snprintf(path, PATH_MAX, "%s/%s-%s.hwpcts", ctx->config.output_dir, group_name, timestamp);
+    else
+        len = snprintf(path, PATH_MAX, "%s/%s-%s-%u.hwpcts", ctx->config.output_dir, group_name, timestamp, attempt);
+
+    return len >= PATH_MAX;
+}
+
+static int
+open_group_outfile(struct timeseries_context *ctx, const char *group_name, struct timeseries_group_writer *writer)
+{
+    char path[PATH_MAX] = {};
+    const char *event_name = NULL;
+    struct ts_buffer *header = &writer->block;
+    int ret = 0;
+    int fd = -1;
+
+    /* files opened during the same second, by a quick restart or a reinitialization, get a numbered suffix */
+    for (unsigned int attempt = 0; fd == -1 && attempt < TIMESERIES_SEGMENT_NAME_MAX_ATTEMPTS; attempt++) {
+        if (build_segment_path(ctx, group_name, attempt, path)) {
+            zsys_error("timeseries: the destination path for output file of group %s is too long", group_name);
+            return -1;
+        }
+
+        errno = 0;
+        fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd == -1 && errno != EEXIST)
+            break;
+    }
+
+    if (fd == -1) {
+        zsys_error("timeseries: failed to open output file for group %s: %s", group_name, strerror(errno));
+        return -1;
+    }
+
+    writer->file = fdopen(fd, "w");
+    if (!writer->file) {
+        zsys_error("timeseries: failed to associate a stream to output file of group %s: %s", group_name, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    ts_buffer_clear(header);
+    ret |= ts_buffer_append(header, TIMESERIES_FILE_MAGIC, strlen(TIMESERIES_FILE_MAGIC));
+    ret |= ts_buffer_append_string(header, ctx->config.sensor_name);
+    ret |= ts_buffer_append_string(header, group_name);
+    ret |= ts_buffer_append_varint(header, zlistx_size(writer->events_name));
+    for (event_name = (const char *) zlistx_first(writer->events_name); event_name; event_name = (const char *) zlistx_next(writer->events_name))
+        ret |= ts_buffer_append_string(header, event_name);
+
+    if (ret || fwrite(header->data, header->size, 1, writer->file) != 1)
+        return -1;
+
+    return 0;
+}
+
+static struct timeseries_group_writer *
+setup_group_writer(struct timeseries_context *ctx, const char *group_name, zhashx_t *events)
+{
+    zlistx_t *events_name = NULL;
+    struct timeseries_group_writer *writer = NULL;
+
+    /* the schema of the group is defined by the events of its first report */
+    events_name = zhashx_keys(events);
+    if (!events_name)
+        return NULL;
+
+    zlistx_set_comparator(events_name, (zlistx_comparator_fn *) strcmp);
+    zlistx_sort(events_name);
+
+    writer = group_writer_create(events_name);
+    if (!writer) {
+        zlistx_destroy(&events_name);
+        return NULL;
+    }
+
+    if (open_group_outfile(ctx, group_name, writer)) {
+        group_writer_destroy(&writer);
+        return NULL;
+    }
+
+    zhashx_insert(ctx->groups_writer, group_name, writer);
+    return writer;
+}
+
+static struct timeseries_series *
+lookup_series(struct timeseries_group_writer *writer, const char *target_name, const char *pkg_id, const char *cpu_id)
+{
+    char key[TIMESERIES_SERIES_KEY_SIZE] = {};
+    unsigned int socket = 0;
+    unsigned int cpu = 0;
+    struct timeseries_series *series = NULL;
+
+    if (snprintf(key, TIMESERIES_SERIES_KEY_SIZE, "%s/%s/%s", pkg_id, cpu_id, target_name) >= TIMESERIES_SERIES_KEY_SIZE)
+        return NULL;
+
+    series = (struct timeseries_series *) zhashx_lookup(writer->series, key);
+    if (series)
+        return series;
+
+    if (str_to_uint(pkg_id, &socket) || str_to_uint(cpu_id, &cpu))
+        return NULL;
+
+    series = series_create(target_name, socket, cpu, zlistx_size(writer->events_name));
+    if (!series)
+        return NULL;
+
+    zhashx_insert(writer->series, key, series);
+    return series;
+}
+
+static int
+append_point(struct timeseries_context *ctx, struct timeseries_group_writer *writer, struct timeseries_series *series, const struct payload *payload, zhashx_t *events)
+{
+    const char *event_name = NULL;
+    const uint64_t *event_value = NULL;
+    size_t event_i = 0;
+    int ret = 0;
+
+    /* the columns of a block must have the same number of values to be decodable, a point is appended to all or none */
+    for (event_name = (const char *) zlistx_first(writer->events_name); event_name; event_name = (const char *) zlistx_next(writer->events_name)) {
+        if (!zhashx_lookup(events, event_name))
+            return -1;
+    }
+
+    for (event_name = (const char *) zlistx_first(writer->events_name); event_name; event_name = (const char *) zlistx_next(writer->events_name), event_i++) {
+        event_value = (const uint64_t *) zhashx_lookup(events, event_name);
+        ret |= ts_column_encoder_append(&series->values[event_i], *event_value);
+    }
+    ret |= ts_column_encoder_append(&series->timestamps, payload->timestamp);
+    ret |= ts_column_encoder_append(&series->intervals_ms, payload->interval_ms);
+    ret |= ts_column_encoder_append(&series->partials, (payload->partial) ? 1 : 0);
+    ret |= ts_column_encoder_append(&series->overload_factors, payload->overload_factor);
+
+    /* the points of the block are dropped when a column cannot be extended */
+    if (ret) {
+        zsys_error("timeseries: dropping %zu points of target=%s pkg=%u cpu=%u", series->timestamps.count, series->target_name, series->socket, series->cpu);
+        series_reset(series);
+        return -1;
+    }
+
+    series->last_timestamp = payload->timestamp;
+
+    if (series->timestamps.count >= ctx->config.block_size)
+        return write_series_block(writer, series);
+
+    return 0;
+}
+
+static int
+sweep_idle_series(struct timeseries_group_writer *writer, uint64_t timestamp)
+{
+    struct timeseries_series *series = NULL;
+    zlistx_t *idle_series = NULL;
+    const char *key = NULL;
+    int ret = 0;
+
+    if (timestamp - writer->last_sweep_timestamp < TIMESERIES_SERIES_IDLE_TIMEOUT_MS)
+        return 0;
+
+    writer->last_sweep_timestamp = timestamp;
+
+    /* write and release the series of the targets that are no longer reporting */
+    idle_series = zlistx_new();
+    for (series = (struct timeseries_series *) zhashx_first(writer->series); series; series = (struct timeseries_series *) zhashx_next(writer->series)) {
+        if (timestamp - series->last_timestamp < TIMESERIES_SERIES_IDLE_TIMEOUT_MS)
+            continue;
+
+        /* a series that cannot be written is kept to not lose its points */
+        if (write_series_block(writer, series)) {
+            zsys_error("timeseries: failed to write the idle series of target=%s pkg=%u cpu=%u", series->target_name, series->socket, series->cpu);
+            ret = -1;
+            continue;
+        }
+
+        zlistx_add_end(idle_series, (void *) zhashx_cursor(writer->series));
+    }
+
+    for (key = (const char *) zlistx_first(idle_series); key; key = (const char *) zlistx_next(idle_series))
+        zhashx_delete(writer->series, key);
+
+    zlistx_destroy(&idle_series);
+    return ret;
+}
+
+static int
+timeseries_store_report(struct storage_module *module, struct payload *payload)
+{
+    struct timeseries_context *ctx = (struct timeseries_context *) module->context;
+    struct payload_group_data *group_data = NULL;
+    const char *group_name = NULL;
+    struct timeseries_group_writer *writer = NULL;
+    struct timeseries_series *series = NULL;
+    struct payload_pkg_data *pkg_data = NULL;
+    const char *pkg_id = NULL;
+    struct payload_cpu_data *cpu_data = NULL;
+    const char *cpu_id = NULL;
+
+    for (group_data = (struct payload_group_data *) zhashx_first(payload->groups); group_data; group_data = (struct payload_group_data *) zhashx_next(payload->groups)) {
+        group_name = (const char *) zhashx_cursor(payload->groups);
+        writer = (struct timeseries_group_writer *) zhashx_lookup(ctx->groups_writer, group_name);
+
+        for (pkg_data = (struct payload_pkg_data *) zhashx_first(group_data->pkgs); pkg_data; pkg_data = (struct payload_pkg_data *) zhashx_next(group_data->pkgs)) {
+            pkg_id = (const char *) zhashx_cursor(group_data->pkgs);
+
+            for (cpu_data = (struct payload_cpu_data *) zhashx_first(pkg_data->cpus); cpu_data; cpu_data = (struct payload_cpu_data *) zhashx_next(pkg_data->cpus)) {
+                cpu_id = (const char *) zhashx_cursor(pkg_data->cpus);
+
+                if (!writer) {
+                    writer = setup_group_writer(ctx, group_name, cpu_data->events);
+                    if (!writer) {
+                        zsys_error("timeseries: failed to setup output file for group=%s", group_name);
+                        return -1;
+                    }
+                    writer->last_sweep_timestamp = payload->timestamp;
+                }
+
+                series = lookup_series(writer, payload->target_name, pkg_id, cpu_id);
+                if (!series) {
+                    zsys_error("timeseries: failed to setup series for group=%s target=%s pkg=%s cpu=%s", group_name, payload->target_name, pkg_id, cpu_id);
+                    return -1;
+                }
+
+                if (append_point(ctx, writer, series, payload, cpu_data->events)) {
+                    zsys_error("timeseries: failed to write report for group=%s timestamp=%" PRIu64, group_name, payload->timestamp);
+                    return -1;
+                }
+            }
+        }
+
+        if (writer && sweep_idle_series(writer, payload->timestamp)) {
+            zsys_error("timeseries: failed to release the idle series for group=%s", group_name);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+timeseries_deinitialize(struct storage_module *module)
+{
+    struct timeseries_context *ctx = (struct timeseries_context *) module->context;
+    struct timeseries_group_writer *writer = NULL;
+    const char *group_name = NULL;
+
+    if (!module->is_initialized)
+        return 0;
+
+    /* write the partially filled blocks */
+    for (writer = (struct timeseries_group_writer *) zhashx_first(ctx->groups_writer); writer; writer = (struct timeseries_group_writer *) zhashx_next(ctx->groups_writer)) {
+        group_name = (const char *) zhashx_cursor(ctx->groups_writer);
+        if (flush_group_writer(writer))
+            zsys_error("timeseries: failed to write the last blocks for group=%s", group_name);
+    }
+
+    /* close the output files, a new file is created for each group if the module is initialized again */
+    zhashx_purge(ctx->groups_writer);
+
+    module->is_initialized = false;
+    return 0;
+}
+
+static void
+timeseries_destroy(struct storage_module *module)
+{
+    if (!module)
+        return;
+
+    timeseries_context_destroy((struct timeseries_context *) module->context);
+}
+
+struct storage_module *
+storage_timeseries_create(struct config *config, const struct config_storage *storage)
+{
+    struct storage_module *module = NULL;
+    struct timeseries_context *ctx = NULL;
+
+    module = (struct storage_module *) malloc(sizeof(struct storage_module));
+    if (!module)
+        goto error;
+
+    ctx = timeseries_context_create(config->sensor.name, storage->timeseries.outdir, storage->timeseries.block_size);
+    if (!ctx)
+        goto error;
+
+    module->type = STORAGE_TIMESERIES;
+    module->context = ctx;
+    module->is_initialized = false;
+    module->initialize = timeseries_initialize;
+    module->ping = timeseries_ping;
+    module->store_report = timeseries_store_report;
+    module->deinitialize = timeseries_deinitialize;
+    module->destroy = timeseries_destroy;
+
+    return module;
+
+error:
+    timeseries_context_destroy(ctx);
+    free(module);
+    return NULL;
+}
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef STORAGE_TIMESERIES_H
+#define STORAGE_TIMESERIES_H
+
+#include <czmq.h>
+#include <stdint.h>
+
+#include "storage.h"
+#include "config.h"
+#include "timeseries.h"
+
+/*
+ * TIMESERIES_DEFAULT_BLOCK_SIZE stores the default maximum number of points of a block.
+ */
+#define TIMESERIES_DEFAULT_BLOCK_SIZE 256
+
+/*
+ * TIMESERIES_SERIES_IDLE_TIMEOUT_MS stores the duration (in ms) after which an idle series is written and released.
+ */
+#define TIMESERIES_SERIES_IDLE_TIMEOUT_MS 60000
+
+/*
+ * TIMESERIES_SEGMENT_NAME_MAX_ATTEMPTS stores the maximum number of suffixes tried to find a free name for a new output file.
+ */
+#define TIMESERIES_SEGMENT_NAME_MAX_ATTEMPTS 100
+
+/*
+ * timeseries_config stores the required information for the module.
+ */
+struct timeseries_config
+{
+    const char *sensor_name;
+    const char *output_dir;
+    unsigned int block_size;
+};
+
+/*
+ * timeseries_series stores the encoding state of the values of a (target, socket, cpu) tuple.
+ */
+struct timeseries_series
+{
+    char *target_name;
+    unsigned int socket;
+    unsigned int cpu;
+    uint64_t last_timestamp;
+    struct ts_column_encoder timestamps;
+    struct ts_column_encoder intervals_ms;
+    struct ts_column_encoder partials;
+    struct ts_column_encoder overload_factors;
+    size_t num_events;
+    struct ts_column_encoder *values; /* one encoder per event, in the order of the group header */
+};
+
+/*
+ * timeseries_group_writer stores the output file and the series of an events group.
+ */
+struct timeseries_group_writer
+{
+    FILE *file;
+    zlistx_t *events_name; /* char *event_name (sorted) */
+    zhashx_t *series; /* char *series_key -> struct timeseries_series *series */
+    uint64_t last_sweep_timestamp;
+    struct ts_buffer block; /* scratch buffer used to build a block */
+};
+
+/*
+ * timeseries_context stores the context of the module.
+ */
+struct timeseries_context
+{
+    struct timeseries_config config;
+    zhashx_t *groups_writer; /* char *group_name -> struct timeseries_group_writer *writer */
+};
+
+/*
+ * storage_timeseries_create creates and configure a timeseries storage module.
+ */
+struct storage_module *storage_timeseries_create(struct config *config, const struct config_storage *storage);
+
+#endif /* STORAGE_TIMESERIES_H */
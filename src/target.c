@@ -50,6 +50,10 @@ target_create(enum target_type type, const char *cgroup_basedir, const char *cgr
 
     target->cgroup_basedir = cgroup_basedir;
     target->cgroup_path = (cgroup_path) ? strdup(cgroup_path) : NULL;
+    target->name = NULL;
+    target->namespace_name = NULL;
+    target->pod_name = NULL;
+    target->container_name = NULL;
     target->type = type;
 
     return target;
@@ -65,6 +69,11 @@ target_resolve_real_name(struct target *target)
             target_real_name = strdup("all");
             break;
 
+        case TARGET_TYPE_CGROUP:
+            if (target->name)
+                target_real_name = strdup(target->name);
+            break;
+
         default:
             break;
     }
@@ -84,15 +93,128 @@ target_destroy(struct target *target)
         return;
 
     free(target->cgroup_path);
+    free(target->name);
+    free(target->namespace_name);
+    free(target->pod_name);
+    free(target->container_name);
     free(target);
 }
 
+static int
+compile_patterns(zlistx_t *patterns, regex_t **compiled_ptr, size_t *num_compiled)
+{
+    regex_t *compiled = NULL;
+    const char *pattern = NULL;
+
+    *compiled_ptr = NULL;
+    *num_compiled = 0;
+
+    if (!patterns || zlistx_size(patterns) == 0)
+        return 0;
+
+    compiled = (regex_t *) calloc(zlistx_size(patterns), sizeof(regex_t));
+    if (!compiled)
+        return -1;
+
+    *compiled_ptr = compiled;
+    for (pattern = (const char *) zlistx_first(patterns); pattern; pattern = (const char *) zlistx_next(patterns)) {
+        if (regcomp(&compiled[*num_compiled], pattern, REG_EXTENDED | REG_NOSUB))
+            return -1;
+        (*num_compiled)++;
+    }
+
+    return 0;
+}
+
+static void
+free_patterns(regex_t **compiled_ptr, size_t *num_compiled)
+{
+    for (size_t i = 0; i < *num_compiled; i++)
+        regfree(&(*compiled_ptr)[i]);
+
+    free(*compiled_ptr);
+    *compiled_ptr = NULL;
+    *num_compiled = 0;
+}
+
+static bool
+match_any_pattern(const regex_t *compiled, size_t num_compiled, const char *str)
+{
+    for (size_t i = 0; i < num_compiled; i++) {
+        if (!regexec(&compiled[i], str, 0, NULL, 0))
+            return true;
+    }
+
+    return false;
+}
+
+struct target_discovery *
+target_discovery_create(const char *base_path, unsigned int depth, const char *pattern, zlistx_t *include, zlistx_t *exclude)
+{
+    struct target_discovery *discovery = (struct target_discovery *) calloc(1, sizeof(struct target_discovery));
+
+    if (!discovery)
+        return NULL;
+
+    discovery->base_path = base_path;
+    discovery->depth = depth;
+    discovery->has_pattern = false;
+
+    if (pattern && strlen(pattern)) {
+        if (regcomp(&discovery->pattern, pattern, REG_EXTENDED | REG_NOSUB))
+            goto error;
+        discovery->has_pattern = true;
+    }
+
+    if (compile_patterns(include, &discovery->include, &discovery->num_include))
+        goto error;
+
+    if (compile_patterns(exclude, &discovery->exclude, &discovery->num_exclude))
+        goto error;
+
+    return discovery;
+
+error:
+    target_discovery_destroy(&discovery);
+    return NULL;
+}
+
+void
+target_discovery_destroy(struct target_discovery **discovery_ptr)
+{
+    struct target_discovery *discovery = *discovery_ptr;
+
+    if (!discovery)
+        return;
+
+    if (discovery->has_pattern)
+        regfree(&discovery->pattern);
+
+    free_patterns(&discovery->include, &discovery->num_include);
+    free_patterns(&discovery->exclude, &discovery->num_exclude);
+    free(discovery);
+    *discovery_ptr = NULL;
+}
+
+static bool
+is_aggregation_cgroup(const struct target_discovery *discovery, const FTSENT *node, const char *relative_path)
+{
+    if (discovery->depth && node->fts_level == (short) discovery->depth)
+        return true;
+
+    if (discovery->has_pattern && !regexec(&discovery->pattern, relative_path, 0, NULL, 0))
+        return true;
+
+    return false;
+}
+
 int
-target_discover_running(const char *base_path, zhashx_t *targets)
+target_discover_running(struct target_discovery *discovery, zhashx_t *targets)
 {
-    const char *path[] = { base_path, NULL };
+    const char *path[] = { discovery->base_path, NULL };
     FTS *file_system = NULL;
     FTSENT *node = NULL;
+    const char *relative_path = NULL;
     struct target *target = NULL;
 
     file_system = fts_open((char * const *) path, FTS_PHYSICAL | FTS_NOCHDIR | FTS_NOSTAT, NULL);
@@ -109,6 +231,36 @@ target_discover_running(const char *base_path, zhashx_t *targets)
             if (node->fts_parent)
                 node->fts_parent->fts_number = 1;
 
+            /* The root is included when there is no include rule, the inclusion is then inherited by the descendants */
+            if (node->fts_level == FTS_ROOTLEVEL) {
+                node->fts_pointer = (discovery->num_include == 0) ? (void *) node : NULL;
+                continue;
+            }
+
+            relative_path = node->fts_path + strlen(discovery->base_path);
+
+            /* An excluded subtree is neither traversed nor reported */
+            if (match_any_pattern(discovery->exclude, discovery->num_exclude, relative_path)) {
+                node->fts_number = 1;
+                fts_set(file_system, node, FTS_SKIP);
+                continue;
+            }
+
+            node->fts_pointer = (node->fts_parent->fts_pointer || match_any_pattern(discovery->include, discovery->num_include, relative_path)) ? (void *) node : NULL;
+
+            /*
+             * An aggregation cgroup is monitored as a whole, the events of its descendants are counted by the kernel.
+             * Its subtree is skipped and the directory is marked to not be reported again in post-order.
+             */
+            if (is_aggregation_cgroup(discovery, node, relative_path)) {
+                node->fts_number = 1;
+                fts_set(file_system, node, FTS_SKIP);
+                if (node->fts_pointer) {
+                    target = target_create(TARGET_TYPE_CGROUP, discovery->base_path, node->fts_path);
+                    zhashx_insert(targets, node->fts_path, target);
+                }
+            }
+
             continue;
         }
 
@@ -123,7 +275,11 @@ target_discover_running(const char *base_path, zhashx_t *targets)
         if (node->fts_number != 0)
             continue;
 
-        target = target_create(TARGET_TYPE_CGROUP, base_path, node->fts_path);
+        /* Not matching any include rule */
+        if (!node->fts_pointer)
+            continue;
+
+        target = target_create(TARGET_TYPE_CGROUP, discovery->base_path, node->fts_path);
         zhashx_insert(targets, node->fts_path, target);
     }
 
@@ -33,6 +33,7 @@
 #define TARGET_H
 
 #include <czmq.h>
+#include <regex.h>
 
 
 /*
@@ -52,6 +53,29 @@ struct target
     enum target_type type;
     const char *cgroup_basedir;
     char *cgroup_path;
+    char *name; /* resolved name, NULL to use the cgroup path */
+    char *namespace_name; /* resolved metadata of a container target, NULL if unknown */
+    char *pod_name;
+    char *container_name;
+};
+
+/*
+ * target_discovery stores the rules used to select the cgroups to monitor.
+ * A cgroup is monitored when it is at the configured depth or when its path matches the pattern, its descendants are then
+ * not traversed and are accounted to it. Otherwise, the leaf cgroups are monitored.
+ * The subtrees matching an exclude rule are not traversed, and only the cgroups matching (or having an ancestor matching)
+ * an include rule are monitored when include rules are set.
+ */
+struct target_discovery
+{
+    const char *base_path;
+    unsigned int depth; /* 0 to disable */
+    bool has_pattern;
+    regex_t pattern; /* matched against the cgroup path relative to the base path */
+    size_t num_include;
+    regex_t *include;
+    size_t num_exclude;
+    regex_t *exclude;
 };
 
 /*
@@ -69,9 +93,19 @@ char *target_resolve_real_name(struct target *target);
  */
 void target_destroy(struct target *target);
 
+/*
+ * target_discovery_create allocate the resources and compile the rules used to discover the running targets.
+ */
+struct target_discovery *target_discovery_create(const char *base_path, unsigned int depth, const char *pattern, zlistx_t *include, zlistx_t *exclude);
+
+/*
+ * target_discovery_destroy free the allocated resources for the discovery rules.
+ */
+void target_discovery_destroy(struct target_discovery **discovery_ptr);
+
 /*
  * target_discover_running returns a list of running targets.
  */
-int target_discover_running(const char *base_path, zhashx_t *targets);
+int target_discover_running(struct target_discovery *discovery, zhashx_t *targets);
 
 #endif /* TARGET_H */
@@ -0,0 +1,482 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <json.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "target.h"
+#include "target_resolver.h"
+
+/*
+ * container_id_prefixes stores the prefixes added by the runtimes to the cgroup name of a container.
+ */
+static const char *container_id_prefixes[] = { "cri-containerd-", "containerd-", "crio-", "docker-", "libpod-", NULL };
+
+/*
+ * oci_annotations_source stores the location and the annotations keys of the state of the containers of a runtime.
+ */
+struct oci_annotations_source
+{
+    const char *state_dir; /* relative to the host root */
+    const char *config_file; /* relative to the container state directory */
+    const char *container_name_key;
+    const char *pod_name_key;
+    const char *namespace_name_key;
+};
+
+static const struct oci_annotations_source oci_annotations_sources[] = {
+    /* containerd (CRI plugin) */
+    { "run/containerd/io.containerd.runtime.v2.task/k8s.io", "config.json", "io.kubernetes.cri.container-name", "io.kubernetes.cri.sandbox-name", "io.kubernetes.cri.sandbox-namespace" },
+    /* CRI-O */
+    { "run/containers/storage/overlay-containers", "userdata/config.json", "io.kubernetes.container.name", "io.kubernetes.pod.name", "io.kubernetes.pod.namespace" },
+    { NULL, NULL, NULL, NULL, NULL },
+};
+
+static void
+target_metadata_destroy(struct target_metadata **metadata_ptr)
+{
+    struct target_metadata *metadata = *metadata_ptr;
+
+    if (!metadata)
+        return;
+
+    free(metadata->container_name);
+    free(metadata->pod_name);
+    free(metadata->namespace_name);
+    free(metadata->name);
+    free(metadata);
+    *metadata_ptr = NULL;
+}
+
+static struct target_metadata *
+target_metadata_create(void)
+{
+    return (struct target_metadata *) calloc(1, sizeof(struct target_metadata));
+}
+
+struct target_resolver *
+target_resolver_create(const char *host_root)
+{
+    struct target_resolver *resolver = (struct target_resolver *) malloc(sizeof(struct target_resolver));
+
+    if (!resolver)
+        return NULL;
+
+    /* the separator is added when building the paths */
+    snprintf(resolver->host_root, PATH_MAX, "%s", (host_root && strcmp(host_root, "/")) ? host_root : "");
+
+    resolver->cache = zhashx_new();
+    zhashx_set_destructor(resolver->cache, (zhashx_destructor_fn *) target_metadata_destroy);
+
+    resolver->cgroups_id = zhashx_new();
+    zhashx_set_duplicator(resolver->cgroups_id, (zhashx_duplicator_fn *) strdup);
+    zhashx_set_destructor(resolver->cgroups_id, (zhashx_destructor_fn *) zstr_free);
+
+    return resolver;
+}
+
+void
+target_resolver_destroy(struct target_resolver **resolver_ptr)
+{
+    struct target_resolver *resolver = *resolver_ptr;
+
+    if (!resolver)
+        return;
+
+    zhashx_destroy(&resolver->cache);
+    zhashx_destroy(&resolver->cgroups_id);
+    free(resolver);
+    *resolver_ptr = NULL;
+}
+
+static bool
+is_container_id(const char *str, size_t length)
+{
+    if (length != CONTAINER_ID_LENGTH)
+        return false;
+
+    for (size_t i = 0; i < length; i++) {
+        if (!isxdigit((unsigned char) str[i]))
+            return false;
+    }
+
+    return true;
+}
+
+static void
+parse_container_id(struct target_metadata *metadata, const char *name)
+{
+    size_t length = strlen(name);
+    size_t prefix_length = 0;
+
+    /* systemd cgroup driver: <prefix><id>.scope, cgroupfs driver: <id> */
+    if (length > strlen(".scope") && !strcmp(name + length - strlen(".scope"), ".scope"))
+        length -= strlen(".scope");
+
+    for (const char **prefix = container_id_prefixes; *prefix; prefix++) {
+        prefix_length = strlen(*prefix);
+        if (!strncmp(name, *prefix, prefix_length)) {
+            name += prefix_length;
+            length -= prefix_length;
+            break;
+        }
+    }
+
+    if (is_container_id(name, length))
+        snprintf(metadata->container_id, sizeof(metadata->container_id), "%.*s", (int) length, name);
+}
+
+static void
+parse_pod_uid(struct target_metadata *metadata, const char *name)
+{
+    const char *uid = NULL;
+    size_t length = 0;
+
+    /* systemd cgroup driver: kubepods[-<qos>]-pod<uid>.slice with '_' instead of '-' in the uid, cgroupfs driver: pod<uid> */
+    uid = strstr(name, "-pod");
+    if (uid)
+        uid += strlen("-pod");
+    else if (!strncmp(name, "pod", strlen("pod")))
+        uid = name + strlen("pod");
+    else
+        return;
+
+    length = strlen(uid);
+    if (length > strlen(".slice") && !strcmp(uid + length - strlen(".slice"), ".slice"))
+        length -= strlen(".slice");
+
+    if (length == 0 || length > POD_UID_MAX_LENGTH)
+        return;
+
+    for (size_t i = 0; i < length; i++) {
+        if (!isxdigit((unsigned char) uid[i]) && uid[i] != '-' && uid[i] != '_')
+            return;
+        metadata->pod_uid[i] = (uid[i] == '_') ? '-' : uid[i];
+    }
+    metadata->pod_uid[length] = '\0';
+}
+
+void
+target_metadata_parse_cgroup_path(struct target_metadata *metadata, const char *cgroup_path)
+{
+    char *path = strdup(cgroup_path);
+    char *saveptr = NULL;
+    char *name = NULL;
+
+    if (!path)
+        return;
+
+    for (name = strtok_r(path, "/", &saveptr); name; name = strtok_r(NULL, "/", &saveptr)) {
+        parse_pod_uid(metadata, name);
+        parse_container_id(metadata, name);
+    }
+
+    free(path);
+}
+
+static void
+set_metadata_field(char **field, const char *value)
+{
+    if (*field || !value || !strlen(value))
+        return;
+
+    *field = strdup(value);
+}
+
+static json_object *
+load_json_file(const char *path)
+{
+    /* the runtimes state files are optional, a missing file is not an error */
+    if (access(path, R_OK))
+        return NULL;
+
+    return json_object_from_file(path);
+}
+
+static const char *
+get_json_string(json_object *obj, const char *key)
+{
+    json_object *value = NULL;
+
+    if (!obj || !json_object_object_get_ex(obj, key, &value) || !json_object_is_type(value, json_type_string))
+        return NULL;
+
+    return json_object_get_string(value);
+}
+
+static void
+resolve_from_oci_annotations(struct target_resolver *resolver, struct target_metadata *metadata)
+{
+    char path[PATH_MAX] = {};
+    json_object *config = NULL;
+    json_object *annotations = NULL;
+
+    for (const struct oci_annotations_source *source = oci_annotations_sources; source->state_dir; source++) {
+        if (snprintf(path, PATH_MAX, "%s/%s/%s/%s", resolver->host_root, source->state_dir, metadata->container_id, source->config_file) >= PATH_MAX)
+            continue;
+
+        config = load_json_file(path);
+        if (!config)
+            continue;
+
+        if (json_object_object_get_ex(config, "annotations", &annotations)) {
+            set_metadata_field(&metadata->container_name, get_json_string(annotations, source->container_name_key));
+            set_metadata_field(&metadata->pod_name, get_json_string(annotations, source->pod_name_key));
+            set_metadata_field(&metadata->namespace_name, get_json_string(annotations, source->namespace_name_key));
+        }
+
+        json_object_put(config);
+        return;
+    }
+}
+
+static void
+resolve_from_docker_config(struct target_resolver *resolver, struct target_metadata *metadata)
+{
+    char path[PATH_MAX] = {};
+    json_object *config = NULL;
+    json_object *container_config = NULL;
+    json_object *labels = NULL;
+    const char *name = NULL;
+
+    if (snprintf(path, PATH_MAX, "%s/var/lib/docker/containers/%s/config.v2.json", resolver->host_root, metadata->container_id) >= PATH_MAX)
+        return;
+
+    config = load_json_file(path);
+    if (!config)
+        return;
+
+    /* containers managed by the kubelet (dockershim) are labelled with their pod information */
+    if (json_object_object_get_ex(config, "Config", &container_config) && json_object_object_get_ex(container_config, "Labels", &labels)) {
+        set_metadata_field(&metadata->container_name, get_json_string(labels, "io.kubernetes.container.name"));
+        set_metadata_field(&metadata->pod_name, get_json_string(labels, "io.kubernetes.pod.name"));
+        set_metadata_field(&metadata->namespace_name, get_json_string(labels, "io.kubernetes.pod.namespace"));
+    }
+
+    /* the name of a docker container is prefixed by a slash */
+    name = get_json_string(config, "Name");
+    if (name && name[0] == '/')
+        name++;
+    set_metadata_field(&metadata->container_name, name);
+
+    json_object_put(config);
+}
+
+static void
+resolve_from_containers_logs(struct target_resolver *resolver, struct target_metadata *metadata)
+{
+    char path[PATH_MAX] = {};
+    char suffix[CONTAINER_ID_LENGTH + 8] = {};
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+    size_t name_length = 0;
+    size_t suffix_length = 0;
+    char *fields = NULL;
+    char *pod_name = NULL;
+    char *namespace_name = NULL;
+    char *container_name = NULL;
+    char *saveptr = NULL;
+
+    if (snprintf(path, PATH_MAX, "%s/var/log/containers", resolver->host_root) >= PATH_MAX)
+        return;
+
+    dir = opendir(path);
+    if (!dir)
+        return;
+
+    /* the kubelet creates a <pod>_<namespace>_<container>-<container id>.log symlink for each container */
+    suffix_length = (size_t) snprintf(suffix, sizeof(suffix), "-%s.log", metadata->container_id);
+    while ((entry = readdir(dir))) {
+        name_length = strlen(entry->d_name);
+        if (name_length <= suffix_length || strcmp(entry->d_name + name_length - suffix_length, suffix))
+            continue;
+
+        fields = strndup(entry->d_name, name_length - suffix_length);
+        if (!fields)
+            break;
+
+        pod_name = strtok_r(fields, "_", &saveptr);
+        namespace_name = strtok_r(NULL, "_", &saveptr);
+        container_name = strtok_r(NULL, "", &saveptr);
+        if (pod_name && namespace_name && container_name) {
+            set_metadata_field(&metadata->pod_name, pod_name);
+            set_metadata_field(&metadata->namespace_name, namespace_name);
+            set_metadata_field(&metadata->container_name, container_name);
+        }
+
+        free(fields);
+        break;
+    }
+
+    closedir(dir);
+}
+
+static void
+resolve_from_pods_logs(struct target_resolver *resolver, struct target_metadata *metadata)
+{
+    char path[PATH_MAX] = {};
+    char suffix[POD_UID_MAX_LENGTH + 2] = {};
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+    size_t name_length = 0;
+    size_t suffix_length = 0;
+    char *fields = NULL;
+    char *namespace_name = NULL;
+    char *pod_name = NULL;
+    char *saveptr = NULL;
+
+    if (snprintf(path, PATH_MAX, "%s/var/log/pods", resolver->host_root) >= PATH_MAX)
+        return;
+
+    dir = opendir(path);
+    if (!dir)
+        return;
+
+    /* the kubelet creates a <namespace>_<pod>_<pod uid> directory for each pod */
+    suffix_length = (size_t) snprintf(suffix, sizeof(suffix), "_%s", metadata->pod_uid);
+    while ((entry = readdir(dir))) {
+        name_length = strlen(entry->d_name);
+        if (name_length <= suffix_length || strcmp(entry->d_name + name_length - suffix_length, suffix))
+            continue;
+
+        fields = strndup(entry->d_name, name_length - suffix_length);
+        if (!fields)
+            break;
+
+        namespace_name = strtok_r(fields, "_", &saveptr);
+        pod_name = strtok_r(NULL, "", &saveptr);
+        if (namespace_name && pod_name) {
+            set_metadata_field(&metadata->namespace_name, namespace_name);
+            set_metadata_field(&metadata->pod_name, pod_name);
+        }
+
+        free(fields);
+        break;
+    }
+
+    closedir(dir);
+}
+
+static char *
+build_target_name(const struct target_metadata *metadata)
+{
+    const char *id = (strlen(metadata->container_id)) ? metadata->container_id : metadata->pod_uid;
+    char short_id[TARGET_SHORT_ID_LENGTH + 2] = {};
+    char *name = NULL;
+    int ret = -1;
+
+    /* the names are reused by the restarted containers and shared by the containers of a pod, the short id keeps them unique */
+    if (strlen(id))
+        snprintf(short_id, sizeof(short_id), "@%.*s", TARGET_SHORT_ID_LENGTH, id);
+
+    if (metadata->namespace_name && metadata->pod_name && metadata->container_name)
+        ret = asprintf(&name, "%s/%s/%s%s", metadata->namespace_name, metadata->pod_name, metadata->container_name, short_id);
+    else if (metadata->namespace_name && metadata->pod_name)
+        ret = asprintf(&name, "%s/%s%s", metadata->namespace_name, metadata->pod_name, short_id);
+    else if (metadata->container_name)
+        ret = asprintf(&name, "%s%s", metadata->container_name, short_id);
+
+    return (ret == -1) ? NULL : name;
+}
+
+static void
+resolve_metadata(struct target_resolver *resolver, struct target_metadata *metadata, const char *cgroup_path)
+{
+    target_metadata_parse_cgroup_path(metadata, cgroup_path);
+
+    if (strlen(metadata->container_id)) {
+        resolve_from_oci_annotations(resolver, metadata);
+        resolve_from_docker_config(resolver, metadata);
+        resolve_from_containers_logs(resolver, metadata);
+    }
+
+    if (strlen(metadata->pod_uid) && (!metadata->pod_name || !metadata->namespace_name))
+        resolve_from_pods_logs(resolver, metadata);
+
+    metadata->name = build_target_name(metadata);
+}
+
+const struct target_metadata *
+target_resolver_resolve(struct target_resolver *resolver, const struct target *target)
+{
+    struct stat cgroup_stat = {};
+    char cgroup_id[32] = {};
+    struct target_metadata *metadata = NULL;
+
+    if (!target->cgroup_path)
+        return NULL;
+
+    if (stat(target->cgroup_path, &cgroup_stat))
+        return NULL;
+
+    /* the inode number of a cgroup directory is its cgroup id, it changes when a cgroup path is reused */
+    snprintf(cgroup_id, sizeof(cgroup_id), "%lu", (unsigned long) cgroup_stat.st_ino);
+    metadata = (struct target_metadata *) zhashx_lookup(resolver->cache, cgroup_id);
+    if (metadata)
+        return metadata;
+
+    metadata = target_metadata_create();
+    if (!metadata)
+        return NULL;
+
+    resolve_metadata(resolver, metadata, target->cgroup_path + ((target->cgroup_basedir) ? strlen(target->cgroup_basedir) : 0));
+
+    target_resolver_invalidate(resolver, target->cgroup_path);
+    zhashx_insert(resolver->cache, cgroup_id, metadata);
+    zhashx_insert(resolver->cgroups_id, target->cgroup_path, cgroup_id);
+    return metadata;
+}
+
+void
+target_metadata_apply(const struct target_metadata *metadata, struct target *target)
+{
+    target->name = (metadata->name) ? strdup(metadata->name) : NULL;
+    target->namespace_name = (metadata->namespace_name) ? strdup(metadata->namespace_name) : NULL;
+    target->pod_name = (metadata->pod_name) ? strdup(metadata->pod_name) : NULL;
+    target->container_name = (metadata->container_name) ? strdup(metadata->container_name) : NULL;
+}
+
+void
+target_resolver_invalidate(struct target_resolver *resolver, const char *cgroup_path)
+{
+    const char *cgroup_id = (const char *) zhashx_lookup(resolver->cgroups_id, cgroup_path);
+
+    if (!cgroup_id)
+        return;
+
+    zhashx_delete(resolver->cache, cgroup_id);
+    zhashx_delete(resolver->cgroups_id, cgroup_path);
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TARGET_RESOLVER_H
+#define TARGET_RESOLVER_H
+
+#include <czmq.h>
+#include <limits.h>
+
+#include "target.h"
+
+/*
+ * CONTAINER_ID_LENGTH stores the length of a container id (hex encoded sha256).
+ */
+#define CONTAINER_ID_LENGTH 64
+
+/*
+ * POD_UID_MAX_LENGTH stores the maximum length of a pod uid.
+ */
+#define POD_UID_MAX_LENGTH 64
+
+/*
+ * TARGET_SHORT_ID_LENGTH stores the length of the container id (or pod uid) prefix appended to the resolved names.
+ */
+#define TARGET_SHORT_ID_LENGTH 12
+
+/*
+ * target_metadata stores the container and pod information of a cgroup target.
+ */
+struct target_metadata
+{
+    char container_id[CONTAINER_ID_LENGTH + 1]; /* empty if the cgroup is not a container */
+    char pod_uid[POD_UID_MAX_LENGTH + 1]; /* empty if the cgroup is not related to a pod */
+    char *container_name;
+    char *pod_name;
+    char *namespace_name;
+    char *name; /* resolved name of the target, unique thanks to its short id, NULL if it cannot be resolved */
+};
+
+/*
+ * target_resolver stores the metadata of the resolved cgroups.
+ * The metadata are cached by cgroup id (inode number of the cgroup directory) to be resolved once per container lifetime.
+ */
+struct target_resolver
+{
+    char host_root[PATH_MAX]; /* prefix of the runtimes state directories */
+    zhashx_t *cache; /* char *cgroup_id -> struct target_metadata *metadata */
+    zhashx_t *cgroups_id; /* char *cgroup_path -> char *cgroup_id */
+};
+
+/*
+ * target_resolver_create allocate the resources of a target resolver using the runtimes state from the given host root.
+ */
+struct target_resolver *target_resolver_create(const char *host_root);
+
+/*
+ * target_resolver_destroy free the allocated resources of the target resolver.
+ */
+void target_resolver_destroy(struct target_resolver **resolver_ptr);
+
+/*
+ * target_resolver_resolve returns the (cached) metadata of the given cgroup target, NULL on error.
+ */
+const struct target_metadata *target_resolver_resolve(struct target_resolver *resolver, const struct target *target);
+
+/*
+ * target_resolver_invalidate remove the cached metadata of the given cgroup path.
+ */
+void target_resolver_invalidate(struct target_resolver *resolver, const char *cgroup_path);
+
+/*
+ * target_metadata_apply store a copy of the resolved name and metadata into the given target.
+ */
+void target_metadata_apply(const struct target_metadata *metadata, struct target *target);
+
+/*
+ * target_metadata_parse_cgroup_path extract the container id and pod uid from the cgroup path using the kubepods and runtimes conventions.
+ */
+void target_metadata_parse_cgroup_path(struct target_metadata *metadata, const char *cgroup_path);
+
+#endif /* TARGET_RESOLVER_H */
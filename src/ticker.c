@@ -36,7 +36,7 @@
 
 
 struct ticker_config *
-ticker_config_create(unsigned int perf_sampling_interval_ms)
+ticker_config_create(unsigned int perf_sampling_interval_ms, bool aligned, struct overload_monitor *overload)
 {
     struct ticker_config *config = (struct ticker_config *) malloc(sizeof(struct ticker_config));
 
@@ -44,6 +44,8 @@ ticker_config_create(unsigned int perf_sampling_interval_ms)
         return NULL;
 
     config->perf_sampling_interval_ms = perf_sampling_interval_ms;
+    config->aligned = aligned;
+    config->overload = overload;
 
     return config;
 }
@@ -68,6 +70,8 @@ struct ticker_context
     zsock_t *ticker;
     int timer_fd;
     zpoller_t *poller;
+    uint64_t tick; /* index of the last published tick */
+    uint64_t timestamp; /* timestamp of the last published tick */
 };
 
 static struct ticker_context *
@@ -82,8 +86,10 @@ ticker_context_create(struct ticker_config *config, zsock_t *pipe)
     ctx->terminated = false;
     ctx->pipe = pipe;
     ctx->ticker = zsock_new_pub("inproc://ticker");
-    ctx->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    ctx->timer_fd = timerfd_create((config->aligned) ? CLOCK_REALTIME : CLOCK_MONOTONIC, TFD_CLOEXEC);
     ctx->poller = zpoller_new(ctx->pipe, &ctx->timer_fd, NULL);
+    ctx->tick = 0;
+    ctx->timestamp = 0;
 
     return ctx;
 }
@@ -117,6 +123,48 @@ start_timerfd(const struct ticker_context *ctx)
     return 0;
 }
 
+static int
+start_aligned_timerfd(const struct ticker_context *ctx)
+{
+    const uint64_t interval_ns = (uint64_t) ctx->config->perf_sampling_interval_ms * 1000000ULL;
+    struct timespec now = {};
+    uint64_t next_tick_ns;
+    struct itimerspec spec = {};
+
+    if (clock_gettime(CLOCK_REALTIME, &now) == -1) {
+        zsys_error("ticker: Failed to get the wall clock time: %s", strerror(errno));
+        return -1;
+    }
+
+    /* first expiration on the next multiple of the interval, then periodically */
+    next_tick_ns = ((uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec) / interval_ns * interval_ns + interval_ns;
+    spec.it_value.tv_sec = (time_t) (next_tick_ns / 1000000000ULL);
+    spec.it_value.tv_nsec = (long) (next_tick_ns % 1000000000ULL);
+    spec.it_interval.tv_sec = (time_t) (interval_ns / 1000000000ULL);
+    spec.it_interval.tv_nsec = (long) (interval_ns % 1000000000ULL);
+
+    /* the timer is cancelled when the wall clock is stepped, to be re-aligned */
+    if (timerfd_settime(ctx->timer_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, NULL) == -1) {
+        zsys_error("ticker: Failed to start aligned timerfd: %s", strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
+static uint64_t
+get_nominal_tick_time_ms(const struct ticker_context *ctx)
+{
+    struct timespec now = {};
+    uint64_t now_ms;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    now_ms = (uint64_t) now.tv_sec * 1000ULL + (uint64_t) now.tv_nsec / 1000000ULL;
+
+    /* the timer expired on the last multiple of the interval, the read happens a bit later */
+    return now_ms / ctx->config->perf_sampling_interval_ms * ctx->config->perf_sampling_interval_ms;
+}
+
 static void
 handle_pipe(struct ticker_context *ctx)
 {
@@ -136,8 +184,17 @@ static void
 handle_timerfd(struct ticker_context *ctx)
 {
     uint64_t expirations = 0;
+    uint64_t timestamp;
+    uint64_t tick;
+    unsigned int overload_factor;
 
     if (read(ctx->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        if (ctx->config->aligned && errno == ECANCELED) {
+            zsys_warning("ticker: Wall clock was stepped, re-aligning the ticks");
+            start_aligned_timerfd(ctx);
+            return;
+        }
+
         zsys_error("ticker: Failed to read timerfd: %s", strerror(errno));
         return;
     }
@@ -145,7 +202,29 @@ handle_timerfd(struct ticker_context *ctx)
     if (expirations > 1)
         zsys_warning("ticker: Missed %" PRIu64 " tick periods", expirations - 1);
 
-    zsock_send(ctx->ticker, "s8", "CLOCK_TICK", zclock_time());
+    if (ctx->config->aligned) {
+        /* the index is derived from the wall clock to be the same for all the sensors */
+        timestamp = get_nominal_tick_time_ms(ctx);
+        tick = timestamp / ctx->config->perf_sampling_interval_ms;
+    }
+    else {
+        /* count the missed periods to keep the tick index aligned with the elapsed time */
+        timestamp = zclock_time();
+        tick = ctx->tick + expirations;
+    }
+
+    /* the readers compute the elapsed time from the ticks, they continue from the last ones until a stepped back wall clock catches up */
+    if (tick <= ctx->tick || timestamp <= ctx->timestamp) {
+        tick = ctx->tick + expirations;
+        timestamp = ctx->timestamp + expirations * ctx->config->perf_sampling_interval_ms;
+    }
+
+    ctx->tick = tick;
+    ctx->timestamp = timestamp;
+
+    overload_factor = overload_monitor_evaluate(ctx->config->overload, expirations > 1);
+
+    zsock_send(ctx->ticker, "s884", "CLOCK_TICK", timestamp, ctx->tick, overload_factor);
 }
 
 void ticker_actor(zsock_t *pipe, void *args)
@@ -161,7 +240,7 @@ void ticker_actor(zsock_t *pipe, void *args)
 
     zsock_signal(pipe, 0);
 
-    if (start_timerfd(ctx))
+    if ((ctx->config->aligned) ? start_aligned_timerfd(ctx) : start_timerfd(ctx))
         goto cleanup;
 
     while (!ctx->terminated) {
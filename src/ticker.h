@@ -33,19 +33,28 @@
 
 #include <czmq.h>
 
+#include "overload.h"
+
 
 /*
  * ticker_config stores the configuration of a ticker actor.
+ * The ticker publishes a CLOCK_TICK message containing the timestamp and the index of the tick at each period, the index
+ * allows the subscribers to sample at a multiple of the period while staying aligned with each other.
+ * In aligned mode, the ticks fire at the multiples of the period on the wall clock and are re-aligned after clock steps,
+ * the timestamp of a tick is then its nominal time and its index is the number of periods since the epoch.
+ * The message also contains the multiple of the sampling intervals to apply while the sensor is overloaded.
  */
 struct ticker_config
 {
     unsigned int perf_sampling_interval_ms;
+    bool aligned;
+    struct overload_monitor *overload; /* NULL to disable the overload detection */
 };
 
 /*
  * ticker_config_create allocate the resource of a ticker actor configuration.
  */
-struct ticker_config* ticker_config_create(unsigned int perf_sampling_interval_ms);
+struct ticker_config* ticker_config_create(unsigned int perf_sampling_interval_ms, bool aligned, struct overload_monitor *overload);
 
 /*
  * ticker_config_destroy free the allocated resource of the ticker actor configuration.
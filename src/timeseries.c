@@ -0,0 +1,263 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "timeseries.h"
+
+/*
+ * TIMESERIES_STRING_MAX_LENGTH stores the maximum accepted length of a string read from a file.
+ */
+#define TIMESERIES_STRING_MAX_LENGTH 4096
+
+static inline uint64_t
+zigzag_encode(int64_t value)
+{
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+static inline int64_t
+zigzag_decode(uint64_t value)
+{
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+static int
+ts_buffer_reserve(struct ts_buffer *buffer, size_t size)
+{
+    size_t capacity = (buffer->capacity) ? buffer->capacity : 64;
+    uint8_t *data = NULL;
+
+    if (buffer->size + size <= buffer->capacity)
+        return 0;
+
+    while (capacity < buffer->size + size)
+        capacity *= 2;
+
+    data = (uint8_t *) realloc(buffer->data, capacity);
+    if (!data)
+        return -1;
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+int
+ts_buffer_append(struct ts_buffer *buffer, const void *data, size_t size)
+{
+    if (ts_buffer_reserve(buffer, size))
+        return -1;
+
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+    return 0;
+}
+
+int
+ts_buffer_append_varint(struct ts_buffer *buffer, uint64_t value)
+{
+    if (ts_buffer_reserve(buffer, TIMESERIES_VARINT_MAX_SIZE))
+        return -1;
+
+    while (value >= 0x80) {
+        buffer->data[buffer->size++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    buffer->data[buffer->size++] = (uint8_t) value;
+
+    return 0;
+}
+
+int
+ts_buffer_append_string(struct ts_buffer *buffer, const char *str)
+{
+    const size_t len = strlen(str);
+
+    if (ts_buffer_append_varint(buffer, len))
+        return -1;
+
+    return ts_buffer_append(buffer, str, len);
+}
+
+void
+ts_buffer_clear(struct ts_buffer *buffer)
+{
+    buffer->size = 0;
+}
+
+void
+ts_buffer_release(struct ts_buffer *buffer)
+{
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+int
+ts_column_encoder_append(struct ts_column_encoder *encoder, uint64_t value)
+{
+    const int64_t delta = (int64_t) (value - encoder->prev_value);
+    int ret;
+
+    if (encoder->count == 0)
+        ret = ts_buffer_append_varint(&encoder->buffer, value);
+    else if (encoder->count == 1)
+        ret = ts_buffer_append_varint(&encoder->buffer, zigzag_encode(delta));
+    else
+        ret = ts_buffer_append_varint(&encoder->buffer, zigzag_encode((int64_t) ((uint64_t) delta - (uint64_t) encoder->prev_delta)));
+
+    if (ret)
+        return -1;
+
+    encoder->prev_delta = (encoder->count) ? delta : 0;
+    encoder->prev_value = value;
+    encoder->count++;
+    return 0;
+}
+
+void
+ts_column_encoder_reset(struct ts_column_encoder *encoder)
+{
+    ts_buffer_clear(&encoder->buffer);
+    encoder->count = 0;
+    encoder->prev_value = 0;
+    encoder->prev_delta = 0;
+}
+
+void
+ts_column_encoder_release(struct ts_column_encoder *encoder)
+{
+    ts_buffer_release(&encoder->buffer);
+    ts_column_encoder_reset(encoder);
+}
+
+int
+ts_varint_decode(const uint8_t *data, size_t size, size_t *pos, uint64_t *value)
+{
+    uint64_t result = 0;
+    unsigned int shift = 0;
+    uint8_t byte;
+
+    do {
+        if (*pos >= size || shift >= 64)
+            return -1;
+
+        byte = data[(*pos)++];
+        result |= (uint64_t) (byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    *value = result;
+    return 0;
+}
+
+void
+ts_column_decoder_init(struct ts_column_decoder *decoder, const uint8_t *data, size_t size)
+{
+    decoder->data = data;
+    decoder->size = size;
+    decoder->pos = 0;
+    decoder->count = 0;
+    decoder->prev_value = 0;
+    decoder->prev_delta = 0;
+}
+
+int
+ts_column_decoder_next(struct ts_column_decoder *decoder, uint64_t *value)
+{
+    uint64_t encoded;
+    int64_t delta;
+
+    if (ts_varint_decode(decoder->data, decoder->size, &decoder->pos, &encoded))
+        return -1;
+
+    if (decoder->count == 0) {
+        *value = encoded;
+        delta = 0;
+    }
+    else if (decoder->count == 1) {
+        delta = zigzag_decode(encoded);
+        *value = decoder->prev_value + (uint64_t) delta;
+    }
+    else {
+        delta = (int64_t) ((uint64_t) decoder->prev_delta + (uint64_t) zigzag_decode(encoded));
+        *value = decoder->prev_value + (uint64_t) delta;
+    }
+
+    decoder->prev_delta = delta;
+    decoder->prev_value = *value;
+    decoder->count++;
+    return 0;
+}
+
+int
+ts_file_read_varint(FILE *file, uint64_t *value)
+{
+    uint64_t result = 0;
+    unsigned int shift = 0;
+    int byte;
+
+    do {
+        byte = fgetc(file);
+        if (byte == EOF || shift >= 64)
+            return -1;
+
+        result |= (uint64_t) (byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    *value = result;
+    return 0;
+}
+
+char *
+ts_file_read_string(FILE *file)
+{
+    uint64_t len = 0;
+    char *str = NULL;
+
+    if (ts_file_read_varint(file, &len) || len > TIMESERIES_STRING_MAX_LENGTH)
+        return NULL;
+
+    str = (char *) malloc(len + 1);
+    if (!str)
+        return NULL;
+
+    if (len && fread(str, len, 1, file) != 1) {
+        free(str);
+        return NULL;
+    }
+
+    str[len] = '\0';
+    return str;
+}
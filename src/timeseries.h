@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * The timeseries file format stores the reports of an events group as independent blocks of
+ * compressed series. A series holds the values of a (target, socket, cpu) tuple for every
+ * event of the group. Integers are encoded as LEB128 varints, signed integers are zigzag encoded.
+ *
+ * File header:
+ *   char     magic[8]                "HWPCTS02"
+ *   string   sensor_name
+ *   string   group_name
+ *   varint   num_events
+ *   string   events_name[num_events]
+ *
+ * Block (repeated until the end of file):
+ *   char     magic[4]                "BLCK"
+ *   string   target_name
+ *   varint   socket
+ *   varint   cpu
+ *   varint   num_points
+ *   varint   data_size
+ *   byte     data[data_size]         timestamps, interval_ms, partial and overload_factor columns then one column per event
+ *
+ * A column stores its first value as-is, the second one as a delta and the next ones as delta-of-delta.
+ * Strings are stored as a varint length followed by the (non null-terminated) characters.
+ */
+
+/*
+ * TIMESERIES_FILE_MAGIC stores the magic bytes at the beginning of a timeseries file.
+ */
+#define TIMESERIES_FILE_MAGIC "HWPCTS02"
+
+/*
+ * TIMESERIES_NUM_METADATA_COLUMNS stores the number of columns of a block preceding the events values.
+ */
+#define TIMESERIES_NUM_METADATA_COLUMNS 4
+
+/*
+ * TIMESERIES_BLOCK_MAGIC stores the magic bytes at the beginning of a block.
+ */
+#define TIMESERIES_BLOCK_MAGIC "BLCK"
+
+/*
+ * TIMESERIES_VARINT_MAX_SIZE stores the maximum size of an encoded 64 bits varint.
+ */
+#define TIMESERIES_VARINT_MAX_SIZE 10
+
+/*
+ * ts_buffer is a growable bytes buffer.
+ */
+struct ts_buffer
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+};
+
+/*
+ * ts_column_encoder stores the state of a delta-of-delta encoded column.
+ */
+struct ts_column_encoder
+{
+    struct ts_buffer buffer;
+    size_t count;
+    uint64_t prev_value;
+    int64_t prev_delta;
+};
+
+/*
+ * ts_column_decoder stores the state of the decoding of a delta-of-delta encoded column.
+ */
+struct ts_column_decoder
+{
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+    size_t count;
+    uint64_t prev_value;
+    int64_t prev_delta;
+};
+
+/*
+ * ts_buffer_append_varint append the varint encoding of the given value to the buffer.
+ */
+int ts_buffer_append_varint(struct ts_buffer *buffer, uint64_t value);
+
+/*
+ * ts_buffer_append_string append the length and characters of the given string to the buffer.
+ */
+int ts_buffer_append_string(struct ts_buffer *buffer, const char *str);
+
+/*
+ * ts_buffer_append append the given bytes to the buffer.
+ */
+int ts_buffer_append(struct ts_buffer *buffer, const void *data, size_t size);
+
+/*
+ * ts_buffer_clear reset the buffer content without releasing its memory.
+ */
+void ts_buffer_clear(struct ts_buffer *buffer);
+
+/*
+ * ts_buffer_release free the memory allocated for the buffer.
+ */
+void ts_buffer_release(struct ts_buffer *buffer);
+
+/*
+ * ts_column_encoder_append encode the value and append it to the column.
+ */
+int ts_column_encoder_append(struct ts_column_encoder *encoder, uint64_t value);
+
+/*
+ * ts_column_encoder_reset reset the state of the encoder to start a new column.
+ */
+void ts_column_encoder_reset(struct ts_column_encoder *encoder);
+
+/*
+ * ts_column_encoder_release free the memory allocated for the encoder.
+ */
+void ts_column_encoder_release(struct ts_column_encoder *encoder);
+
+/*
+ * ts_column_decoder_init setup the decoder to read a column from the given bytes.
+ */
+void ts_column_decoder_init(struct ts_column_decoder *decoder, const uint8_t *data, size_t size);
+
+/*
+ * ts_column_decoder_next decode the next value of the column.
+ */
+int ts_column_decoder_next(struct ts_column_decoder *decoder, uint64_t *value);
+
+/*
+ * ts_varint_decode decode a varint from the given bytes and advance the position.
+ */
+int ts_varint_decode(const uint8_t *data, size_t size, size_t *pos, uint64_t *value);
+
+/*
+ * ts_file_read_varint read a varint from the given file.
+ */
+int ts_file_read_varint(FILE *file, uint64_t *value);
+
+/*
+ * ts_file_read_string read a string from the given file. The returned string must be freed by the caller.
+ */
+char *ts_file_read_string(FILE *file);
+
+#endif /* TIMESERIES_H */
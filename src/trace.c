@@ -0,0 +1,775 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "perf.h"
+#include "trace.h"
+#include "util.h"
+
+/*
+ * TRACE_MAX_EVENTS stores the maximum accepted number of events of a group read from a trace.
+ */
+#define TRACE_MAX_EVENTS 1024
+
+static void
+stop_capture(struct trace_writer *writer)
+{
+    zsys_error("trace: failed to write the trace, capture stopped errno=%d", errno);
+    writer->failed = true;
+}
+
+struct trace_writer *
+trace_writer_create(const char *path)
+{
+    struct trace_writer *writer = (struct trace_writer *) malloc(sizeof(struct trace_writer));
+
+    if (!writer)
+        return NULL;
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        zsys_error("trace: failed to create trace file path=%s errno=%d", path, errno);
+        free(writer);
+        return NULL;
+    }
+
+    if (fwrite(TRACE_FILE_MAGIC, strlen(TRACE_FILE_MAGIC), 1, writer->file) != 1) {
+        zsys_error("trace: failed to write header of trace file path=%s", path);
+        fclose(writer->file);
+        free(writer);
+        return NULL;
+    }
+
+    pthread_mutex_init(&writer->lock, NULL);
+    writer->failed = false;
+    writer->buffer = (struct ts_buffer){};
+    writer->strings = zhashx_new();
+    zhashx_set_duplicator(writer->strings, (zhashx_duplicator_fn *) uint64ptrdup);
+    zhashx_set_destructor(writer->strings, (zhashx_destructor_fn *) ptrfree);
+    writer->groups = zhashx_new();
+    zhashx_set_duplicator(writer->groups, (zhashx_duplicator_fn *) uint64ptrdup);
+    zhashx_set_destructor(writer->groups, (zhashx_destructor_fn *) ptrfree);
+
+    return writer;
+}
+
+void
+trace_writer_destroy(struct trace_writer **writer_ptr)
+{
+    struct trace_writer *writer = *writer_ptr;
+
+    if (!writer)
+        return;
+
+    if (fclose(writer->file))
+        zsys_error("trace: failed to flush the trace file errno=%d", errno);
+
+    pthread_mutex_destroy(&writer->lock);
+    ts_buffer_release(&writer->buffer);
+    zhashx_destroy(&writer->strings);
+    zhashx_destroy(&writer->groups);
+    free(writer);
+    *writer_ptr = NULL;
+}
+
+static int
+write_buffer(struct trace_writer *writer)
+{
+    if (writer->buffer.size && fwrite(writer->buffer.data, writer->buffer.size, 1, writer->file) != 1)
+        return -1;
+
+    ts_buffer_clear(&writer->buffer);
+    return 0;
+}
+
+static int
+intern_string(struct trace_writer *writer, const char *str, uint64_t *string_id)
+{
+    const uint64_t *id = (const uint64_t *) zhashx_lookup(writer->strings, str);
+    uint64_t new_id;
+
+    if (id) {
+        *string_id = *id;
+        return 0;
+    }
+
+    new_id = zhashx_size(writer->strings);
+    ts_buffer_clear(&writer->buffer);
+    if (ts_buffer_append_varint(&writer->buffer, TRACE_RECORD_STRING) || ts_buffer_append_varint(&writer->buffer, new_id) || ts_buffer_append_string(&writer->buffer, str))
+        return -1;
+
+    if (write_buffer(writer) || zhashx_insert(writer->strings, str, &new_id))
+        return -1;
+
+    *string_id = new_id;
+    return 0;
+}
+
+static int
+write_group_record(struct trace_writer *writer, struct events_group *group, uint64_t group_id)
+{
+    uint64_t name_id;
+    uint64_t *events_name_id = NULL;
+    size_t num_events = group->num_events;
+    size_t event_i;
+    int ret = -1;
+
+    events_name_id = (uint64_t *) calloc(num_events + 1, sizeof(uint64_t));
+    if (!events_name_id)
+        return -1;
+
+    /* the names must be defined before the group record is encoded */
+    if (intern_string(writer, group->name, &name_id))
+        goto cleanup;
+
+    for (event_i = 0; event_i < num_events; event_i++) {
+        if (intern_string(writer, group->events[event_i].name, &events_name_id[event_i]))
+            goto cleanup;
+    }
+
+    ts_buffer_clear(&writer->buffer);
+    if (ts_buffer_append_varint(&writer->buffer, TRACE_RECORD_GROUP) || ts_buffer_append_varint(&writer->buffer, group_id) ||
+        ts_buffer_append_varint(&writer->buffer, name_id) || ts_buffer_append_varint(&writer->buffer, num_events))
+        goto cleanup;
+
+    for (event_i = 0; event_i < num_events; event_i++) {
+        if (ts_buffer_append_varint(&writer->buffer, events_name_id[event_i]))
+            goto cleanup;
+    }
+
+    ret = write_buffer(writer);
+
+cleanup:
+    free(events_name_id);
+    return ret;
+}
+
+int
+trace_writer_define_group(struct trace_writer *writer, struct events_group *group, uint64_t *group_id)
+{
+    struct ts_buffer signature = {};
+    size_t event_i;
+    const uint64_t *id = NULL;
+    uint64_t new_id;
+    int ret = -1;
+
+    /* the system and containers groups can have the same name with different events */
+    if (ts_buffer_append_string(&signature, group->name))
+        goto cleanup;
+    for (event_i = 0; event_i < group->num_events; event_i++) {
+        if (ts_buffer_append_string(&signature, group->events[event_i].name))
+            goto cleanup;
+    }
+    if (ts_buffer_append(&signature, "", 1))
+        goto cleanup;
+
+    pthread_mutex_lock(&writer->lock);
+
+    /* the samples of the groups are not recorded once the capture is stopped */
+    *group_id = 0;
+    id = (const uint64_t *) zhashx_lookup(writer->groups, signature.data);
+    if (id) {
+        *group_id = *id;
+    }
+    else if (!writer->failed) {
+        new_id = zhashx_size(writer->groups);
+        if (write_group_record(writer, group, new_id) || zhashx_insert(writer->groups, signature.data, &new_id))
+            stop_capture(writer);
+        else
+            *group_id = new_id;
+    }
+    ret = 0;
+
+    pthread_mutex_unlock(&writer->lock);
+
+cleanup:
+    ts_buffer_release(&signature);
+    return ret;
+}
+
+static void
+write_sample_record(struct trace_writer *writer, enum trace_record_type type, const char *target_name, uint64_t group_id, const char *pkg_id, const char *cpu_id, const struct perf_read_format *sample)
+{
+    uint64_t target_id;
+    uint64_t pkg_string_id;
+    uint64_t cpu_string_id;
+    uint64_t value_i;
+    int ret = -1;
+
+    if (!writer)
+        return;
+
+    pthread_mutex_lock(&writer->lock);
+
+    if (writer->failed)
+        goto unlock;
+
+    if (intern_string(writer, target_name, &target_id) || intern_string(writer, pkg_id, &pkg_string_id) || intern_string(writer, cpu_id, &cpu_string_id))
+        goto error;
+
+    ts_buffer_clear(&writer->buffer);
+    if (ts_buffer_append_varint(&writer->buffer, type) || ts_buffer_append_varint(&writer->buffer, target_id) ||
+        ts_buffer_append_varint(&writer->buffer, group_id) || ts_buffer_append_varint(&writer->buffer, pkg_string_id) ||
+        ts_buffer_append_varint(&writer->buffer, cpu_string_id) || ts_buffer_append_varint(&writer->buffer, sample->nr) ||
+        ts_buffer_append_varint(&writer->buffer, sample->time_enabled) || ts_buffer_append_varint(&writer->buffer, sample->time_running))
+        goto error;
+
+    for (value_i = 0; value_i < sample->nr; value_i++) {
+        if (ts_buffer_append_varint(&writer->buffer, sample->values[value_i].value))
+            goto error;
+    }
+
+    ret = write_buffer(writer);
+
+error:
+    if (ret)
+        stop_capture(writer);
+unlock:
+    pthread_mutex_unlock(&writer->lock);
+}
+
+void
+trace_writer_write_sample(struct trace_writer *writer, const char *target_name, uint64_t group_id, const char *pkg_id, const char *cpu_id, const struct perf_read_format *sample)
+{
+    write_sample_record(writer, TRACE_RECORD_SAMPLE, target_name, group_id, pkg_id, cpu_id, sample);
+}
+
+void
+trace_writer_write_baseline(struct trace_writer *writer, const char *target_name, uint64_t group_id, const char *pkg_id, const char *cpu_id, const struct perf_read_format *sample)
+{
+    write_sample_record(writer, TRACE_RECORD_BASELINE, target_name, group_id, pkg_id, cpu_id, sample);
+}
+
+void
+trace_writer_write_payload(struct trace_writer *writer, const struct payload *payload)
+{
+    uint64_t target_id;
+    int ret = -1;
+
+    if (!writer)
+        return;
+
+    pthread_mutex_lock(&writer->lock);
+
+    if (writer->failed)
+        goto unlock;
+
+    if (intern_string(writer, payload->target_name, &target_id))
+        goto error;
+
+    ts_buffer_clear(&writer->buffer);
+    if (ts_buffer_append_varint(&writer->buffer, TRACE_RECORD_PAYLOAD) || ts_buffer_append_varint(&writer->buffer, target_id) ||
+        ts_buffer_append_varint(&writer->buffer, payload->timestamp) || ts_buffer_append_varint(&writer->buffer, payload->read_timestamp) ||
+        ts_buffer_append_varint(&writer->buffer, payload->interval_ms) || ts_buffer_append_varint(&writer->buffer, payload->interval_start_timestamp) ||
+        ts_buffer_append_varint(&writer->buffer, payload->overload_factor) || ts_buffer_append_varint(&writer->buffer, payload->partial) ||
+        ts_buffer_append_varint(&writer->buffer, payload->setup_latency_ms))
+        goto error;
+
+    ret = write_buffer(writer);
+
+error:
+    if (ret)
+        stop_capture(writer);
+unlock:
+    pthread_mutex_unlock(&writer->lock);
+}
+
+void
+trace_writer_write_discard(struct trace_writer *writer, const char *target_name)
+{
+    uint64_t target_id;
+    int ret = -1;
+
+    if (!writer)
+        return;
+
+    pthread_mutex_lock(&writer->lock);
+
+    if (writer->failed)
+        goto unlock;
+
+    if (intern_string(writer, target_name, &target_id))
+        goto error;
+
+    ts_buffer_clear(&writer->buffer);
+    if (ts_buffer_append_varint(&writer->buffer, TRACE_RECORD_DISCARD) || ts_buffer_append_varint(&writer->buffer, target_id))
+        goto error;
+
+    ret = write_buffer(writer);
+
+error:
+    if (ret)
+        stop_capture(writer);
+unlock:
+    pthread_mutex_unlock(&writer->lock);
+}
+
+void
+trace_writer_write_reset(struct trace_writer *writer, const char *target_name, uint64_t group_id, const char *pkg_id, const char *cpu_id)
+{
+    uint64_t target_id;
+    uint64_t pkg_string_id;
+    uint64_t cpu_string_id;
+    int ret = -1;
+
+    if (!writer)
+        return;
+
+    pthread_mutex_lock(&writer->lock);
+
+    if (writer->failed)
+        goto unlock;
+
+    if (intern_string(writer, target_name, &target_id) || intern_string(writer, pkg_id, &pkg_string_id) || intern_string(writer, cpu_id, &cpu_string_id))
+        goto error;
+
+    ts_buffer_clear(&writer->buffer);
+    if (ts_buffer_append_varint(&writer->buffer, TRACE_RECORD_RESET) || ts_buffer_append_varint(&writer->buffer, target_id) ||
+        ts_buffer_append_varint(&writer->buffer, group_id) || ts_buffer_append_varint(&writer->buffer, pkg_string_id) ||
+        ts_buffer_append_varint(&writer->buffer, cpu_string_id))
+        goto error;
+
+    ret = write_buffer(writer);
+
+error:
+    if (ret)
+        stop_capture(writer);
+unlock:
+    pthread_mutex_unlock(&writer->lock);
+}
+
+struct trace_reader *
+trace_reader_create(const char *path)
+{
+    struct trace_reader *reader = (struct trace_reader *) malloc(sizeof(struct trace_reader));
+    char magic[sizeof(TRACE_FILE_MAGIC)] = {};
+
+    if (!reader)
+        return NULL;
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        zsys_error("trace: failed to open trace file path=%s errno=%d", path, errno);
+        free(reader);
+        return NULL;
+    }
+
+    if (fread(magic, strlen(TRACE_FILE_MAGIC), 1, reader->file) != 1 || strcmp(magic, TRACE_FILE_MAGIC)) {
+        zsys_error("trace: invalid header of trace file path=%s", path);
+        fclose(reader->file);
+        free(reader);
+        return NULL;
+    }
+
+    reader->num_strings = 0;
+    reader->strings = NULL;
+    reader->num_groups = 0;
+    reader->groups = NULL;
+    reader->baselines = zhashx_new();
+    zhashx_set_destructor(reader->baselines, (zhashx_destructor_fn *) ptrfree);
+    reader->pending = zhashx_new(); /* the payloads are destroyed explicitly as their ownership is given to the caller */
+
+    return reader;
+}
+
+void
+trace_reader_destroy(struct trace_reader **reader_ptr)
+{
+    struct trace_reader *reader = *reader_ptr;
+
+    if (!reader)
+        return;
+
+    fclose(reader->file);
+    for (size_t string_i = 0; string_i < reader->num_strings; string_i++) {
+        free(reader->strings[string_i]);
+    }
+    free(reader->strings);
+    for (size_t group_i = 0; group_i < reader->num_groups; group_i++) {
+        events_group_destroy(&reader->groups[group_i]);
+    }
+    free(reader->groups);
+    zhashx_destroy(&reader->baselines);
+    for (struct payload *payload = (struct payload *) zhashx_first(reader->pending); payload; payload = (struct payload *) zhashx_next(reader->pending)) {
+        payload_destroy(payload);
+    }
+    zhashx_destroy(&reader->pending);
+    free(reader);
+    *reader_ptr = NULL;
+}
+
+static const char *
+lookup_string(struct trace_reader *reader, uint64_t string_id)
+{
+    return (string_id < reader->num_strings) ? reader->strings[string_id] : NULL;
+}
+
+static int
+read_string_record(struct trace_reader *reader)
+{
+    uint64_t string_id;
+    char *str = NULL;
+    char **strings = NULL;
+
+    /* the identifiers are assigned sequentially by the writer */
+    if (ts_file_read_varint(reader->file, &string_id) || string_id != reader->num_strings)
+        return -1;
+
+    str = ts_file_read_string(reader->file);
+    if (!str)
+        return -1;
+
+    strings = (char **) realloc(reader->strings, (reader->num_strings + 1) * sizeof(char *));
+    if (!strings) {
+        free(str);
+        return -1;
+    }
+
+    strings[reader->num_strings++] = str;
+    reader->strings = strings;
+    return 0;
+}
+
+static int
+read_group_record(struct trace_reader *reader)
+{
+    uint64_t group_id;
+    uint64_t name_id;
+    uint64_t num_events;
+    uint64_t event_name_id;
+    const char *name = NULL;
+    struct events_group *group = NULL;
+    struct events_group **groups = NULL;
+    struct event_config event = {};
+
+    if (ts_file_read_varint(reader->file, &group_id) || group_id != reader->num_groups)
+        return -1;
+
+    if (ts_file_read_varint(reader->file, &name_id) || ts_file_read_varint(reader->file, &num_events) || num_events > TRACE_MAX_EVENTS)
+        return -1;
+
+    name = lookup_string(reader, name_id);
+    if (!name)
+        return -1;
+
+    group = events_group_create(name);
+    if (!group)
+        return -1;
+
+    /* only the names of the events are needed to rebuild the payloads */
+    for (uint64_t event_i = 0; event_i < num_events; event_i++) {
+        if (ts_file_read_varint(reader->file, &event_name_id) || !lookup_string(reader, event_name_id))
+            goto error;
+
+        snprintf(event.name, NAME_MAX, "%s", lookup_string(reader, event_name_id));
+        if (events_group_add_event(group, &event))
+            goto error;
+    }
+
+    groups = (struct events_group **) realloc(reader->groups, (reader->num_groups + 1) * sizeof(struct events_group *));
+    if (!groups)
+        goto error;
+
+    groups[reader->num_groups++] = group;
+    reader->groups = groups;
+    return 0;
+
+error:
+    events_group_destroy(&group);
+    return -1;
+}
+
+static struct payload *
+get_pending_payload(struct trace_reader *reader, const char *target_name)
+{
+    struct payload *payload = (struct payload *) zhashx_lookup(reader->pending, target_name);
+
+    if (payload)
+        return payload;
+
+    payload = payload_create(0, target_name);
+    if (!payload)
+        return NULL;
+
+    if (zhashx_insert(reader->pending, target_name, payload)) {
+        payload_destroy(payload);
+        return NULL;
+    }
+
+    return payload;
+}
+
+static struct payload_cpu_data *
+get_cpu_data(struct payload *payload, const char *group_name, const char *pkg_id, const char *cpu_id)
+{
+    struct payload_group_data *group_data = NULL;
+    struct payload_pkg_data *pkg_data = NULL;
+    struct payload_cpu_data *cpu_data = NULL;
+
+    group_data = (struct payload_group_data *) zhashx_lookup(payload->groups, group_name);
+    if (!group_data) {
+        group_data = payload_group_data_create();
+        if (!group_data || zhashx_insert(payload->groups, group_name, group_data)) {
+            payload_group_data_destroy(&group_data);
+            return NULL;
+        }
+    }
+
+    pkg_data = (struct payload_pkg_data *) zhashx_lookup(group_data->pkgs, pkg_id);
+    if (!pkg_data) {
+        pkg_data = payload_pkg_data_create();
+        if (!pkg_data || zhashx_insert(group_data->pkgs, pkg_id, pkg_data)) {
+            payload_pkg_data_destroy(&pkg_data);
+            return NULL;
+        }
+    }
+
+    /* a cpu read twice for a payload replaces the previous values, as the perf actor would */
+    zhashx_delete(pkg_data->cpus, cpu_id);
+    cpu_data = payload_cpu_data_create();
+    if (!cpu_data || zhashx_insert(pkg_data->cpus, cpu_id, cpu_data)) {
+        payload_cpu_data_destroy(&cpu_data);
+        return NULL;
+    }
+
+    return cpu_data;
+}
+
+static int
+read_sample_record(struct trace_reader *reader, bool baseline_only)
+{
+    uint64_t target_id, group_id, pkg_id, cpu_id;
+    uint64_t nr;
+    size_t sample_size;
+    struct perf_read_format *sample = NULL;
+    struct perf_read_format *previous = NULL;
+    struct perf_read_format *zero_sample = NULL;
+    struct events_group *group = NULL;
+    struct payload *payload = NULL;
+    struct payload_cpu_data *cpu_data = NULL;
+    char sample_key[128] = {};
+    int ret = -1;
+
+    if (ts_file_read_varint(reader->file, &target_id) || ts_file_read_varint(reader->file, &group_id) ||
+        ts_file_read_varint(reader->file, &pkg_id) || ts_file_read_varint(reader->file, &cpu_id) || ts_file_read_varint(reader->file, &nr))
+        return -1;
+
+    if (!lookup_string(reader, target_id) || !lookup_string(reader, pkg_id) || !lookup_string(reader, cpu_id) || group_id >= reader->num_groups)
+        return -1;
+
+    group = reader->groups[group_id];
+    if (nr != group->num_events)
+        return -1;
+
+    sample_size = sizeof(struct perf_read_format) + nr * sizeof(struct perf_counter_value);
+    sample = (struct perf_read_format *) malloc(sample_size);
+    if (!sample)
+        return -1;
+
+    sample->nr = nr;
+    if (ts_file_read_varint(reader->file, &sample->time_enabled) || ts_file_read_varint(reader->file, &sample->time_running))
+        goto cleanup;
+
+    for (uint64_t value_i = 0; value_i < nr; value_i++) {
+        if (ts_file_read_varint(reader->file, &sample->values[value_i].value))
+            goto cleanup;
+    }
+
+    /* the counters of a group start at zero when its events are opened */
+    snprintf(sample_key, sizeof(sample_key), "%" PRIu64 "/%" PRIu64 "/%" PRIu64 "/%" PRIu64, target_id, group_id, pkg_id, cpu_id);
+    if (baseline_only)
+        goto baseline;
+
+    previous = (struct perf_read_format *) zhashx_lookup(reader->baselines, sample_key);
+    if (!previous) {
+        zero_sample = (struct perf_read_format *) calloc(1, sample_size);
+        if (!zero_sample)
+            goto cleanup;
+        previous = zero_sample;
+    }
+
+    payload = get_pending_payload(reader, lookup_string(reader, target_id));
+    if (!payload)
+        goto cleanup;
+
+    cpu_data = get_cpu_data(payload, group->name, lookup_string(reader, pkg_id), lookup_string(reader, cpu_id));
+    if (!cpu_data || payload_cpu_data_insert_delta(cpu_data, group, sample, previous))
+        goto cleanup;
+
+baseline:
+    /* the sample becomes the baseline of the next one */
+    zhashx_update(reader->baselines, sample_key, sample);
+    sample = NULL;
+    ret = 0;
+
+cleanup:
+    free(zero_sample);
+    free(sample);
+    return ret;
+}
+
+static int
+read_payload_record(struct trace_reader *reader, struct payload **payload)
+{
+    uint64_t target_id;
+    uint64_t timestamp, read_timestamp, interval_ms, interval_start_timestamp, overload_factor, partial, setup_latency_ms;
+    const char *target_name = NULL;
+
+    if (ts_file_read_varint(reader->file, &target_id) || ts_file_read_varint(reader->file, &timestamp) ||
+        ts_file_read_varint(reader->file, &read_timestamp) || ts_file_read_varint(reader->file, &interval_ms) ||
+        ts_file_read_varint(reader->file, &interval_start_timestamp) || ts_file_read_varint(reader->file, &overload_factor) ||
+        ts_file_read_varint(reader->file, &partial) || ts_file_read_varint(reader->file, &setup_latency_ms))
+        return -1;
+
+    target_name = lookup_string(reader, target_id);
+    if (!target_name)
+        return -1;
+
+    /* take the ownership of the payload built from the samples of the target */
+    *payload = get_pending_payload(reader, target_name);
+    if (!*payload)
+        return -1;
+    zhashx_delete(reader->pending, target_name);
+
+    (*payload)->timestamp = timestamp;
+    (*payload)->read_timestamp = read_timestamp;
+    (*payload)->interval_ms = interval_ms;
+    (*payload)->interval_start_timestamp = interval_start_timestamp;
+    (*payload)->overload_factor = (unsigned int) overload_factor;
+    (*payload)->partial = partial;
+    (*payload)->setup_latency_ms = setup_latency_ms;
+    return 0;
+}
+
+static int
+read_discard_record(struct trace_reader *reader)
+{
+    uint64_t target_id;
+    const char *target_name = NULL;
+
+    if (ts_file_read_varint(reader->file, &target_id))
+        return -1;
+
+    target_name = lookup_string(reader, target_id);
+    if (!target_name)
+        return -1;
+
+    payload_destroy((struct payload *) zhashx_lookup(reader->pending, target_name));
+    zhashx_delete(reader->pending, target_name);
+    return 0;
+}
+
+static int
+read_reset_record(struct trace_reader *reader)
+{
+    uint64_t target_id, group_id, pkg_id, cpu_id;
+    char sample_key[128] = {};
+
+    if (ts_file_read_varint(reader->file, &target_id) || ts_file_read_varint(reader->file, &group_id) ||
+        ts_file_read_varint(reader->file, &pkg_id) || ts_file_read_varint(reader->file, &cpu_id))
+        return -1;
+
+    if (!lookup_string(reader, target_id) || !lookup_string(reader, pkg_id) || !lookup_string(reader, cpu_id) || group_id >= reader->num_groups)
+        return -1;
+
+    /* the next sample of the reopened events is taken against zero counters */
+    snprintf(sample_key, sizeof(sample_key), "%" PRIu64 "/%" PRIu64 "/%" PRIu64 "/%" PRIu64, target_id, group_id, pkg_id, cpu_id);
+    zhashx_delete(reader->baselines, sample_key);
+    return 0;
+}
+
+int
+trace_reader_next_payload(struct trace_reader *reader, struct payload **payload)
+{
+    uint64_t type;
+    int c;
+    int ret = 0;
+
+    *payload = NULL;
+
+    while (!*payload && !ret) {
+        /* the samples of an interrupted capture that are not followed by their payload record are dropped */
+        c = fgetc(reader->file);
+        if (c == EOF)
+            return 0;
+        ungetc(c, reader->file);
+
+        if (ts_file_read_varint(reader->file, &type))
+            return -1;
+
+        switch (type)
+        {
+            case TRACE_RECORD_STRING:
+            ret = read_string_record(reader);
+            break;
+
+            case TRACE_RECORD_GROUP:
+            ret = read_group_record(reader);
+            break;
+
+            case TRACE_RECORD_SAMPLE:
+            ret = read_sample_record(reader, false);
+            break;
+
+            case TRACE_RECORD_BASELINE:
+            ret = read_sample_record(reader, true);
+            break;
+
+            case TRACE_RECORD_PAYLOAD:
+            ret = read_payload_record(reader, payload);
+            break;
+
+            case TRACE_RECORD_DISCARD:
+            ret = read_discard_record(reader);
+            break;
+
+            case TRACE_RECORD_RESET:
+            ret = read_reset_record(reader);
+            break;
+
+            default:
+            zsys_error("trace: unknown record type=%" PRIu64, type);
+            ret = -1;
+        }
+    }
+
+    if (ret) {
+        zsys_error("trace: invalid or truncated record at offset=%ld", ftell(reader->file));
+        payload_destroy(*payload);
+        *payload = NULL;
+    }
+
+    return ret;
+}
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <czmq.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "events.h"
+#include "payload.h"
+#include "timeseries.h"
+
+/*
+ * The trace file format stores the raw samples read by the perf actors, to replay them offline through the payload
+ * and storage pipeline. Integers are encoded as LEB128 varints and strings as a varint length followed by the
+ * (non null-terminated) characters, like the timeseries file format.
+ *
+ * File header:
+ *   char     magic[8]                "HWPCTR01"
+ *
+ * Record (repeated until the end of file), starting with a varint type:
+ *   STRING   varint id, string value
+ *   GROUP    varint id, varint name_id, varint num_events, varint event_name_id[num_events]
+ *   SAMPLE   varint target_id, varint group_id, varint pkg_id, varint cpu_id, varint nr,
+ *            varint time_enabled, varint time_running, varint values[nr]
+ *   PAYLOAD  varint target_id, varint timestamp, varint read_timestamp, varint interval_ms,
+ *            varint interval_start_timestamp, varint overload_factor, varint partial, varint setup_latency_ms
+ *   DISCARD  varint target_id
+ *   RESET    varint target_id, varint group_id, varint pkg_id, varint cpu_id
+ *   BASELINE same fields as SAMPLE
+ *
+ * The names are interned: a STRING record is written before the first record referencing it, and a GROUP record
+ * before the first sample of the group. The samples of a target are followed by the PAYLOAD record built from them,
+ * or by a DISCARD record when the payload could not be completed. A RESET record marks the events of a group reopened
+ * on a cpu, their counters restart from zero. A BASELINE record is a sample that is not part of a payload, read on a cpu
+ * after a failed read to compute the next deltas from it.
+ */
+
+/*
+ * TRACE_FILE_MAGIC stores the magic bytes at the beginning of a trace file.
+ */
+#define TRACE_FILE_MAGIC "HWPCTR01"
+
+/*
+ * trace_record_type stores the type of the records of a trace file.
+ */
+enum trace_record_type
+{
+    TRACE_RECORD_STRING = 1,
+    TRACE_RECORD_GROUP,
+    TRACE_RECORD_SAMPLE,
+    TRACE_RECORD_PAYLOAD,
+    TRACE_RECORD_DISCARD,
+    TRACE_RECORD_RESET,
+    TRACE_RECORD_BASELINE
+};
+
+struct perf_read_format;
+
+/*
+ * trace_writer stores the state of the capture of a trace, shared by the perf actors.
+ */
+struct trace_writer
+{
+    pthread_mutex_t lock;
+    FILE *file;
+    bool failed; /* the capture is stopped after a write error */
+    struct ts_buffer buffer; /* encoding of the record being written */
+    zhashx_t *strings; /* char *str -> uint64_t *string_id */
+    zhashx_t *groups; /* char *group_signature -> uint64_t *group_id */
+};
+
+/*
+ * trace_reader stores the state of the replay of a trace.
+ */
+struct trace_reader
+{
+    FILE *file;
+    size_t num_strings;
+    char **strings; /* indexed by string id */
+    size_t num_groups;
+    struct events_group **groups; /* indexed by group id */
+    zhashx_t *baselines; /* char *sample_key -> struct perf_read_format *sample */
+    zhashx_t *pending; /* char *target_name -> struct payload *payload */
+};
+
+/*
+ * trace_writer_create creates the trace file at the given path and allocate the resources of the writer.
+ */
+struct trace_writer *trace_writer_create(const char *path);
+
+/*
+ * trace_writer_destroy flushes the trace file and free the allocated resources of the writer.
+ */
+void trace_writer_destroy(struct trace_writer **writer_ptr);
+
+/*
+ * trace_writer_define_group returns the identifier of the given events group in the trace, the groups having the
+ * same name and events share the same identifier.
+ */
+int trace_writer_define_group(struct trace_writer *writer, struct events_group *group, uint64_t *group_id);
+
+/*
+ * trace_writer_write_sample records a raw sample of an events group read on a cpu for the given target.
+ * The capture is stopped on the first write error, the writer can be NULL to disable the capture.
+ */
+void trace_writer_write_sample(struct trace_writer *writer, const char *target_name, uint64_t group_id, const char *pkg_id, const char *cpu_id, const struct perf_read_format *sample);
+
+/*
+ * trace_writer_write_baseline records a raw sample of an events group that is only used as the baseline of the next one.
+ */
+void trace_writer_write_baseline(struct trace_writer *writer, const char *target_name, uint64_t group_id, const char *pkg_id, const char *cpu_id, const struct perf_read_format *sample);
+
+/*
+ * trace_writer_write_payload records the completion of the payload built from the samples previously recorded for its target.
+ */
+void trace_writer_write_payload(struct trace_writer *writer, const struct payload *payload);
+
+/*
+ * trace_writer_write_discard records that the samples previously recorded for the target do not form a payload.
+ */
+void trace_writer_write_discard(struct trace_writer *writer, const char *target_name);
+
+/*
+ * trace_writer_write_reset records that the events of a group were reopened on a cpu for the given target.
+ */
+void trace_writer_write_reset(struct trace_writer *writer, const char *target_name, uint64_t group_id, const char *pkg_id, const char *cpu_id);
+
+/*
+ * trace_reader_create opens the trace file at the given path and allocate the resources of the reader.
+ */
+struct trace_reader *trace_reader_create(const char *path);
+
+/*
+ * trace_reader_destroy closes the trace file and free the allocated resources of the reader.
+ */
+void trace_reader_destroy(struct trace_reader **reader_ptr);
+
+/*
+ * trace_reader_next_payload rebuilds the next payload of the trace from its raw samples, using the delta logic of the
+ * perf actors. The payload is set to NULL at the end of the trace, otherwise it must be destroyed by the caller.
+ */
+int trace_reader_next_payload(struct trace_reader *reader, struct payload **payload);
+
+#endif /* TRACE_H */
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "work_pool.h"
+
+static void *
+work_pool_worker(void *args)
+{
+    struct work_pool *pool = (struct work_pool *) args;
+    struct work_pool_task *task = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->terminated && !pool->head)
+            pthread_cond_wait(&pool->available, &pool->lock);
+
+        if (!pool->head)
+            break;
+
+        task = pool->head;
+        pool->head = task->next;
+        if (!pool->head)
+            pool->tail = NULL;
+
+        pthread_mutex_unlock(&pool->lock);
+        task->fn(task->item);
+        pthread_mutex_lock(&pool->lock);
+
+        if (--task->batch->remaining == 0)
+            pthread_cond_signal(&task->batch->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+struct work_pool *
+work_pool_create(size_t num_workers)
+{
+    struct work_pool *pool = NULL;
+
+    if (num_workers == 0)
+        return NULL;
+
+    pool = (struct work_pool *) calloc(1, sizeof(struct work_pool));
+    if (!pool)
+        return NULL;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->available, NULL);
+    pool->terminated = false;
+    pool->head = NULL;
+    pool->tail = NULL;
+
+    pool->workers = (pthread_t *) calloc(num_workers, sizeof(pthread_t));
+    if (!pool->workers)
+        goto error;
+
+    for (pool->num_workers = 0; pool->num_workers < num_workers; pool->num_workers++) {
+        if (pthread_create(&pool->workers[pool->num_workers], NULL, work_pool_worker, pool)) {
+            zsys_error("work_pool: failed to start worker %zu", pool->num_workers);
+            goto error;
+        }
+    }
+
+    return pool;
+
+error:
+    work_pool_destroy(&pool);
+    return NULL;
+}
+
+void
+work_pool_destroy(struct work_pool **pool_ptr)
+{
+    struct work_pool *pool = *pool_ptr;
+    size_t i;
+
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->terminated = true;
+    pthread_cond_broadcast(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 0; i < pool->num_workers; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->available);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+    *pool_ptr = NULL;
+}
+
+int
+work_pool_run(struct work_pool *pool, work_pool_fn *fn, void *items, size_t item_size, size_t num_items)
+{
+    struct work_pool_task *tasks = NULL;
+    struct work_pool_batch batch = {};
+    size_t i;
+
+    if (num_items == 0)
+        return 0;
+
+    /* run the items in the calling thread when there is no pool or nothing to parallelize */
+    if (!pool || num_items == 1) {
+        for (i = 0; i < num_items; i++) {
+            fn((char *) items + i * item_size);
+        }
+        return 0;
+    }
+
+    tasks = (struct work_pool_task *) calloc(num_items, sizeof(struct work_pool_task));
+    if (!tasks)
+        return -1;
+
+    batch.remaining = num_items;
+    pthread_cond_init(&batch.done, NULL);
+
+    for (i = 0; i < num_items; i++) {
+        tasks[i].fn = fn;
+        tasks[i].item = (char *) items + i * item_size;
+        tasks[i].batch = &batch;
+        tasks[i].next = (i + 1 < num_items) ? &tasks[i + 1] : NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail)
+        pool->tail->next = &tasks[0];
+    else
+        pool->head = &tasks[0];
+    pool->tail = &tasks[num_items - 1];
+    pthread_cond_broadcast(&pool->available);
+
+    while (batch.remaining > 0)
+        pthread_cond_wait(&batch.done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_cond_destroy(&batch.done);
+    free(tasks);
+    return 0;
+}
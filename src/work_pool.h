@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * work_pool_fn is the function applied by the workers to an item of a batch.
+ */
+typedef void (work_pool_fn)(void *item);
+
+/*
+ * work_pool_batch stores the completion state of a batch of items submitted to the pool.
+ */
+struct work_pool_batch
+{
+    size_t remaining;
+    pthread_cond_t done;
+};
+
+/*
+ * work_pool_task stores an item of a batch waiting to be processed by a worker.
+ */
+struct work_pool_task
+{
+    work_pool_fn *fn;
+    void *item;
+    struct work_pool_batch *batch;
+    struct work_pool_task *next;
+};
+
+/*
+ * work_pool stores a set of worker threads shared by the actors to run their blocking operations concurrently.
+ */
+struct work_pool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t available;
+    bool terminated;
+    struct work_pool_task *head;
+    struct work_pool_task *tail;
+    size_t num_workers;
+    pthread_t *workers;
+};
+
+/*
+ * work_pool_create allocate the resources and start the workers of a pool.
+ */
+struct work_pool *work_pool_create(size_t num_workers);
+
+/*
+ * work_pool_destroy stop the workers and free the allocated resources of the pool.
+ */
+void work_pool_destroy(struct work_pool **pool_ptr);
+
+/*
+ * work_pool_run apply the function to each item of the given array and wait for the completion of all of them.
+ * The items are processed by the calling thread when the pool is NULL.
+ */
+int work_pool_run(struct work_pool *pool, work_pool_fn *fn, void *items, size_t item_size, size_t num_items);
+
+#endif /* WORK_POOL_H */
@@ -0,0 +1,539 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "config_cli.h"
+#include "events.h"
+#include "hwinfo.h"
+#include "perf.h"
+#include "perf_backend_synthetic.h"
+#include "report.h"
+#include "rlimits.h"
+#include "storage.h"
+#include "target.h"
+#include "util.h"
+#include "work_pool.h"
+
+/*
+ * hwpc-bench drives the monitoring pipeline of the sensor (perf actors, reporting actor and storage module) with
+ * synthetic counters for fake cpus and cgroups, and measures the throughput, latency and allocations per tick.
+ * The options placed after "--" are parsed as the sensor options, to select and configure the storage module.
+ */
+
+/*
+ * BENCH_CGROUP_BASEDIR is the (fake) base directory of the synthetic cgroups.
+ */
+#define BENCH_CGROUP_BASEDIR "/sys/fs/cgroup/"
+
+/*
+ * BENCH_WARMUP_TIMEOUT_MS is the maximum time waited for the perf actors to open their events and process a tick.
+ */
+#define BENCH_WARMUP_TIMEOUT_MS 600000
+
+/*
+ * bench_config stores the scale of the benchmark.
+ */
+struct bench_config
+{
+    unsigned int num_cpus;
+    unsigned int num_pkgs;
+    unsigned int num_cgroups;
+    unsigned int num_groups;
+    unsigned int num_events;
+    unsigned int num_ticks;
+};
+
+/*
+ * bench_progress stores the number of reports stored for the tick being measured.
+ */
+struct bench_progress
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint64_t timestamp; /* timestamp of the awaited reports */
+    unsigned int num_stored;
+};
+
+static struct bench_progress progress = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0 };
+static int (*storage_store_report)(struct storage_module *module, struct payload *payload) = NULL;
+
+#if defined(__cplusplus) && defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+/*
+ * The allocations are counted by interposing the allocator of the C library, this is disabled for sanitized builds.
+ */
+#define BENCH_COUNT_ALLOCATIONS
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t nmemb, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+static uint64_t num_allocations = 0;
+static uint64_t allocated_bytes = 0;
+
+static void
+count_allocation(size_t size)
+{
+    __atomic_add_fetch(&num_allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocated_bytes, size, __ATOMIC_RELAXED);
+}
+
+void *
+malloc(size_t size) noexcept
+{
+    count_allocation(size);
+    return __libc_malloc(size);
+}
+
+void *
+calloc(size_t nmemb, size_t size) noexcept
+{
+    count_allocation(nmemb * size);
+    return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(void *ptr, size_t size) noexcept
+{
+    count_allocation(size);
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+static void
+get_allocations(uint64_t *count, uint64_t *bytes)
+{
+#ifdef BENCH_COUNT_ALLOCATIONS
+    *count = __atomic_load_n(&num_allocations, __ATOMIC_RELAXED);
+    *bytes = __atomic_load_n(&allocated_bytes, __ATOMIC_RELAXED);
+#else
+    *count = 0;
+    *bytes = 0;
+#endif
+}
+
+static int
+counting_store_report(struct storage_module *module, struct payload *payload)
+{
+    int ret = (*storage_store_report)(module, payload);
+
+    pthread_mutex_lock(&progress.lock);
+    if (payload->timestamp == progress.timestamp) {
+        progress.num_stored++;
+        pthread_cond_signal(&progress.cond);
+    }
+    pthread_mutex_unlock(&progress.lock);
+
+    return ret;
+}
+
+static void
+progress_expect(uint64_t timestamp)
+{
+    pthread_mutex_lock(&progress.lock);
+    progress.timestamp = timestamp;
+    progress.num_stored = 0;
+    pthread_mutex_unlock(&progress.lock);
+}
+
+static int
+progress_wait(unsigned int num_reports, int64_t timeout_ms)
+{
+    struct timespec deadline;
+    int ret = 0;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&progress.lock);
+    while (progress.num_stored < num_reports && ret == 0) {
+        ret = pthread_cond_timedwait(&progress.cond, &progress.lock, &deadline);
+    }
+    ret = (progress.num_stored < num_reports) ? -1 : 0;
+    pthread_mutex_unlock(&progress.lock);
+
+    return ret;
+}
+
+static int
+parse_bench_option(const char *name, const char *value_str, unsigned int *value)
+{
+    if (str_to_uint(value_str, value) || *value == 0) {
+        fprintf(stderr, "bench: %s value is invalid (positive integer expected)\n", name);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_bench_config(int argc, char **argv, struct bench_config *bench, int *sensor_argi)
+{
+    static struct option long_opts[] = {
+        {"cpus", required_argument, 0, 'c'},
+        {"packages", required_argument, 0, 'p'},
+        {"cgroups", required_argument, 0, 'g'},
+        {"groups", required_argument, 0, 'G'},
+        {"events", required_argument, 0, 'e'},
+        {"ticks", required_argument, 0, 't'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "c:p:g:G:e:t:", long_opts, NULL)) != -1) {
+        switch (opt)
+        {
+            case 'c':
+            if (parse_bench_option("cpus", optarg, &bench->num_cpus))
+                return -1;
+            break;
+
+            case 'p':
+            if (parse_bench_option("packages", optarg, &bench->num_pkgs))
+                return -1;
+            break;
+
+            case 'g':
+            if (parse_bench_option("cgroups", optarg, &bench->num_cgroups))
+                return -1;
+            break;
+
+            case 'G':
+            if (parse_bench_option("groups", optarg, &bench->num_groups))
+                return -1;
+            break;
+
+            case 'e':
+            if (parse_bench_option("events", optarg, &bench->num_events))
+                return -1;
+            break;
+
+            case 't':
+            if (parse_bench_option("ticks", optarg, &bench->num_ticks))
+                return -1;
+            break;
+
+            default:
+            fprintf(stderr, "usage: %s [--cpus N] [--packages N] [--cgroups N] [--groups N] [--events N] [--ticks N] [-- SENSOR-OPTIONS...]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    if (bench->num_pkgs > bench->num_cpus) {
+        fprintf(stderr, "bench: there cannot be more packages than cpus\n");
+        return -1;
+    }
+
+    *sensor_argi = optind;
+    return 0;
+}
+
+static int
+setup_synthetic_hwinfo(struct hwinfo *hwinfo, const struct bench_config *bench)
+{
+    /* the cpus are evenly spread over the packages */
+    for (unsigned int cpu = 0; cpu < bench->num_cpus; cpu++) {
+        if (hwinfo_add_cpu(hwinfo, (int) (cpu * bench->num_pkgs / bench->num_cpus), (int) cpu))
+            return -1;
+    }
+
+    return 0;
+}
+
+static int
+setup_synthetic_events_groups(zhashx_t *events_groups, const struct bench_config *bench)
+{
+    char group_name[NAME_MAX] = {};
+    struct events_group *group = NULL;
+    struct event_config event = {};
+
+    for (unsigned int group_i = 0; group_i < bench->num_groups; group_i++) {
+        snprintf(group_name, sizeof(group_name), "group%u", group_i);
+        group = events_group_create(group_name);
+        if (!group)
+            return -1;
+
+        /* the events are not encoded by libpfm, the synthetic backend only uses their config */
+        for (unsigned int event_i = 0; event_i < bench->num_events; event_i++) {
+            snprintf(event.name, NAME_MAX, "event%u", event_i);
+            event.attr = (struct perf_event_attr){};
+            event.attr.type = PERF_TYPE_RAW;
+            event.attr.size = sizeof(struct perf_event_attr);
+            event.attr.config = event_i;
+            event.attr.disabled = 1;
+            event.attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING | PERF_FORMAT_GROUP;
+            if (events_group_add_event(group, &event)) {
+                events_group_destroy(&group);
+                return -1;
+            }
+        }
+
+        zhashx_insert(events_groups, group_name, group);
+        events_group_destroy(&group); /* The events group are referenced on insert */
+    }
+
+    return 0;
+}
+
+static int
+uint64_compare(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *) a;
+    const uint64_t y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+static int
+run_ticks(zsock_t *ticker, const struct bench_config *bench, uint64_t *latencies_us, int64_t *duration_us)
+{
+    uint64_t base_timestamp = (uint64_t) zclock_time();
+    uint64_t tick;
+    int64_t start_us;
+    int64_t tick_start_us;
+
+    /* wait until every perf actor opened its events and processed a tick, the ticks sent before are lost or ignored */
+    for (tick = 1; ; tick++) {
+        progress_expect(base_timestamp + tick);
+        zsock_send(ticker, "s884", "CLOCK_TICK", base_timestamp + tick, tick, 1);
+        if (!progress_wait(bench->num_cgroups, 100))
+            break;
+
+        if ((int64_t) (tick * 100) > BENCH_WARMUP_TIMEOUT_MS) {
+            fprintf(stderr, "bench: timeout while waiting for the perf actors to start\n");
+            return -1;
+        }
+    }
+
+    /* the ticks are sent one at a time, once the reports of the previous one are stored */
+    start_us = zclock_usecs();
+    for (unsigned int tick_i = 0; tick_i < bench->num_ticks; tick_i++) {
+        tick++;
+        progress_expect(base_timestamp + tick);
+        tick_start_us = zclock_usecs();
+        zsock_send(ticker, "s884", "CLOCK_TICK", base_timestamp + tick, tick, 1);
+        if (progress_wait(bench->num_cgroups, BENCH_WARMUP_TIMEOUT_MS)) {
+            fprintf(stderr, "bench: timeout while waiting for the reports of tick %" PRIu64 "\n", tick);
+            return -1;
+        }
+        latencies_us[tick_i] = (uint64_t) (zclock_usecs() - tick_start_us);
+    }
+    *duration_us = zclock_usecs() - start_us;
+
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    int ret = EXIT_FAILURE;
+    struct bench_config bench = { .num_cpus = 8, .num_pkgs = 1, .num_cgroups = 10, .num_groups = 1, .num_events = 4, .num_ticks = 100 };
+    struct config *config = NULL;
+    struct hwinfo *hwinfo = NULL;
+    struct storage_module *storage = NULL;
+    struct report_config reporting_conf = {};
+    zactor_t *reporting = NULL;
+    zsock_t *ticker = NULL;
+    struct perf_backend *backend = NULL;
+    struct work_pool *setup_pool = NULL;
+    struct perf_sampling_config sampling_conf = {};
+    zactor_t **perf_monitors = NULL;
+    char cgroup_path[PATH_MAX] = {};
+    struct target *target = NULL;
+    struct perf_config *monitor_config = NULL;
+    uint64_t *latencies_us = NULL;
+    int64_t setup_start_ms;
+    int64_t setup_duration_ms;
+    int64_t duration_us = 0;
+    uint64_t allocations_start = 0;
+    uint64_t allocated_bytes_start = 0;
+    uint64_t allocations_end = 0;
+    uint64_t allocated_bytes_end = 0;
+    int sensor_argi = 0;
+
+    if (setup_bench_config(argc, argv, &bench, &sensor_argi))
+        return ret;
+
+    if (!zsys_init()) {
+        fprintf(stderr, "czmq: failed to initialize zsys context\n");
+        return ret;
+    }
+
+    /* disable limit of maximum czmq sockets */
+    zsys_set_max_sockets(0);
+
+    if (rlimits_initialize())
+        goto cleanup;
+
+    /* the remaining arguments configure the sensor */
+    config = config_create();
+    if (!config) {
+        zsys_error("bench: failed to create config container");
+        goto cleanup;
+    }
+    optind = 0;
+    if (config_setup_from_cli(argc - sensor_argi + 1, argv + sensor_argi - 1, config)) {
+        zsys_error("bench: failed to parse the sensor options");
+        goto cleanup;
+    }
+    if (config->storage.type == STORAGE_UNKNOWN)
+        config->storage.type = STORAGE_NULL;
+
+    /* fake the machine topology and the events groups */
+    hwinfo = hwinfo_create();
+    if (!hwinfo || setup_synthetic_hwinfo(hwinfo, &bench)) {
+        zsys_error("bench: failed to setup the synthetic hardware information");
+        goto cleanup;
+    }
+    zhashx_purge(config->events.containers);
+    if (setup_synthetic_events_groups(config->events.containers, &bench)) {
+        zsys_error("bench: failed to setup the synthetic events groups");
+        goto cleanup;
+    }
+
+    /* setup storage module, and count the reports it stores */
+    storage = storage_module_create(config, &config->storage);
+    if (!storage) {
+        zsys_error("bench: failed to create '%s' storage module", storage_types_name[config->storage.type]);
+        goto cleanup;
+    }
+    if (storage_module_initialize(storage)) {
+        zsys_error("bench: failed to initialize storage module");
+        goto cleanup;
+    }
+    if (storage_module_ping(storage)) {
+        zsys_error("bench: failed to ping storage module");
+        goto cleanup;
+    }
+    storage_store_report = storage->store_report;
+    storage->store_report = counting_store_report;
+
+    reporting_conf = (struct report_config){ .storage = storage, .unattributed = false, .overload = NULL };
+    reporting = zactor_new(reporting_actor, &reporting_conf);
+
+    /* the ticks are sent by the benchmark instead of the ticker actor */
+    ticker = zsock_new_pub("inproc://ticker");
+    if (!ticker) {
+        zsys_error("bench: failed to create the ticker socket");
+        goto cleanup;
+    }
+
+    backend = perf_backend_synthetic_create();
+    if (!backend) {
+        zsys_error("bench: failed to create the synthetic perf backend");
+        goto cleanup;
+    }
+
+    if (config->sensor.perf_setup_workers > 1) {
+        setup_pool = work_pool_create(config->sensor.perf_setup_workers);
+        if (!setup_pool) {
+            zsys_error("bench: failed to start the perf setup workers");
+            goto cleanup;
+        }
+    }
+
+    /* every group is read on every tick */
+    sampling_conf = (struct perf_sampling_config){
+        .tick_ms = config->sensor.perf_sampling_interval_ms,
+        .interval_ms = config->sensor.perf_sampling_interval_ms,
+        .activity_threshold = 0,
+        .max_stride = 1,
+        .overload = NULL,
+        .trace = NULL
+    };
+
+    perf_monitors = (zactor_t **) calloc(bench.num_cgroups, sizeof(zactor_t *));
+    latencies_us = (uint64_t *) calloc(bench.num_ticks, sizeof(uint64_t));
+    if (!perf_monitors || !latencies_us) {
+        zsys_error("bench: failed to allocate the benchmark state");
+        goto cleanup;
+    }
+
+    setup_start_ms = zclock_mono();
+    for (unsigned int cgroup_i = 0; cgroup_i < bench.num_cgroups; cgroup_i++) {
+        snprintf(cgroup_path, PATH_MAX, "%sbench/cgroup%u", BENCH_CGROUP_BASEDIR, cgroup_i);
+        target = target_create(TARGET_TYPE_CGROUP, BENCH_CGROUP_BASEDIR, cgroup_path);
+        if (!target) {
+            zsys_error("bench: failed to create the target of cgroup=%s", cgroup_path);
+            goto cleanup;
+        }
+        monitor_config = perf_config_create(hwinfo, config->events.containers, target, backend, setup_pool, &sampling_conf);
+        if (!monitor_config) {
+            zsys_error("bench: failed to create the perf config of cgroup=%s", cgroup_path);
+            target_destroy(target);
+            goto cleanup;
+        }
+        perf_monitors[cgroup_i] = zactor_new(perf_monitoring_actor, monitor_config);
+    }
+
+    get_allocations(&allocations_start, &allocated_bytes_start);
+    if (run_ticks(ticker, &bench, latencies_us, &duration_us))
+        goto cleanup;
+    get_allocations(&allocations_end, &allocated_bytes_end);
+    setup_duration_ms = zclock_mono() - setup_start_ms - duration_us / 1000;
+
+    qsort(latencies_us, bench.num_ticks, sizeof(uint64_t), uint64_compare);
+    printf("storage=%s cpus=%u packages=%u cgroups=%u groups=%u events=%u ticks=%u setup_ms=%" PRId64 " ticks_per_s=%.2f "
+           "latency_p50_us=%" PRIu64 " latency_p99_us=%" PRIu64 " latency_max_us=%" PRIu64 " allocations_per_tick=%" PRIu64 " allocated_bytes_per_tick=%" PRIu64 "\n",
+           storage_types_name[config->storage.type], bench.num_cpus, bench.num_pkgs, bench.num_cgroups, bench.num_groups, bench.num_events, bench.num_ticks,
+           setup_duration_ms, (duration_us) ? (double) bench.num_ticks * 1000000.0 / (double) duration_us : 0.0,
+           latencies_us[bench.num_ticks / 2], latencies_us[(bench.num_ticks * 99) / 100], latencies_us[bench.num_ticks - 1],
+           (allocations_end - allocations_start) / bench.num_ticks, (allocated_bytes_end - allocated_bytes_start) / bench.num_ticks);
+
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    for (unsigned int cgroup_i = 0; perf_monitors && cgroup_i < bench.num_cgroups; cgroup_i++) {
+        zactor_destroy(&perf_monitors[cgroup_i]);
+    }
+    free(perf_monitors);
+    free(latencies_us);
+    work_pool_destroy(&setup_pool);
+    perf_backend_destroy(backend);
+    zsock_destroy(&ticker);
+    zactor_destroy(&reporting);
+    storage_module_destroy(storage);
+    config_destroy(config);
+    hwinfo_destroy(hwinfo);
+    zsys_shutdown();
+    return ret;
+}
@@ -0,0 +1,452 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <ftw.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <json.h>
+
+#include "config.h"
+#include "events.h"
+#include "hwinfo.h"
+#include "payload.h"
+#include "perf.h"
+#include "perf_backend_synthetic.h"
+#include "storage.h"
+#include "storage_socket.h"
+#include "target.h"
+#include "util.h"
+
+#ifdef HAVE_MONGODB
+#include "storage_mongodb.h"
+#endif
+
+/*
+ * hwpc-microbench measures the cost per report of the hot paths of the sensor, for every combination of the given
+ * numbers of groups, cpus and events: reading the counters into a payload (perf_populate_payload), storing it with the
+ * CSV storage module, and building the documents of the socket (JSON) and mongodb (BSON) storage modules.
+ * The counters are provided by the synthetic perf backend, so no PMU access is needed.
+ */
+
+/*
+ * MICROBENCH_MAX_VALUES is the maximum number of values of a parameter.
+ */
+#define MICROBENCH_MAX_VALUES 16
+
+/*
+ * microbench_parameter stores the values taken by a parameter of the benchmarks.
+ */
+struct microbench_parameter
+{
+    unsigned int values[MICROBENCH_MAX_VALUES];
+    size_t num_values;
+};
+
+/*
+ * microbench_config stores the configuration of the benchmarks.
+ */
+struct microbench_config
+{
+    struct microbench_parameter groups;
+    struct microbench_parameter cpus;
+    struct microbench_parameter events;
+    unsigned int num_pkgs;
+    unsigned int iterations;
+};
+
+/*
+ * microbench_context stores the state shared by the benchmarks of a combination of the parameters.
+ */
+struct microbench_context
+{
+    struct config *config;
+    struct hwinfo *hwinfo;
+    struct perf_backend *backend;
+    struct perf_config *perf_config;
+    struct perf_context *perf_ctx;
+    struct payload *payload; /* sample payload used by the serialization benchmarks */
+    char outdir[PATH_MAX];
+};
+
+static uint64_t
+get_monotonic_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static int
+parse_parameter(const char *name, const char *values_str, struct microbench_parameter *param)
+{
+    char buffer[256] = {};
+    char *saveptr = NULL;
+    char *token = NULL;
+
+    snprintf(buffer, sizeof(buffer), "%s", values_str);
+    param->num_values = 0;
+
+    for (token = strtok_r(buffer, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        if (param->num_values == MICROBENCH_MAX_VALUES || str_to_uint(token, &param->values[param->num_values]) || param->values[param->num_values] == 0) {
+            fprintf(stderr, "microbench: %s values are invalid (up to %d comma separated positive integers expected)\n", name, MICROBENCH_MAX_VALUES);
+            return -1;
+        }
+        param->num_values++;
+    }
+
+    return (param->num_values) ? 0 : -1;
+}
+
+static int
+setup_microbench_config(int argc, char **argv, struct microbench_config *microbench)
+{
+    static struct option long_opts[] = {
+        {"groups", required_argument, 0, 'G'},
+        {"cpus", required_argument, 0, 'c'},
+        {"events", required_argument, 0, 'e'},
+        {"packages", required_argument, 0, 'p'},
+        {"iterations", required_argument, 0, 'i'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "G:c:e:p:i:", long_opts, NULL)) != -1) {
+        switch (opt)
+        {
+            case 'G':
+            if (parse_parameter("groups", optarg, &microbench->groups))
+                return -1;
+            break;
+
+            case 'c':
+            if (parse_parameter("cpus", optarg, &microbench->cpus))
+                return -1;
+            break;
+
+            case 'e':
+            if (parse_parameter("events", optarg, &microbench->events))
+                return -1;
+            break;
+
+            case 'p':
+            if (str_to_uint(optarg, &microbench->num_pkgs) || microbench->num_pkgs == 0) {
+                fprintf(stderr, "microbench: packages value is invalid (positive integer expected)\n");
+                return -1;
+            }
+            break;
+
+            case 'i':
+            if (str_to_uint(optarg, &microbench->iterations) || microbench->iterations == 0) {
+                fprintf(stderr, "microbench: iterations value is invalid (positive integer expected)\n");
+                return -1;
+            }
+            break;
+
+            default:
+            fprintf(stderr, "usage: %s [--groups N,...] [--cpus N,...] [--events N,...] [--packages N] [--iterations N]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+remove_path(const char *path, const struct stat *sb __attribute__ ((unused)), int typeflag __attribute__ ((unused)), struct FTW *ftwbuf __attribute__ ((unused)))
+{
+    return remove(path);
+}
+
+static void
+microbench_context_destroy(struct microbench_context *ctx)
+{
+    payload_destroy(ctx->payload);
+    perf_context_destroy(ctx->perf_ctx);
+    perf_config_destroy(ctx->perf_config);
+    perf_backend_destroy(ctx->backend);
+    hwinfo_destroy(ctx->hwinfo);
+    config_destroy(ctx->config);
+    if (strlen(ctx->outdir))
+        nftw(ctx->outdir, remove_path, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+static int
+setup_synthetic_events_groups(zhashx_t *events_groups, unsigned int num_groups, unsigned int num_events)
+{
+    char group_name[NAME_MAX] = {};
+    struct events_group *group = NULL;
+    struct event_config event = {};
+
+    for (unsigned int group_i = 0; group_i < num_groups; group_i++) {
+        snprintf(group_name, sizeof(group_name), "group%u", group_i);
+        group = events_group_create(group_name);
+        if (!group)
+            return -1;
+
+        /* the events are not encoded by libpfm, the synthetic backend only uses their config */
+        for (unsigned int event_i = 0; event_i < num_events; event_i++) {
+            snprintf(event.name, NAME_MAX, "event%u", event_i);
+            event.attr = (struct perf_event_attr){};
+            event.attr.type = PERF_TYPE_RAW;
+            event.attr.size = sizeof(struct perf_event_attr);
+            event.attr.config = event_i;
+            event.attr.disabled = 1;
+            event.attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING | PERF_FORMAT_GROUP;
+            if (events_group_add_event(group, &event)) {
+                events_group_destroy(&group);
+                return -1;
+            }
+        }
+
+        zhashx_insert(events_groups, group_name, group);
+        events_group_destroy(&group); /* The events group are referenced on insert */
+    }
+
+    return 0;
+}
+
+static int
+microbench_context_setup(struct microbench_context *ctx, const struct microbench_config *microbench, unsigned int num_groups, unsigned int num_cpus, unsigned int num_events)
+{
+    const struct perf_sampling_config sampling = { .tick_ms = 1000, .interval_ms = 1000, .activity_threshold = 0, .max_stride = 1, .overload = NULL, .trace = NULL };
+    unsigned int num_pkgs = (microbench->num_pkgs < num_cpus) ? microbench->num_pkgs : num_cpus;
+    struct target *target = NULL;
+    uint64_t activity = 0;
+
+    ctx->config = config_create();
+    ctx->hwinfo = hwinfo_create();
+    ctx->backend = perf_backend_synthetic_create();
+    if (!ctx->config || !ctx->hwinfo || !ctx->backend)
+        return -1;
+
+    /* the cpus are evenly spread over the packages */
+    for (unsigned int cpu = 0; cpu < num_cpus; cpu++) {
+        if (hwinfo_add_cpu(ctx->hwinfo, (int) (cpu * num_pkgs / num_cpus), (int) cpu))
+            return -1;
+    }
+
+    if (setup_synthetic_events_groups(ctx->config->events.system, num_groups, num_events))
+        return -1;
+
+    target = target_create(TARGET_TYPE_GLOBAL, NULL, NULL);
+    if (!target)
+        return -1;
+
+    ctx->perf_config = perf_config_create(ctx->hwinfo, ctx->config->events.system, target, ctx->backend, NULL, &sampling);
+    if (!ctx->perf_config) {
+        target_destroy(target);
+        return -1;
+    }
+
+    ctx->perf_ctx = perf_context_open(ctx->perf_config, NULL, "all");
+    if (!ctx->perf_ctx)
+        return -1;
+
+    ctx->payload = payload_create((uint64_t) zclock_time(), "all");
+    if (!ctx->payload || perf_populate_payload(ctx->perf_ctx, ctx->payload, ctx->perf_ctx->rates[0].stride, &activity))
+        return -1;
+
+    snprintf(ctx->outdir, PATH_MAX, "/tmp/hwpc-microbench-XXXXXX");
+    if (!mkdtemp(ctx->outdir)) {
+        ctx->outdir[0] = '\0';
+        return -1;
+    }
+
+    return 0;
+}
+
+static void
+print_result(const char *benchmark, unsigned int num_groups, unsigned int num_cpus, unsigned int num_events, unsigned int iterations, uint64_t duration_ns)
+{
+    printf("benchmark=%s groups=%u cpus=%u events=%u iterations=%u ns_per_op=%" PRIu64 "\n", benchmark, num_groups, num_cpus, num_events, iterations, duration_ns / iterations);
+}
+
+static int
+bench_populate_payload(struct microbench_context *ctx, unsigned int iterations, uint64_t *duration_ns)
+{
+    struct payload *payload = NULL;
+    uint64_t activity = 0;
+    uint64_t start_ns = get_monotonic_time_ns();
+
+    for (unsigned int i = 0; i < iterations; i++) {
+        payload = payload_create((uint64_t) i, "all");
+        if (!payload || perf_populate_payload(ctx->perf_ctx, payload, ctx->perf_ctx->rates[0].stride, &activity)) {
+            payload_destroy(payload);
+            return -1;
+        }
+        payload_destroy(payload);
+    }
+
+    *duration_ns = get_monotonic_time_ns() - start_ns;
+    return 0;
+}
+
+static int
+bench_csv_store_report(struct microbench_context *ctx, unsigned int iterations, uint64_t *duration_ns)
+{
+    struct storage_module *module = NULL;
+    uint64_t start_ns;
+    int ret = -1;
+
+    ctx->config->storage.type = STORAGE_CSV;
+    snprintf(ctx->config->storage.csv.outdir, PATH_MAX, "%s/csv", ctx->outdir);
+
+    module = storage_module_create(ctx->config, &ctx->config->storage);
+    if (!module || storage_module_initialize(module))
+        goto cleanup;
+
+    start_ns = get_monotonic_time_ns();
+    for (unsigned int i = 0; i < iterations; i++) {
+        ctx->payload->timestamp++;
+        if (storage_module_store_report(module, ctx->payload))
+            goto cleanup;
+    }
+    *duration_ns = get_monotonic_time_ns() - start_ns;
+
+    ret = 0;
+
+cleanup:
+    storage_module_destroy(module);
+    return ret;
+}
+
+static int
+bench_socket_build_document(struct microbench_context *ctx, unsigned int iterations, uint64_t *duration_ns)
+{
+    struct json_object *jobj = NULL;
+    size_t json_report_length = 0;
+    uint64_t start_ns = get_monotonic_time_ns();
+
+    /* the document is serialized as it is by the socket storage module before being sent */
+    for (unsigned int i = 0; i < iterations; i++) {
+        jobj = socket_build_document(ctx->config->sensor.name, ctx->payload);
+        if (!json_object_to_json_string_length(jobj, JSON_C_TO_STRING_PLAIN | JSON_C_TO_STRING_NOSLASHESCAPE, &json_report_length)) {
+            json_object_put(jobj);
+            return -1;
+        }
+        json_object_put(jobj);
+    }
+
+    *duration_ns = get_monotonic_time_ns() - start_ns;
+    return 0;
+}
+
+#ifdef HAVE_MONGODB
+static int
+bench_mongodb_build_document(struct microbench_context *ctx, unsigned int iterations, uint64_t *duration_ns)
+{
+    bson_t document;
+    uint64_t start_ns = get_monotonic_time_ns();
+
+    for (unsigned int i = 0; i < iterations; i++) {
+        bson_init(&document);
+        mongodb_build_document(ctx->config->sensor.name, ctx->payload, &document);
+        bson_destroy(&document);
+    }
+
+    *duration_ns = get_monotonic_time_ns() - start_ns;
+    return 0;
+}
+#endif
+
+/*
+ * microbench_benchmarks stores the name and entrypoint of the benchmarks.
+ */
+static const struct {
+    const char *name;
+    int (*run)(struct microbench_context *ctx, unsigned int iterations, uint64_t *duration_ns);
+} microbench_benchmarks[] = {
+    {"populate_payload", bench_populate_payload},
+    {"csv_store_report", bench_csv_store_report},
+    {"socket_build_document", bench_socket_build_document},
+#ifdef HAVE_MONGODB
+    {"mongodb_build_document", bench_mongodb_build_document},
+#endif
+};
+
+static int
+run_benchmarks(const struct microbench_config *microbench, unsigned int num_groups, unsigned int num_cpus, unsigned int num_events)
+{
+    struct microbench_context ctx = {};
+    uint64_t duration_ns = 0;
+    int ret = -1;
+
+    if (microbench_context_setup(&ctx, microbench, num_groups, num_cpus, num_events)) {
+        zsys_error("microbench: failed to setup the benchmarks for groups=%u cpus=%u events=%u", num_groups, num_cpus, num_events);
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < sizeof(microbench_benchmarks) / sizeof(microbench_benchmarks[0]); i++) {
+        if ((*microbench_benchmarks[i].run)(&ctx, microbench->iterations, &duration_ns)) {
+            zsys_error("microbench: %s failed for groups=%u cpus=%u events=%u", microbench_benchmarks[i].name, num_groups, num_cpus, num_events);
+            goto cleanup;
+        }
+        print_result(microbench_benchmarks[i].name, num_groups, num_cpus, num_events, microbench->iterations, duration_ns);
+    }
+
+    ret = 0;
+
+cleanup:
+    microbench_context_destroy(&ctx);
+    return ret;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct microbench_config microbench = { .groups = { {1}, 1 }, .cpus = { {8}, 1 }, .events = { {4}, 1 }, .num_pkgs = 1, .iterations = 1000 };
+    int ret = EXIT_SUCCESS;
+
+    if (setup_microbench_config(argc, argv, &microbench))
+        return EXIT_FAILURE;
+
+    if (!zsys_init()) {
+        fprintf(stderr, "czmq: failed to initialize zsys context\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t groups_i = 0; groups_i < microbench.groups.num_values; groups_i++) {
+        for (size_t cpus_i = 0; cpus_i < microbench.cpus.num_values; cpus_i++) {
+            for (size_t events_i = 0; events_i < microbench.events.num_values; events_i++) {
+                if (run_benchmarks(&microbench, microbench.groups.values[groups_i], microbench.cpus.values[cpus_i], microbench.events.values[events_i]))
+                    ret = EXIT_FAILURE;
+            }
+        }
+    }
+
+    zsys_shutdown();
+    return ret;
+}
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <czmq.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "config_cli.h"
+#include "payload.h"
+#include "rlimits.h"
+#include "storage.h"
+#include "trace.h"
+
+/*
+ * hwpc-replay feeds the payloads rebuilt from a trace captured by the sensor (--trace-output) to a storage module, as
+ * fast as possible and without any PMU access. The payloads are rebuilt from the raw samples with the delta logic of
+ * the perf actors, then stored in the order they were captured.
+ * The options placed after "--" are parsed as the sensor options, to select and configure the storage module.
+ */
+
+/*
+ * replay_config stores the configuration of the replay.
+ */
+struct replay_config
+{
+    char trace_path[PATH_MAX];
+};
+
+static int
+setup_replay_config(int argc, char **argv, struct replay_config *replay, int *sensor_argi)
+{
+    static struct option long_opts[] = {
+        {"trace", required_argument, 0, 't'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "t:", long_opts, NULL)) != -1) {
+        switch (opt)
+        {
+            case 't':
+            if (snprintf(replay->trace_path, PATH_MAX, "%s", optarg) >= PATH_MAX) {
+                fprintf(stderr, "replay: trace path is too long\n");
+                return -1;
+            }
+            break;
+
+            default:
+            fprintf(stderr, "usage: %s --trace FILE [-- SENSOR-OPTIONS...]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    if (replay->trace_path[0] == '\0') {
+        fprintf(stderr, "usage: %s --trace FILE [-- SENSOR-OPTIONS...]\n", argv[0]);
+        return -1;
+    }
+
+    *sensor_argi = optind;
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    int ret = EXIT_FAILURE;
+    struct replay_config replay = {};
+    struct config *config = NULL;
+    struct storage_module *storage = NULL;
+    struct trace_reader *reader = NULL;
+    struct payload *payload = NULL;
+    uint64_t num_payloads = 0;
+    uint64_t num_failures = 0;
+    int64_t start_us;
+    int64_t duration_us;
+    int sensor_argi = 0;
+
+    if (setup_replay_config(argc, argv, &replay, &sensor_argi))
+        return ret;
+
+    if (!zsys_init()) {
+        fprintf(stderr, "czmq: failed to initialize zsys context\n");
+        return ret;
+    }
+
+    if (rlimits_initialize())
+        goto cleanup;
+
+    /* the remaining arguments configure the sensor */
+    config = config_create();
+    if (!config) {
+        zsys_error("replay: failed to create config container");
+        goto cleanup;
+    }
+    optind = 0;
+    if (config_setup_from_cli(argc - sensor_argi + 1, argv + sensor_argi - 1, config)) {
+        zsys_error("replay: failed to parse the sensor options");
+        goto cleanup;
+    }
+    if (config->storage.type == STORAGE_UNKNOWN)
+        config->storage.type = STORAGE_NULL;
+
+    reader = trace_reader_create(replay.trace_path);
+    if (!reader) {
+        zsys_error("replay: failed to open the trace");
+        goto cleanup;
+    }
+
+    /* setup storage module */
+    storage = storage_module_create(config, &config->storage);
+    if (!storage) {
+        zsys_error("replay: failed to create '%s' storage module", storage_types_name[config->storage.type]);
+        goto cleanup;
+    }
+    if (storage_module_initialize(storage)) {
+        zsys_error("replay: failed to initialize storage module");
+        goto cleanup;
+    }
+    if (storage_module_ping(storage)) {
+        zsys_error("replay: failed to ping storage module");
+        goto cleanup;
+    }
+
+    start_us = zclock_usecs();
+    while (!zsys_interrupted) {
+        if (trace_reader_next_payload(reader, &payload)) {
+            zsys_error("replay: failed to read the trace after %" PRIu64 " payloads", num_payloads);
+            goto cleanup;
+        }
+
+        /* end of the trace */
+        if (!payload)
+            break;
+
+        if (storage_module_store_report(storage, payload))
+            num_failures++;
+
+        num_payloads++;
+        payload_destroy(payload);
+    }
+    duration_us = zclock_usecs() - start_us;
+
+    printf("storage=%s payloads=%" PRIu64 " failures=%" PRIu64 " duration_ms=%" PRId64 " payloads_per_s=%.2f\n",
+           storage_types_name[config->storage.type], num_payloads, num_failures, duration_us / 1000,
+           (duration_us) ? (double) num_payloads * 1000000.0 / (double) duration_us : 0.0);
+
+    ret = (num_failures) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+cleanup:
+    trace_reader_destroy(&reader);
+    storage_module_destroy(storage);
+    config_destroy(config);
+    zsys_shutdown();
+    return ret;
+}
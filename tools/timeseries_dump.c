@@ -0,0 +1,258 @@
+/*
+ *  Copyright (c) 2026, Inria
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timeseries.h"
+
+/*
+ * hwpc-timeseries-dump decodes timeseries files written by the sensor and prints their content as CSV.
+ */
+
+struct file_header
+{
+    char *sensor_name;
+    char *group_name;
+    size_t num_events;
+    char **events_name;
+};
+
+static void
+file_header_release(struct file_header *header)
+{
+    free(header->sensor_name);
+    free(header->group_name);
+    for (size_t i = 0; header->events_name && i < header->num_events; i++)
+        free(header->events_name[i]);
+    free(header->events_name);
+}
+
+static int
+read_magic(FILE *file, const char *magic)
+{
+    char buffer[16] = {};
+    size_t size = strlen(magic);
+
+    if (fread(buffer, size, 1, file) != 1)
+        return -1;
+
+    return (memcmp(buffer, magic, size) == 0) ? 0 : -1;
+}
+
+static int
+read_file_header(FILE *file, struct file_header *header)
+{
+    uint64_t num_events = 0;
+
+    if (read_magic(file, TIMESERIES_FILE_MAGIC))
+        return -1;
+
+    header->sensor_name = ts_file_read_string(file);
+    header->group_name = ts_file_read_string(file);
+    if (!header->sensor_name || !header->group_name)
+        return -1;
+
+    if (ts_file_read_varint(file, &num_events) || num_events == 0 || num_events > UINT16_MAX)
+        return -1;
+
+    header->events_name = (char **) calloc(num_events, sizeof(char *));
+    if (!header->events_name)
+        return -1;
+
+    header->num_events = num_events;
+    for (size_t i = 0; i < header->num_events; i++) {
+        header->events_name[i] = ts_file_read_string(file);
+        if (!header->events_name[i])
+            return -1;
+    }
+
+    return 0;
+}
+
+static int
+decode_column(const uint8_t *data, size_t size, size_t *pos, size_t num_points, uint64_t *values)
+{
+    struct ts_column_decoder decoder = {};
+
+    ts_column_decoder_init(&decoder, data + *pos, size - *pos);
+    for (size_t i = 0; i < num_points; i++) {
+        if (ts_column_decoder_next(&decoder, &values[i]))
+            return -1;
+    }
+
+    *pos += decoder.pos;
+    return 0;
+}
+
+static int
+dump_block(FILE *file, const struct file_header *header)
+{
+    char *target_name = NULL;
+    uint64_t socket = 0;
+    uint64_t cpu = 0;
+    uint64_t num_points = 0;
+    uint64_t data_size = 0;
+    size_t num_columns = header->num_events + TIMESERIES_NUM_METADATA_COLUMNS;
+    size_t num_values = 0;
+    uint8_t *data = NULL;
+    uint64_t *values = NULL;
+    size_t pos = 0;
+    int ret = -1;
+
+    target_name = ts_file_read_string(file);
+    if (!target_name)
+        goto cleanup;
+
+    if (ts_file_read_varint(file, &socket) || ts_file_read_varint(file, &cpu) || ts_file_read_varint(file, &num_points) || ts_file_read_varint(file, &data_size))
+        goto cleanup;
+
+    /* each value is a varint of at least one byte, bounding the number of values by the data size prevents overflows */
+    if (num_points == 0 || data_size == 0 || data_size > SIZE_MAX / sizeof(uint64_t) || num_points > data_size / num_columns)
+        goto cleanup;
+
+    num_values = num_points * num_columns;
+    if (num_values < (data_size + TIMESERIES_VARINT_MAX_SIZE - 1) / TIMESERIES_VARINT_MAX_SIZE)
+        goto cleanup;
+
+    data = (uint8_t *) malloc(data_size);
+    values = (uint64_t *) malloc(num_values * sizeof(uint64_t));
+    if (!data || !values)
+        goto cleanup;
+
+    if (fread(data, data_size, 1, file) != 1)
+        goto cleanup;
+
+    /* the columns are stored one after the other: timestamps and metadata first, then the events in the order of the header */
+    for (size_t column = 0; column < num_columns; column++) {
+        if (decode_column(data, data_size, &pos, num_points, values + (column * num_points)))
+            goto cleanup;
+    }
+
+    for (size_t point = 0; point < num_points; point++) {
+        printf("%" PRIu64 ",%s,%s,%" PRIu64 ",%" PRIu64, values[point], header->sensor_name, target_name, socket, cpu);
+        for (size_t column = 1; column < num_columns; column++)
+            printf(",%" PRIu64, values[(column * num_points) + point]);
+        printf("\n");
+    }
+
+    ret = 0;
+
+cleanup:
+    free(values);
+    free(data);
+    free(target_name);
+    return ret;
+}
+
+static bool
+is_header_equal(const struct file_header *header, const struct file_header *other)
+{
+    if (!other->group_name || strcmp(header->group_name, other->group_name) || header->num_events != other->num_events)
+        return false;
+
+    for (size_t i = 0; i < header->num_events; i++) {
+        if (strcmp(header->events_name[i], other->events_name[i]))
+            return false;
+    }
+
+    return true;
+}
+
+static int
+dump_file(const char *path, struct file_header *previous_header)
+{
+    FILE *file = NULL;
+    struct file_header header = {};
+    int c = 0;
+    int ret = -1;
+
+    errno = 0;
+    file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "%s: failed to open file: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    if (read_file_header(file, &header)) {
+        fprintf(stderr, "%s: invalid timeseries file header\n", path);
+        file_header_release(&header);
+        fclose(file);
+        return -1;
+    }
+
+    /* the csv header is printed again when the group or its events differ from the ones of the previous file */
+    if (!is_header_equal(&header, previous_header)) {
+        printf("timestamp,sensor,target,socket,cpu,interval_ms,partial,overload_factor");
+        for (size_t i = 0; i < header.num_events; i++)
+            printf(",%s", header.events_name[i]);
+        printf("\n");
+    }
+
+    while ((c = fgetc(file)) != EOF) {
+        ungetc(c, file);
+        if (read_magic(file, TIMESERIES_BLOCK_MAGIC) || dump_block(file, &header)) {
+            fprintf(stderr, "%s: invalid or truncated block at offset %ld\n", path, ftell(file));
+            goto cleanup;
+        }
+    }
+
+    ret = 0;
+
+cleanup:
+    file_header_release(previous_header);
+    *previous_header = header;
+    fclose(file);
+    return ret;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct file_header previous_header = {};
+    int ret = EXIT_SUCCESS;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s FILE...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (dump_file(argv[i], &previous_header))
+            ret = EXIT_FAILURE;
+    }
+
+    file_header_release(&previous_header);
+    return ret;
+}